@@ -0,0 +1,1013 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_dct.cc
+ *
+ * @brief       DCT plans of type II, III and IV: twiddles, scaling and the
+ *              FFT plan of a transform size precomputed once, rows
+ *              transformed without allocation.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_dct.h"
+#include "uai_gemm.h"
+#include "uai_matrix.h"
+#include "nd_errno.h"
+
+#define NUMDL_LOG_TAG "uai.dct"
+#include "nd_log.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <nd_assert.h>
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+#include <arm_math.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846264338327950288
+#endif  // M_PI
+
+namespace uai {
+namespace feature {
+
+/**
+ * The DCT-II of x is the real part of the FFT of the reordered
+ * v = (x[0], x[2], ..., x[3], x[1]) turned by e^(-i pi k / 2n), see
+ * https://www.nayuki.io/page/fast-discrete-cosine-transform-algorithms
+ * Bins above n / 2 come from the conjugate of bin n - k. The factor 2 of
+ * the unscaled transform and the ortho scaling are folded into the
+ * twiddles, so one pass over the bins gives the output.
+ *
+ * The DCT-III runs the same steps backwards: the scaled input turned by
+ * e^(i pi k / 2n) gives the bins, the inverse real FFT gives v and v is
+ * put back in sample order.
+ *
+ * The DCT-IV of an even size packs x[2m] + i x[n - 1 - 2m] into n / 2
+ * complex points, turns them by e^(-i pi (4m + 1) / 4n), runs an n / 2
+ * point complex FFT and turns the bins by e^(-i pi m / n). Bin m then holds
+ * y[2m] in its real part and -y[n - 1 - 2m] in its imaginary part.
+ *
+ * A plan truncated to its first k outputs may instead hold the k x n
+ * cosine basis with the same scaling, a row is then one GEMV.
+ */
+struct dct_plan
+{
+    os_size_t n;
+    os_size_t k;
+    dct_type_t type;
+    dct_norm_t norm;
+    dct_method_t method;
+    fft_plan_t* fft; /* From the fft plan cache, types II and III */
+    kiss_fft_cfg cfg; /* n / 2 point complex FFT, type IV */
+    kiss_fft_cpx* twiddles; /* Scaled, see dct_plan_twiddles() */
+    float* scales; /* n input scales, type III */
+    float* basis; /* k x n row-major, DIRECT only */
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+    bool cmsis; /* Type IV runs on arm_dct4_f32 */
+    arm_dct4_instance_f32 dct4;
+    arm_rfft_instance_f32 dct4_rfft;
+    arm_cfft_radix4_instance_f32 dct4_cfft;
+#endif
+};
+
+static os_size_t dct_align_up(os_size_t bytes)
+{
+    return (bytes + 15) & ~(os_size_t)15;
+}
+
+/* Type II: permuted samples, then the bins, then the scratch of the FFT */
+static os_size_t dct_bins_offset(os_size_t n)
+{
+    return dct_align_up(n * sizeof(float));
+}
+
+static os_size_t dct_fft_offset(os_size_t n)
+{
+    os_size_t bins = (n / 2 + 1) * sizeof(kiss_fft_cpx);
+    return dct_bins_offset(n) + dct_align_up(bins);
+}
+
+/* Same layout for NUMDL_DCT_ROWS rows at once */
+static os_size_t dct_rows_bins_offset(os_size_t n)
+{
+    return dct_align_up(NUMDL_DCT_ROWS * n * sizeof(float));
+}
+
+static os_size_t dct_rows_fft_offset(os_size_t n)
+{
+    os_size_t bins = NUMDL_DCT_ROWS * (n / 2 + 1) * sizeof(kiss_fft_cpx);
+    return dct_rows_bins_offset(n) + dct_align_up(bins);
+}
+
+/* Type III: the bins, then v, then the scratch of the inverse FFT */
+static os_size_t dct3_v_offset(os_size_t n)
+{
+    return dct_align_up((n / 2 + 1) * sizeof(kiss_fft_cpx));
+}
+
+static os_size_t dct3_fft_offset(os_size_t n)
+{
+    return dct3_v_offset(n) + dct_align_up(n * sizeof(float));
+}
+
+/* Type IV: the packed points, then their bins */
+static os_size_t dct4_bins_offset(os_size_t n)
+{
+    return dct_align_up(n / 2 * sizeof(kiss_fft_cpx));
+}
+
+/**
+ * Scale of coefficient k times gain, the factor 2 of the unscaled types II
+ * and IV included. For type III k is the input sample the factor applies
+ * to, as in the scipy formula.
+ */
+static double dct_scale(dct_type_t type,
+                        os_size_t n,
+                        os_size_t k,
+                        dct_norm_t norm,
+                        double gain)
+{
+    bool ortho = (DCT_NORMAL_ORTHO == norm);
+
+    switch (type) {
+    case DCT_TYPE_III:
+        if (ortho) {
+            return gain * sqrt((0 == k ? 1.0 : 2.0) / n);
+        }
+        return gain * (0 == k ? 1.0 : 2.0);
+    case DCT_TYPE_IV:
+        return gain * (ortho ? sqrt(2.0 / n) : 2.0);
+    default:
+        if (ortho) {
+            return gain * 2.0 * sqrt(1.0 / ((0 == k ? 4.0 : 2.0) * n));
+        }
+        return gain * 2.0;
+    }
+}
+
+/* Cosine of basis row j (output) and column i (input), reduced exactly */
+static double dct_basis_cos(dct_type_t type,
+                            os_size_t n,
+                            os_size_t j,
+                            os_size_t i)
+{
+    switch (type) {
+    case DCT_TYPE_III:
+        return cos(M_PI * ((i * (2 * j + 1)) % (4 * n)) / (2.0 * n));
+    case DCT_TYPE_IV:
+        return cos(M_PI * (((2 * i + 1) * (2 * j + 1)) % (8 * n)) /
+                   (4.0 * n));
+    default:
+        return cos(M_PI * ((j * (2 * i + 1)) % (4 * n)) / (2.0 * n));
+    }
+}
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+/* arm_dct4_f32 has tables for these sizes only */
+static bool dct4_cmsis_supports(os_size_t n)
+{
+    if (n != 128 && n != 512 && n != 2048 && n != 8192) {
+        return false;
+    }
+
+    fft_backend_t backend = fft::get_backend();
+    if (FFT_BACKEND_KISSFFT == backend) {
+        return false;
+    }
+    return FFT_BACKEND_CMSIS == backend ||
+           (n >= NUMDL_FFT_CMSIS_MIN && n <= NUMDL_FFT_CMSIS_MAX);
+}
+#endif
+
+/* An FFT type IV needs n / 2 >= 2 complex points */
+static bool dct_fft_supports(dct_type_t type, os_size_t n)
+{
+    return type != DCT_TYPE_IV || (0 == n % 2 && n >= 4);
+}
+
+static dct_method_t dct_pick_method(dct_type_t type,
+                                    os_size_t n,
+                                    os_size_t k)
+{
+    double direct = (double)k * n;
+    double fft = NUMDL_DCT_DIRECT_COST * n * log2((double)n);
+
+    if (n < 2 || direct < fft || !dct_fft_supports(type, n)) {
+        return DCT_METHOD_DIRECT;
+    }
+    return DCT_METHOD_FFT;
+}
+
+static os_size_t dct_plan_body(const dct_plan* plan)
+{
+    os_size_t n = plan->n;
+
+    if (DCT_METHOD_DIRECT == plan->method) {
+        return plan->k * n * sizeof(float);
+    }
+
+    switch (plan->type) {
+    case DCT_TYPE_III:
+        return dct_align_up((n / 2 + 1) * sizeof(kiss_fft_cpx)) +
+               n * sizeof(float);
+    case DCT_TYPE_IV: {
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+        if (plan->cmsis) {
+            return 0;
+        }
+#endif
+        size_t cfg = 0;
+        kiss_fft_alloc((int)(n / 2), 0, OS_NULL, &cfg);
+        return dct_align_up(n * sizeof(kiss_fft_cpx)) + cfg;
+    }
+    default:
+        return plan->k * sizeof(kiss_fft_cpx);
+    }
+}
+
+static void dct_plan_basis(dct_plan* plan, double gain)
+{
+    os_size_t n = plan->n;
+
+    for (os_size_t j = 0; j < plan->k; j++) {
+        float* row = plan->basis + j * n;
+        for (os_size_t i = 0; i < n; i++) {
+            /* Type III scales by input, the others by output */
+            os_size_t s = (DCT_TYPE_III == plan->type) ? i : j;
+            double scale = dct_scale(plan->type, n, s, plan->norm, gain);
+            row[i] = (float)(dct_basis_cos(plan->type, n, j, i) * scale);
+        }
+    }
+}
+
+/**
+ * Twiddles of the FFT methods:
+ *   II:  k post twiddles, sign negative for the conjugated bins above n / 2
+ *   III: n / 2 + 1 pre twiddles e^(i pi k / 2n) / 2, n input scales
+ *   IV:  n / 2 pre twiddles, then n / 2 scaled post twiddles
+ */
+static void dct_plan_twiddles(dct_plan* plan, double gain)
+{
+    os_size_t n = plan->n;
+    kiss_fft_cpx* tw = plan->twiddles;
+
+    switch (plan->type) {
+    case DCT_TYPE_III:
+        for (os_size_t j = 0; j <= n / 2; j++) {
+            double phase = M_PI * j / (2.0 * n);
+            tw[j].r = (kiss_fft_scalar)(cos(phase) * 0.5);
+            tw[j].i = (kiss_fft_scalar)(sin(phase) * 0.5);
+        }
+        /* The inverse FFT divides by n, undo the DCT-II scale on top */
+        for (os_size_t j = 0; j < n; j++) {
+            double scale = (DCT_NORMAL_ORTHO == plan->norm)
+                               ? sqrt((0 == j ? 4.0 : 2.0) * n)
+                               : 2.0 * n;
+            plan->scales[j] = (float)(gain * scale);
+        }
+        break;
+    case DCT_TYPE_IV: {
+        os_size_t m = n / 2;
+        double scale = dct_scale(DCT_TYPE_IV, n, 0, plan->norm, gain);
+        for (os_size_t j = 0; j < m; j++) {
+            double pre = -M_PI * (4 * j + 1) / (4.0 * n);
+            double post = -M_PI * j / n;
+            tw[j].r = (kiss_fft_scalar)cos(pre);
+            tw[j].i = (kiss_fft_scalar)sin(pre);
+            tw[m + j].r = (kiss_fft_scalar)(cos(post) * scale);
+            tw[m + j].i = (kiss_fft_scalar)(sin(post) * scale);
+        }
+        break;
+    }
+    default:
+        for (os_size_t j = 0; j < plan->k; j++) {
+            double phase = M_PI * j / (2.0 * n);
+            double scale = dct_scale(DCT_TYPE_II, n, j, plan->norm, gain);
+
+            /* Above n / 2 the bin is the conjugate of bin n - j */
+            double sign = (2 * j > n) ? -1.0 : 1.0;
+            tw[j].r = (kiss_fft_scalar)(cos(phase) * scale);
+            tw[j].i = (kiss_fft_scalar)(sin(phase) * scale * sign);
+        }
+        break;
+    }
+}
+
+static dct_plan* dct_plan_make(dct_type_t type,
+                               os_size_t n,
+                               os_size_t k,
+                               dct_norm_t norm,
+                               dct_method_t method,
+                               double gain)
+{
+    if (type != DCT_TYPE_II && type != DCT_TYPE_III && type != DCT_TYPE_IV) {
+        ERROR("Invalid dct type(%d).", (int)type);
+        return OS_NULL;
+    }
+    if (n < 1 || k < 1 || k > n) {
+        ERROR("Invalid dct size(%d) or outputs(%d).", (int)n, (int)k);
+        return OS_NULL;
+    }
+
+    if (DCT_METHOD_AUTO == method) {
+        method = dct_pick_method(type, n, k);
+    } else if (DCT_METHOD_FFT == method && !dct_fft_supports(type, n)) {
+        ERROR("DCT-IV of size %d has no FFT method, needs an even size.",
+              (int)n);
+        return OS_NULL;
+    }
+
+    dct_plan head_plan;
+    memset(&head_plan, 0, sizeof(head_plan));
+    head_plan.n = n;
+    head_plan.k = k;
+    head_plan.type = type;
+    head_plan.norm = norm;
+    head_plan.method = method;
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+    head_plan.cmsis = (DCT_TYPE_IV == type && DCT_METHOD_FFT == method &&
+                       dct4_cmsis_supports(n));
+#endif
+
+    os_size_t head = dct_align_up(sizeof(dct_plan));
+    char* mem = (char*)uai_mat_aligned_alloc(head + dct_plan_body(&head_plan));
+    if (OS_NULL == mem) {
+        ERROR("Allocate dct plan of size %d error.", (int)n);
+        return OS_NULL;
+    }
+
+    dct_plan* plan = (dct_plan*)mem;
+    *plan = head_plan;
+
+    if (DCT_METHOD_DIRECT == method) {
+        plan->basis = (float*)(mem + head);
+        dct_plan_basis(plan, gain);
+        return plan;
+    }
+
+    plan->twiddles = (kiss_fft_cpx*)(mem + head);
+
+    if (DCT_TYPE_IV == type) {
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+        if (plan->cmsis) {
+            float normalize =
+                (float)dct_scale(DCT_TYPE_IV, n, 0, norm, gain);
+            if (arm_dct4_init_f32(&plan->dct4,
+                                  &plan->dct4_rfft,
+                                  &plan->dct4_cfft,
+                                  (uint16_t)n,
+                                  (uint16_t)(n / 2),
+                                  normalize) != ARM_MATH_SUCCESS) {
+                ERROR("Init arm_dct4_f32 of size %d error.", (int)n);
+                uai_mat_aligned_free(mem);
+                return OS_NULL;
+            }
+            plan->twiddles = OS_NULL;
+            return plan;
+        }
+#endif
+        size_t cfg = 0;
+        kiss_fft_alloc((int)(n / 2), 0, OS_NULL, &cfg);
+        plan->cfg = kiss_fft_alloc((int)(n / 2),
+                                   0,
+                                   mem + head +
+                                       dct_align_up(n * sizeof(kiss_fft_cpx)),
+                                   &cfg);
+        dct_plan_twiddles(plan, gain);
+        return plan;
+    }
+
+    if (DCT_TYPE_III == type) {
+        plan->scales =
+            (float*)(mem + head +
+                     dct_align_up((n / 2 + 1) * sizeof(kiss_fft_cpx)));
+    }
+
+    plan->fft = fft::plan_get(n);
+    if (OS_NULL == plan->fft) {
+        ERROR("Get fft plan error.");
+        uai_mat_aligned_free(mem);
+        return OS_NULL;
+    }
+
+    dct_plan_twiddles(plan, gain);
+
+    return plan;
+}
+
+/**
+ * Create a full DCT-II plan, see the truncated plan_create()
+ *
+ * @param n    [in] Number of samples of a row
+ * @param norm [in] DCT_NORMAL_NONE or DCT_NORMAL_ORTHO, as scipy
+ *
+ * @returns Plan, OS_NULL on failure
+ */
+dct_plan_t* dct::plan_create(os_size_t n, dct_norm_t norm)
+{
+    return plan_create(DCT_TYPE_II, n, n, norm, DCT_METHOD_AUTO);
+}
+
+/**
+ * Create a DCT-II plan computing only the first k coefficients, see the
+ * plan_create() taking a type
+ *
+ * @returns Plan, OS_NULL on failure
+ */
+dct_plan_t* dct::plan_create(os_size_t n,
+                             os_size_t k,
+                             dct_norm_t norm,
+                             dct_method_t method)
+{
+    return plan_create(DCT_TYPE_II, n, k, norm, method);
+}
+
+/**
+ * Create a DCT plan computing only the first k coefficients. The FFT
+ * method of types II and III shares its FFT plan through the fft plan
+ * cache, type IV keeps an n / 2 point complex kissfft, or the CMSIS-DSP
+ * arm_dct4_f32 for the sizes it has tables for when the fft backend
+ * allows CMSIS. The DIRECT method caches a k x n cosine basis.
+ * DCT_METHOD_AUTO takes the one with fewer operations, see
+ * NUMDL_DCT_DIRECT_COST, and the basis for an odd size of type IV.
+ *
+ * @param type   [in] DCT_TYPE_II, DCT_TYPE_III or DCT_TYPE_IV
+ * @param n      [in] Number of samples of a row
+ * @param k      [in] Number of coefficients, 1 ~ n
+ * @param norm   [in] DCT_NORMAL_NONE or DCT_NORMAL_ORTHO, as scipy
+ * @param method [in] DCT_METHOD_AUTO, DCT_METHOD_FFT or DCT_METHOD_DIRECT
+ *
+ * @returns Plan, OS_NULL on failure
+ */
+dct_plan_t* dct::plan_create(dct_type_t type,
+                             os_size_t n,
+                             os_size_t k,
+                             dct_norm_t norm,
+                             dct_method_t method)
+{
+    return dct_plan_make(type, n, k, norm, method, 1.0);
+}
+
+/**
+ * Create the plan of an inverse DCT, as scipy.fft.idct: the inverse of
+ * type II is type III, of type III type II and type IV is its own inverse.
+ * Unnormalised transforms are divided by 2n so that the inverse of a
+ * transform gives the samples back.
+ *
+ * @param type [in] Type of the transform to invert
+ * @param n    [in] Number of samples of a row
+ * @param norm [in] Normalisation of the transform to invert
+ *
+ * @returns Plan, OS_NULL on failure
+ */
+dct_plan_t* dct::plan_create_inverse(dct_type_t type,
+                                     os_size_t n,
+                                     dct_norm_t norm)
+{
+    dct_type_t inverse = type;
+    if (DCT_TYPE_II == type) {
+        inverse = DCT_TYPE_III;
+    } else if (DCT_TYPE_III == type) {
+        inverse = DCT_TYPE_II;
+    }
+
+    double gain = (DCT_NORMAL_ORTHO == norm) ? 1.0 : 1.0 / (2.0 * n);
+
+    return dct_plan_make(inverse, n, n, norm, DCT_METHOD_AUTO, gain);
+}
+
+/**
+ * Destroy a plan made by plan_create()
+ *
+ * @param plan [in] Plan, OS_NULL is ignored
+ */
+void dct::plan_destroy(dct_plan_t* plan)
+{
+    if (plan != OS_NULL) {
+        if (plan->fft != OS_NULL) {
+            fft::plan_put(plan->fft);
+        }
+        uai_mat_aligned_free(plan);
+    }
+}
+
+/**
+ * Get the transform size of a plan
+ *
+ * @param plan [in] Plan
+ *
+ * @returns Number of samples of a row
+ */
+os_size_t dct::plan_size(const dct_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    return plan->n;
+}
+
+/**
+ * Get the number of coefficients a plan writes
+ *
+ * @param plan [in] Plan
+ *
+ * @returns k of plan_create(), n for a full plan
+ */
+os_size_t dct::plan_outputs(const dct_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    return plan->k;
+}
+
+/**
+ * Get the type of a plan, the inverse type for plan_create_inverse()
+ *
+ * @param plan [in] Plan
+ *
+ * @returns DCT_TYPE_II, DCT_TYPE_III or DCT_TYPE_IV
+ */
+dct_type_t dct::plan_type(const dct_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    return plan->type;
+}
+
+/**
+ * Get the method a plan resolved to
+ *
+ * @param plan [in] Plan
+ *
+ * @returns DCT_METHOD_FFT or DCT_METHOD_DIRECT
+ */
+dct_method_t dct::plan_method(const dct_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    return plan->method;
+}
+
+/**
+ * Get the scratch a transform() with the plan needs
+ *
+ * @param plan [in] Plan
+ *
+ * @returns Size of the scratch in bytes
+ */
+os_size_t dct::scratch_size(const dct_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+
+    os_size_t n = plan->n;
+
+    if (DCT_METHOD_DIRECT == plan->method) {
+        return dct_align_up(n * sizeof(float));
+    }
+
+    switch (plan->type) {
+    case DCT_TYPE_III:
+        return dct3_fft_offset(n) + fft::irfft_scratch_size(plan->fft);
+    case DCT_TYPE_IV:
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+        if (plan->cmsis) {
+            /* In place buffer and the state of arm_dct4_f32 */
+            return 2 * dct_align_up(n * sizeof(float));
+        }
+#endif
+        return 2 * dct4_bins_offset(n);
+    default:
+        return dct_fft_offset(n) + fft::rfft_scratch_size(plan->fft);
+    }
+}
+
+/* Even samples ascending, then odd samples descending */
+static void dct_permute(os_size_t n,
+                        const float* src,
+                        os_size_t incs,
+                        float* v)
+{
+    os_size_t half = (n + 1) / 2;
+    for (os_size_t i = 0; i < half; i++) {
+        v[i] = src[2 * i * incs];
+    }
+    for (os_size_t i = half; i < n; i++) {
+        v[i] = src[(2 * (n - i) - 1) * incs];
+    }
+}
+
+/* Turn the bins into the first k coefficients */
+static void dct_post(const dct_plan* plan,
+                     const kiss_fft_cpx* bins,
+                     float* out,
+                     os_size_t inco)
+{
+    os_size_t n = plan->n;
+    const kiss_fft_cpx* tw = plan->twiddles;
+
+    for (os_size_t k = 0; k < plan->k; k++) {
+        const kiss_fft_cpx* b = (2 * k <= n) ? &bins[k] : &bins[n - k];
+        out[k * inco] = b->r * tw[k].r + b->i * tw[k].i;
+    }
+}
+
+static int dct2_fft(const dct_plan* plan,
+                    const float* src,
+                    os_size_t incs,
+                    float* out,
+                    os_size_t inco,
+                    char* mem)
+{
+    os_size_t n = plan->n;
+    float* v = (float*)mem;
+    kiss_fft_cpx* bins = (kiss_fft_cpx*)(mem + dct_bins_offset(n));
+
+    dct_permute(n, src, incs, v);
+
+    int ret = fft::rfft(plan->fft, v, bins, mem + dct_fft_offset(n));
+    if (ret != NUMDL_EOK) {
+        return ret;
+    }
+
+    dct_post(plan, bins, out, inco);
+
+    return NUMDL_EOK;
+}
+
+static int dct3_fft(const dct_plan* plan,
+                    const float* src,
+                    os_size_t incs,
+                    float* out,
+                    os_size_t inco,
+                    char* mem)
+{
+    os_size_t n = plan->n;
+    kiss_fft_cpx* bins = (kiss_fft_cpx*)mem;
+    float* v = (float*)(mem + dct3_v_offset(n));
+    const kiss_fft_cpx* tw = plan->twiddles;
+    const float* s = plan->scales;
+
+    /* Bin j = tw[j] * (a - i b) with a = s x[j], b = s x[n - j] */
+    for (os_size_t j = 0; j <= n / 2; j++) {
+        float a = s[j] * src[j * incs];
+        float b = (0 == j) ? 0.0f : s[n - j] * src[(n - j) * incs];
+        bins[j].r = tw[j].r * a + tw[j].i * b;
+        bins[j].i = tw[j].i * a - tw[j].r * b;
+    }
+
+    int ret = fft::irfft(plan->fft, bins, v, mem + dct3_fft_offset(n));
+    if (ret != NUMDL_EOK) {
+        return ret;
+    }
+
+    /* Undo dct_permute(), only the first k samples */
+    os_size_t half = (n + 1) / 2;
+    for (os_size_t i = 0; i < half && 2 * i < plan->k; i++) {
+        out[2 * i * inco] = v[i];
+    }
+    for (os_size_t i = half; i < n; i++) {
+        os_size_t index = 2 * (n - i) - 1;
+        if (index < plan->k) {
+            out[index * inco] = v[i];
+        }
+    }
+
+    return NUMDL_EOK;
+}
+
+static int dct4_fft(const dct_plan* plan,
+                    const float* src,
+                    os_size_t incs,
+                    float* out,
+                    os_size_t inco,
+                    char* mem)
+{
+    os_size_t n = plan->n;
+    os_size_t m = n / 2;
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+    if (plan->cmsis) {
+        float* buf = (float*)mem;
+        float* state = (float*)(mem + dct_align_up(n * sizeof(float)));
+
+        for (os_size_t i = 0; i < n; i++) {
+            buf[i] = src[i * incs];
+        }
+        arm_dct4_f32(&plan->dct4, state, buf);
+        for (os_size_t i = 0; i < plan->k; i++) {
+            out[i * inco] = buf[i];
+        }
+        return NUMDL_EOK;
+    }
+#endif
+
+    kiss_fft_cpx* t = (kiss_fft_cpx*)mem;
+    kiss_fft_cpx* bins = (kiss_fft_cpx*)(mem + dct4_bins_offset(n));
+    const kiss_fft_cpx* pre = plan->twiddles;
+    const kiss_fft_cpx* post = plan->twiddles + m;
+
+    for (os_size_t j = 0; j < m; j++) {
+        float re = src[2 * j * incs];
+        float im = src[(n - 1 - 2 * j) * incs];
+        t[j].r = re * pre[j].r - im * pre[j].i;
+        t[j].i = re * pre[j].i + im * pre[j].r;
+    }
+
+    kiss_fft(plan->cfg, t, bins);
+
+    for (os_size_t j = 0; j < m; j++) {
+        float re = bins[j].r * post[j].r - bins[j].i * post[j].i;
+        float im = bins[j].r * post[j].i + bins[j].i * post[j].r;
+        if (2 * j < plan->k) {
+            out[2 * j * inco] = re;
+        }
+        if (n - 1 - 2 * j < plan->k) {
+            out[(n - 1 - 2 * j) * inco] = -im;
+        }
+    }
+
+    return NUMDL_EOK;
+}
+
+/**
+ * DCT of one strided row, scaled like scipy.fft.dct(type=2, 3 or 4) with
+ * the plan's norm, or like scipy.fft.idct for plan_create_inverse(). Only
+ * the first plan_outputs() coefficients are written.
+ *
+ * @param plan    [in] Plan
+ * @param src     [in] n samples
+ * @param incs    [in] Distance in floats between two samples
+ * @param out     [out] k coefficients, may be src with the same stride
+ * @param inco    [in] Distance in floats between two coefficients
+ * @param scratch [in] scratch_size() bytes, 16 byte aligned
+ *
+ * @returns 0 if OK
+ */
+int dct::transform(const dct_plan_t* plan,
+                   const float* src,
+                   os_size_t incs,
+                   float* out,
+                   os_size_t inco,
+                   void* scratch)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+    NUMDL_ASSERT(scratch != OS_NULL);
+
+    os_size_t n = plan->n;
+    char* mem = (char*)scratch;
+
+    if (DCT_METHOD_DIRECT == plan->method) {
+        float* v = (float*)mem;
+
+        /* Gathered first, so out may overwrite src */
+        for (os_size_t i = 0; i < n; i++) {
+            v[i] = src[i * incs];
+        }
+        return gemm::sgemv(
+            plan->k, n, plan->basis, n, 1, v, 1, out, inco, OS_NULL);
+    }
+
+    switch (plan->type) {
+    case DCT_TYPE_III:
+        return dct3_fft(plan, src, incs, out, inco, mem);
+    case DCT_TYPE_IV:
+        return dct4_fft(plan, src, incs, out, inco, mem);
+    default:
+        return dct2_fft(plan, src, incs, out, inco, mem);
+    }
+}
+
+/**
+ * Get the scratch a dct2() with the plan needs
+ *
+ * @param plan [in] Plan
+ *
+ * @returns Size of the scratch in bytes
+ */
+os_size_t dct::dct2_scratch_size(const dct_plan_t* plan)
+{
+    return scratch_size(plan);
+}
+
+/**
+ * DCT type II of one row, see dct2() with strides
+ *
+ * @param plan    [in] Plan
+ * @param src     [in] n samples
+ * @param out     [out] k coefficients, may be src
+ * @param scratch [in] dct2_scratch_size() bytes, 16 byte aligned
+ *
+ * @returns 0 if OK
+ */
+int dct::dct2(const dct_plan_t* plan,
+              const float* src,
+              float* out,
+              void* scratch)
+{
+    return dct2(plan, src, 1, out, 1, scratch);
+}
+
+/**
+ * DCT type II of one strided row, scaled like scipy.fft.dct(type=2):
+ *     out[k] = f * 2 * sum(src[i] * cos(pi * k * (2 * i + 1) / (2 * n)))
+ * with f = 1, or for ortho sqrt(1 / (4 * n)) at k = 0 and sqrt(1 / (2 * n))
+ * elsewhere. Only the first plan_outputs() coefficients are written. No
+ * heap call is made.
+ *
+ * @param plan    [in] Plan of type II
+ * @param src     [in] n samples
+ * @param incs    [in] Distance in floats between two samples
+ * @param out     [out] k coefficients, may be src with the same stride
+ * @param inco    [in] Distance in floats between two coefficients
+ * @param scratch [in] dct2_scratch_size() bytes, 16 byte aligned
+ *
+ * @returns 0 if OK
+ */
+int dct::dct2(const dct_plan_t* plan,
+              const float* src,
+              os_size_t incs,
+              float* out,
+              os_size_t inco,
+              void* scratch)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    NUMDL_ASSERT(DCT_TYPE_II == plan->type);
+
+    return transform(plan, src, incs, out, inco, scratch);
+}
+
+/**
+ * Get the scratch a transform_rows() with the plan needs
+ *
+ * @param plan [in] Plan
+ *
+ * @returns Size of the scratch in bytes
+ */
+os_size_t dct::rows_scratch_size(const dct_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+
+    if (plan->method != DCT_METHOD_FFT || plan->type != DCT_TYPE_II) {
+        return scratch_size(plan);
+    }
+    return dct_rows_fft_offset(plan->n) +
+           fft::rfft_batch_scratch_size(plan->fft);
+}
+
+/**
+ * DCT of rows of a matrix, see transform(). A DIRECT plan multiplies all
+ * rows by the basis in one GEMM. A type II FFT plan permutes
+ * NUMDL_DCT_ROWS rows at a time and runs them through fft::rfft_batch(),
+ * which keeps several rows in the SIMD lanes. Columns are rows with the
+ * strides swapped.
+ *
+ * @param plan    [in] Plan
+ * @param rows    [in] Number of rows
+ * @param src     [in] rows x n samples
+ * @param rss     [in] Row stride of src, in floats
+ * @param css     [in] Column stride of src, in floats
+ * @param out     [out] rows x k coefficients, may be src with the same
+ *                      strides, must not overlap it otherwise
+ * @param rso     [in] Row stride of out, in floats
+ * @param cso     [in] Column stride of out, in floats
+ * @param scratch [in] rows_scratch_size() bytes, 16 byte aligned
+ *
+ * @returns 0 if OK
+ */
+int dct::transform_rows(const dct_plan_t* plan,
+                        os_size_t rows,
+                        const float* src,
+                        os_size_t rss,
+                        os_size_t css,
+                        float* out,
+                        os_size_t rso,
+                        os_size_t cso,
+                        void* scratch)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+    NUMDL_ASSERT(scratch != OS_NULL);
+
+    os_size_t n = plan->n;
+
+    /* In place the GEMM would read coefficients already written */
+    if (DCT_METHOD_DIRECT == plan->method && (const float*)out != src) {
+        return gemm::sgemm(rows,
+                           plan->k,
+                           n,
+                           src,
+                           rss,
+                           css,
+                           plan->basis,
+                           1,
+                           n,
+                           out,
+                           rso,
+                           cso);
+    }
+
+    if (plan->method != DCT_METHOD_FFT || plan->type != DCT_TYPE_II) {
+        for (os_size_t r = 0; r < rows; r++) {
+            int ret = transform(
+                plan, src + r * rss, css, out + r * rso, cso, scratch);
+            if (ret != NUMDL_EOK) {
+                return ret;
+            }
+        }
+        return NUMDL_EOK;
+    }
+
+    char* mem = (char*)scratch;
+    float* v = (float*)mem;
+    kiss_fft_cpx* bins = (kiss_fft_cpx*)(mem + dct_rows_bins_offset(n));
+    void* batch = mem + dct_rows_fft_offset(n);
+    os_size_t nbins = n / 2 + 1;
+
+    for (os_size_t r = 0; r < rows; r += NUMDL_DCT_ROWS) {
+        os_size_t count =
+            rows - r < NUMDL_DCT_ROWS ? rows - r : NUMDL_DCT_ROWS;
+
+        /* The whole group is read before any of it is written */
+        for (os_size_t i = 0; i < count; i++) {
+            dct_permute(n, src + (r + i) * rss, css, v + i * n);
+        }
+
+        int ret = fft::rfft_batch(plan->fft, v, n, count, bins, nbins, batch);
+        if (ret != NUMDL_EOK) {
+            return ret;
+        }
+
+        for (os_size_t i = 0; i < count; i++) {
+            dct_post(plan, bins + i * nbins, out + (r + i) * rso, cso);
+        }
+    }
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Get the scratch a dct2_rows() with the plan needs
+ *
+ * @param plan [in] Plan
+ *
+ * @returns Size of the scratch in bytes
+ */
+os_size_t dct::dct2_rows_scratch_size(const dct_plan_t* plan)
+{
+    return rows_scratch_size(plan);
+}
+
+/**
+ * DCT type II of rows of a matrix, see transform_rows()
+ *
+ * @param plan    [in] Plan of type II
+ * @param rows    [in] Number of rows
+ * @param src     [in] rows x n samples
+ * @param rss     [in] Row stride of src, in floats
+ * @param css     [in] Column stride of src, in floats
+ * @param out     [out] rows x k coefficients, may be src with the same
+ *                      strides, must not overlap it otherwise
+ * @param rso     [in] Row stride of out, in floats
+ * @param cso     [in] Column stride of out, in floats
+ * @param scratch [in] dct2_rows_scratch_size() bytes, 16 byte aligned
+ *
+ * @returns 0 if OK
+ */
+int dct::dct2_rows(const dct_plan_t* plan,
+                   os_size_t rows,
+                   const float* src,
+                   os_size_t rss,
+                   os_size_t css,
+                   float* out,
+                   os_size_t rso,
+                   os_size_t cso,
+                   void* scratch)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    NUMDL_ASSERT(DCT_TYPE_II == plan->type);
+
+    return transform_rows(
+        plan, rows, src, rss, css, out, rso, cso, scratch);
+}
+
+};  // namespace feature
+};  // namespace uai
@@ -0,0 +1,156 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_dct.h
+ *
+ * @brief       DCT plans of type II, III and IV: twiddles, scaling and the
+ *              FFT plan of a transform size precomputed once, rows
+ *              transformed without allocation.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#ifndef __UAI_DCT_H__
+#define __UAI_DCT_H__
+
+#include "uai_fft.h"
+
+#include <os_stddef.h>
+
+/**
+ * The auto method takes the cosine basis while k * n multiply-adds cost
+ * less than NUMDL_DCT_DIRECT_COST * n * log2(n), the FFT path otherwise.
+ * Run the dct bench to tune it.
+ */
+#ifndef NUMDL_DCT_DIRECT_COST
+#define NUMDL_DCT_DIRECT_COST (2)
+#endif
+
+/**
+ * Rows a type II transform_rows() permutes and transforms together, so a
+ * SIMD build of the FFT fills its lanes. 1 goes row by row with the least
+ * scratch.
+ */
+#ifndef NUMDL_DCT_ROWS
+#define NUMDL_DCT_ROWS (UAI_FFT_ROWS)
+#endif
+
+namespace uai {
+namespace feature {
+
+typedef enum dct_norm
+{
+    DCT_NORMAL_NONE = 0,
+    DCT_NORMAL_ORTHO
+} dct_norm_t;
+
+/** DCT type, numbered as the type argument of scipy.fft.dct */
+typedef enum dct_type
+{
+    DCT_TYPE_II = 2,
+    DCT_TYPE_III = 3,
+    DCT_TYPE_IV = 4
+} dct_type_t;
+
+/**
+ * How a plan computes its outputs: an FFT of the reordered row, or k dot
+ * products with a cached k x n cosine basis
+ */
+typedef enum dct_method
+{
+    DCT_METHOD_AUTO = 0,
+    DCT_METHOD_FFT,
+    DCT_METHOD_DIRECT
+} dct_method_t;
+
+/**
+ * Precomputed state of an n point DCT with its type and normalisation. A
+ * plan is never written by a transform, so one plan may serve many
+ * threads.
+ */
+typedef struct dct_plan dct_plan_t;
+
+class dct
+{
+public:
+    static dct_plan_t* plan_create(os_size_t n, dct_norm_t norm);
+    static dct_plan_t* plan_create(os_size_t n,
+                                   os_size_t k,
+                                   dct_norm_t norm,
+                                   dct_method_t method);
+    static dct_plan_t* plan_create(dct_type_t type,
+                                   os_size_t n,
+                                   os_size_t k,
+                                   dct_norm_t norm,
+                                   dct_method_t method);
+    static dct_plan_t* plan_create_inverse(dct_type_t type,
+                                           os_size_t n,
+                                           dct_norm_t norm);
+    static void plan_destroy(dct_plan_t* plan);
+    static os_size_t plan_size(const dct_plan_t* plan);
+    static os_size_t plan_outputs(const dct_plan_t* plan);
+    static dct_type_t plan_type(const dct_plan_t* plan);
+    static dct_method_t plan_method(const dct_plan_t* plan);
+
+    static os_size_t scratch_size(const dct_plan_t* plan);
+    static int transform(const dct_plan_t* plan,
+                         const float* src,
+                         os_size_t incs,
+                         float* out,
+                         os_size_t inco,
+                         void* scratch);
+    static os_size_t rows_scratch_size(const dct_plan_t* plan);
+    static int transform_rows(const dct_plan_t* plan,
+                              os_size_t rows,
+                              const float* src,
+                              os_size_t rss,
+                              os_size_t css,
+                              float* out,
+                              os_size_t rso,
+                              os_size_t cso,
+                              void* scratch);
+
+    static os_size_t dct2_scratch_size(const dct_plan_t* plan);
+    static int dct2(const dct_plan_t* plan,
+                    const float* src,
+                    float* out,
+                    void* scratch);
+    static int dct2(const dct_plan_t* plan,
+                    const float* src,
+                    os_size_t incs,
+                    float* out,
+                    os_size_t inco,
+                    void* scratch);
+    static os_size_t dct2_rows_scratch_size(const dct_plan_t* plan);
+    static int dct2_rows(const dct_plan_t* plan,
+                         os_size_t rows,
+                         const float* src,
+                         os_size_t rss,
+                         os_size_t css,
+                         float* out,
+                         os_size_t rso,
+                         os_size_t cso,
+                         void* scratch);
+};
+
+};  // namespace feature
+};  // namespace uai
+
+#endif /* __UAI_DCT_H__ */
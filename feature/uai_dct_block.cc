@@ -0,0 +1,780 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ * @file        uai_dct_block.cc
+ *
+ * @brief       Two-dimensional DCT of small square blocks and of whole images
+ *              cut into such blocks.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_dct_block.h"
+#include "uai_thread_pool.h"
+#include "nd_errno.h"
+
+#define NUMDL_LOG_TAG "uai.dct"
+#include "nd_log.h"
+
+#include <math.h>
+
+#include <nd_assert.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846264338327950288
+#endif  // M_PI
+
+namespace uai {
+namespace feature {
+
+/**
+ * A 1D butterfly network runs down the columns of a block into a small
+ * buffer, the buffer is transposed, the network runs again on what were
+ * the rows and the result is stored transposed, back in place.
+ * Every butterfly works on a whole vector of columns, so one pass over an
+ * 8x8 block is 8 lanes (AVX) or two times 4 lanes (SSE) wide.
+ *
+ * The 8 point networks are the AAN ones of the IJG jfdctflt / jidctflt:
+ * 5 multiplies for the forward and 5 for the inverse, the outputs come
+ * out scaled per coefficient. The 4 point networks are exact rotations.
+ * The 16 point forward splits x into a = x[i] + x[15 - i], whose 8 point
+ * DCT gives the even coefficients, and b = x[i] - x[15 - i], which an 8x8
+ * cosine matrix turns into the odd ones. The inverse runs the same split
+ * backwards.
+ *
+ * The per coefficient scale of the networks and of the norm are folded
+ * into one factor per row and one per column, applied while the block is
+ * stored (forward) or loaded (inverse).
+ */
+
+/* Lane types the networks are written against */
+struct block_lane1
+{
+    typedef float vec;
+    enum { LANES = 1 };
+
+    static inline vec load(const float* p) { return *p; }
+    static inline void store(float* p, vec a) { *p = a; }
+    static inline vec add(vec a, vec b) { return a + b; }
+    static inline vec sub(vec a, vec b) { return a - b; }
+    static inline vec mul(vec a, float s) { return a * s; }
+    static inline vec mulv(vec a, vec b) { return a * b; }
+};
+
+#if defined(__SSE__)
+struct block_lane4
+{
+    typedef __m128 vec;
+    enum { LANES = 4 };
+
+    static inline vec load(const float* p) { return _mm_loadu_ps(p); }
+    static inline void store(float* p, vec a) { _mm_storeu_ps(p, a); }
+    static inline vec add(vec a, vec b) { return _mm_add_ps(a, b); }
+    static inline vec sub(vec a, vec b) { return _mm_sub_ps(a, b); }
+    static inline vec mul(vec a, float s)
+    {
+        return _mm_mul_ps(a, _mm_set1_ps(s));
+    }
+    static inline vec mulv(vec a, vec b) { return _mm_mul_ps(a, b); }
+};
+#endif
+
+#if defined(__AVX__)
+struct block_lane8
+{
+    typedef __m256 vec;
+    enum { LANES = 8 };
+
+    static inline vec load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void store(float* p, vec a) { _mm256_storeu_ps(p, a); }
+    static inline vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+    static inline vec sub(vec a, vec b) { return _mm256_sub_ps(a, b); }
+    static inline vec mul(vec a, float s)
+    {
+        return _mm256_mul_ps(a, _mm256_set1_ps(s));
+    }
+    static inline vec mulv(vec a, vec b) { return _mm256_mul_ps(a, b); }
+};
+#endif
+
+/* Sizes 4, 8 and 16 */
+#define UAI_DCT_BLOCK_SIZES (3)
+
+/**
+ * Constant tables, built once. fwd[s][norm] scales the outputs of the
+ * forward networks, inv[s][norm] the inputs of the inverse ones, both per
+ * row and per column. odd16[k][i] is cos(pi (2i + 1)(2k + 1) / 32).
+ */
+struct block_consts
+{
+    float fwd[UAI_DCT_BLOCK_SIZES][2][UAI_DCT_BLOCK_MAX];
+    float inv[UAI_DCT_BLOCK_SIZES][2][UAI_DCT_BLOCK_MAX];
+    float odd16[8][8];
+
+    block_consts();
+};
+
+block_consts::block_consts()
+{
+    /* Output k of the 8 point forward network times s8[k] is the DCT */
+    double s8[8];
+    s8[0] = 1.0;
+    for (os_size_t k = 1; k < 8; k++) {
+        s8[k] = 1.0 / (2.0 * cos(M_PI * k / 16.0));
+    }
+
+    for (os_size_t s = 0; s < UAI_DCT_BLOCK_SIZES; s++) {
+        os_size_t n = (os_size_t)4 << s;
+
+        for (os_size_t k = 0; k < n; k++) {
+            /*
+             * Coefficient k of an 8 point network, k / 2 for the even half
+             * of 16 points, comes out divided by s8. The inverse network
+             * sums its inputs times s8, twice that past the first one, as
+             * jidctflt does. The other networks are exact.
+             */
+            bool aan = (8 == n) || (16 == n && 0 == (k & 1));
+            os_size_t k8 = (16 == n) ? k / 2 : k;
+            double net = aan ? s8[k8] : 1.0;
+            double weight = aan ? s8[k8] * (0 == k8 ? 1.0 : 2.0) : 1.0;
+            double dc = (0 == k) ? 1.0 : 2.0;
+
+            for (int norm = 0; norm < 2; norm++) {
+                double out_scale;
+                double in_scale;
+
+                if (DCT_NORMAL_ORTHO == norm) {
+                    out_scale = 2.0 * sqrt(1.0 / ((0 == k ? 4.0 : 2.0) * n));
+                    in_scale = sqrt(dc / n);
+                } else {
+                    out_scale = 2.0;
+                    in_scale = dc / (2.0 * n);
+                }
+
+                fwd[s][norm][k] = (float)(out_scale * net);
+                inv[s][norm][k] = (float)(in_scale / weight);
+            }
+        }
+    }
+
+    for (os_size_t k = 0; k < 8; k++) {
+        for (os_size_t i = 0; i < 8; i++) {
+            os_size_t p = ((2 * i + 1) * (2 * k + 1)) % 64;
+            odd16[k][i] = (float)cos(M_PI * p / 32.0);
+        }
+    }
+}
+
+static const block_consts& block_consts_get(void)
+{
+    static const block_consts consts;
+    return consts;
+}
+
+static os_size_t block_index(os_size_t size)
+{
+    return (4 == size) ? 0 : (8 == size) ? 1 : 2;
+}
+
+template <class O>
+static inline void block_fwd4(typename O::vec* x)
+{
+    typedef typename O::vec V;
+
+    V a0 = O::add(x[0], x[3]);
+    V a1 = O::add(x[1], x[2]);
+    V b0 = O::sub(x[0], x[3]);
+    V b1 = O::sub(x[1], x[2]);
+
+    x[0] = O::add(a0, a1);
+    x[2] = O::mul(O::sub(a0, a1), 0.707106781f);
+    x[1] = O::add(O::mul(b0, 0.923879533f), O::mul(b1, 0.382683433f));
+    x[3] = O::sub(O::mul(b0, 0.382683433f), O::mul(b1, 0.923879533f));
+}
+
+template <class O>
+static inline void block_inv4(typename O::vec* x)
+{
+    typedef typename O::vec V;
+
+    V z2 = O::mul(x[2], 0.707106781f);
+    V e0 = O::add(x[0], z2);
+    V e1 = O::sub(x[0], z2);
+    V o0 = O::add(O::mul(x[1], 0.923879533f), O::mul(x[3], 0.382683433f));
+    V o1 = O::sub(O::mul(x[1], 0.382683433f), O::mul(x[3], 0.923879533f));
+
+    x[0] = O::add(e0, o0);
+    x[3] = O::sub(e0, o0);
+    x[1] = O::add(e1, o1);
+    x[2] = O::sub(e1, o1);
+}
+
+template <class O>
+static inline void block_fwd8(typename O::vec* x)
+{
+    typedef typename O::vec V;
+
+    V tmp0 = O::add(x[0], x[7]);
+    V tmp7 = O::sub(x[0], x[7]);
+    V tmp1 = O::add(x[1], x[6]);
+    V tmp6 = O::sub(x[1], x[6]);
+    V tmp2 = O::add(x[2], x[5]);
+    V tmp5 = O::sub(x[2], x[5]);
+    V tmp3 = O::add(x[3], x[4]);
+    V tmp4 = O::sub(x[3], x[4]);
+
+    /* Even part */
+    V tmp10 = O::add(tmp0, tmp3);
+    V tmp13 = O::sub(tmp0, tmp3);
+    V tmp11 = O::add(tmp1, tmp2);
+    V tmp12 = O::sub(tmp1, tmp2);
+
+    x[0] = O::add(tmp10, tmp11);
+    x[4] = O::sub(tmp10, tmp11);
+
+    V z1 = O::mul(O::add(tmp12, tmp13), 0.707106781f);
+    x[2] = O::add(tmp13, z1);
+    x[6] = O::sub(tmp13, z1);
+
+    /* Odd part */
+    tmp10 = O::add(tmp4, tmp5);
+    tmp11 = O::add(tmp5, tmp6);
+    tmp12 = O::add(tmp6, tmp7);
+
+    V z5 = O::mul(O::sub(tmp10, tmp12), 0.382683433f);
+    V z2 = O::add(O::mul(tmp10, 0.541196100f), z5);
+    V z4 = O::add(O::mul(tmp12, 1.306562965f), z5);
+    V z3 = O::mul(tmp11, 0.707106781f);
+
+    V z11 = O::add(tmp7, z3);
+    V z13 = O::sub(tmp7, z3);
+
+    x[5] = O::add(z13, z2);
+    x[3] = O::sub(z13, z2);
+    x[1] = O::add(z11, z4);
+    x[7] = O::sub(z11, z4);
+}
+
+template <class O>
+static inline void block_inv8(typename O::vec* x)
+{
+    typedef typename O::vec V;
+
+    /* Even part */
+    V tmp10 = O::add(x[0], x[4]);
+    V tmp11 = O::sub(x[0], x[4]);
+    V tmp13 = O::add(x[2], x[6]);
+    V tmp12 = O::sub(O::mul(O::sub(x[2], x[6]), 1.414213562f), tmp13);
+
+    V tmp0 = O::add(tmp10, tmp13);
+    V tmp3 = O::sub(tmp10, tmp13);
+    V tmp1 = O::add(tmp11, tmp12);
+    V tmp2 = O::sub(tmp11, tmp12);
+
+    /* Odd part */
+    V z13 = O::add(x[5], x[3]);
+    V z10 = O::sub(x[5], x[3]);
+    V z11 = O::add(x[1], x[7]);
+    V z12 = O::sub(x[1], x[7]);
+
+    V tmp7 = O::add(z11, z13);
+    tmp11 = O::mul(O::sub(z11, z13), 1.414213562f);
+
+    V z5 = O::mul(O::add(z10, z12), 1.847759065f);
+    tmp10 = O::sub(O::mul(z12, 1.082392200f), z5);
+    tmp12 = O::sub(z5, O::mul(z10, 2.613125930f));
+
+    V tmp6 = O::sub(tmp12, tmp7);
+    V tmp5 = O::sub(tmp11, tmp6);
+    V tmp4 = O::add(tmp10, tmp5);
+
+    x[0] = O::add(tmp0, tmp7);
+    x[7] = O::sub(tmp0, tmp7);
+    x[1] = O::add(tmp1, tmp6);
+    x[6] = O::sub(tmp1, tmp6);
+    x[2] = O::add(tmp2, tmp5);
+    x[5] = O::sub(tmp2, tmp5);
+    x[4] = O::add(tmp3, tmp4);
+    x[3] = O::sub(tmp3, tmp4);
+}
+
+template <class O>
+static inline void block_fwd16(typename O::vec* x, const float (*odd)[8])
+{
+    typedef typename O::vec V;
+
+    V a[8];
+    V b[8];
+    for (os_size_t i = 0; i < 8; i++) {
+        a[i] = O::add(x[i], x[15 - i]);
+        b[i] = O::sub(x[i], x[15 - i]);
+    }
+
+    block_fwd8<O>(a);
+
+    for (os_size_t k = 0; k < 8; k++) {
+        V acc = O::mul(b[0], odd[k][0]);
+        for (os_size_t i = 1; i < 8; i++) {
+            acc = O::add(acc, O::mul(b[i], odd[k][i]));
+        }
+        x[2 * k] = a[k];
+        x[2 * k + 1] = acc;
+    }
+}
+
+template <class O>
+static inline void block_inv16(typename O::vec* x, const float (*odd)[8])
+{
+    typedef typename O::vec V;
+
+    V e[8];
+    V o[8];
+    for (os_size_t j = 0; j < 8; j++) {
+        e[j] = x[2 * j];
+    }
+
+    block_inv8<O>(e);
+
+    /* odd16 is symmetric, row n is the weight of every odd input */
+    for (os_size_t n = 0; n < 8; n++) {
+        V acc = O::mul(x[1], odd[n][0]);
+        for (os_size_t j = 1; j < 8; j++) {
+            acc = O::add(acc, O::mul(x[2 * j + 1], odd[n][j]));
+        }
+        o[n] = acc;
+    }
+
+    for (os_size_t n = 0; n < 8; n++) {
+        x[n] = O::add(e[n], o[n]);
+        x[15 - n] = O::sub(e[n], o[n]);
+    }
+}
+
+/*
+ * Run the network down every column of a size x size block from in to out.
+ * With scale the inputs are multiplied by scale[row] * scale[col] first.
+ */
+template <class O, os_size_t N>
+static void block_pass(const float* in,
+                       os_size_t ldi,
+                       float* out,
+                       os_size_t ldo,
+                       bool fwd,
+                       const float* scale,
+                       const block_consts& c)
+{
+    typename O::vec v[N];
+
+    for (os_size_t col = 0; col < N; col += O::LANES) {
+        for (os_size_t r = 0; r < N; r++) {
+            v[r] = O::load(in + r * ldi + col);
+        }
+        if (scale != OS_NULL) {
+            typename O::vec sc = O::load(scale + col);
+            for (os_size_t r = 0; r < N; r++) {
+                v[r] = O::mulv(v[r], O::mul(sc, scale[r]));
+            }
+        }
+
+        if (4 == N) {
+            fwd ? block_fwd4<O>(v) : block_inv4<O>(v);
+        } else if (8 == N) {
+            fwd ? block_fwd8<O>(v) : block_inv8<O>(v);
+        } else {
+            fwd ? block_fwd16<O>(v, c.odd16) : block_inv16<O>(v, c.odd16);
+        }
+
+        for (os_size_t r = 0; r < N; r++) {
+            O::store(out + r * ldo + col, v[r]);
+        }
+    }
+}
+
+template <os_size_t N>
+static inline void block_columns(const float* in,
+                                 os_size_t ldi,
+                                 float* out,
+                                 os_size_t ldo,
+                                 bool fwd,
+                                 const float* scale,
+                                 const block_consts& c)
+{
+#if defined(__AVX__)
+    if (N >= 8) {
+        block_pass<block_lane8, N>(in, ldi, out, ldo, fwd, scale, c);
+        return;
+    }
+#endif
+#if defined(__SSE__)
+    block_pass<block_lane4, N>(in, ldi, out, ldo, fwd, scale, c);
+#else
+    block_pass<block_lane1, N>(in, ldi, out, ldo, fwd, scale, c);
+#endif
+}
+
+/* In place transpose of a size x size block, size is a multiple of 4 */
+static void block_transpose(float* blk, os_size_t size)
+{
+#if defined(__SSE__)
+    for (os_size_t i = 0; i < size; i += 4) {
+        for (os_size_t j = i; j < size; j += 4) {
+            float* p = blk + i * size + j;
+            float* q = blk + j * size + i;
+
+            __m128 p0 = _mm_loadu_ps(p);
+            __m128 p1 = _mm_loadu_ps(p + size);
+            __m128 p2 = _mm_loadu_ps(p + 2 * size);
+            __m128 p3 = _mm_loadu_ps(p + 3 * size);
+            _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+            if (i == j) {
+                _mm_storeu_ps(p, p0);
+                _mm_storeu_ps(p + size, p1);
+                _mm_storeu_ps(p + 2 * size, p2);
+                _mm_storeu_ps(p + 3 * size, p3);
+                continue;
+            }
+
+            __m128 q0 = _mm_loadu_ps(q);
+            __m128 q1 = _mm_loadu_ps(q + size);
+            __m128 q2 = _mm_loadu_ps(q + 2 * size);
+            __m128 q3 = _mm_loadu_ps(q + 3 * size);
+            _MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+
+            _mm_storeu_ps(p, q0);
+            _mm_storeu_ps(p + size, q1);
+            _mm_storeu_ps(p + 2 * size, q2);
+            _mm_storeu_ps(p + 3 * size, q3);
+            _mm_storeu_ps(q, p0);
+            _mm_storeu_ps(q + size, p1);
+            _mm_storeu_ps(q + 2 * size, p2);
+            _mm_storeu_ps(q + 3 * size, p3);
+        }
+    }
+#else
+    for (os_size_t i = 0; i < size; i++) {
+        for (os_size_t j = i + 1; j < size; j++) {
+            float t = blk[i * size + j];
+            blk[i * size + j] = blk[j * size + i];
+            blk[j * size + i] = t;
+        }
+    }
+#endif
+}
+
+/*
+ * Write the transpose of a size x size block to out, times
+ * scale[row] * scale[col] when scale is given.
+ */
+static void block_store_transposed(const float* blk,
+                                   os_size_t size,
+                                   float* out,
+                                   os_size_t ldo,
+                                   const float* scale)
+{
+#if defined(__SSE__)
+    for (os_size_t i = 0; i < size; i += 4) {
+        for (os_size_t j = 0; j < size; j += 4) {
+            const float* p = blk + j * size + i;
+            float* q = out + i * ldo + j;
+
+            __m128 r0 = _mm_loadu_ps(p);
+            __m128 r1 = _mm_loadu_ps(p + size);
+            __m128 r2 = _mm_loadu_ps(p + 2 * size);
+            __m128 r3 = _mm_loadu_ps(p + 3 * size);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            if (scale != OS_NULL) {
+                __m128 sc = _mm_loadu_ps(scale + j);
+                r0 = _mm_mul_ps(r0, _mm_mul_ps(sc, _mm_set1_ps(scale[i])));
+                r1 = _mm_mul_ps(r1, _mm_mul_ps(sc, _mm_set1_ps(scale[i + 1])));
+                r2 = _mm_mul_ps(r2, _mm_mul_ps(sc, _mm_set1_ps(scale[i + 2])));
+                r3 = _mm_mul_ps(r3, _mm_mul_ps(sc, _mm_set1_ps(scale[i + 3])));
+            }
+
+            _mm_storeu_ps(q, r0);
+            _mm_storeu_ps(q + ldo, r1);
+            _mm_storeu_ps(q + 2 * ldo, r2);
+            _mm_storeu_ps(q + 3 * ldo, r3);
+        }
+    }
+#else
+    for (os_size_t r = 0; r < size; r++) {
+        for (os_size_t j = 0; j < size; j++) {
+            float v = blk[j * size + r];
+            out[r * ldo + j] = (scale != OS_NULL) ? v * scale[r] * scale[j] : v;
+        }
+    }
+#endif
+}
+
+/*
+ * One N x N block, src and out may be the same memory: the first pass reads
+ * all of src before anything is written to out.
+ */
+template <os_size_t N>
+static void block_run_n(const float* src,
+                        os_size_t lds,
+                        float* out,
+                        os_size_t ldo,
+                        bool fwd,
+                        const float* scale,
+                        const block_consts& c)
+{
+    float blk[N * N];
+
+    block_columns<N>(src, lds, blk, N, fwd, fwd ? OS_NULL : scale, c);
+    block_transpose(blk, N);
+    block_columns<N>(blk, N, blk, N, fwd, OS_NULL, c);
+    block_store_transposed(blk, N, out, ldo, fwd ? scale : OS_NULL);
+}
+
+/* Run count blocks side by side along a row of blocks */
+static void block_run(os_size_t size,
+                      os_size_t count,
+                      const float* src,
+                      os_size_t lds,
+                      float* out,
+                      os_size_t ldo,
+                      bool fwd,
+                      dct_norm_t norm,
+                      const block_consts& c)
+{
+    int nm = (DCT_NORMAL_ORTHO == norm) ? 1 : 0;
+    const float* scale =
+        fwd ? c.fwd[block_index(size)][nm] : c.inv[block_index(size)][nm];
+
+    for (os_size_t b = 0; b < count; b++) {
+        os_size_t col = b * size;
+
+        if (4 == size) {
+            block_run_n<4>(src + col, lds, out + col, ldo, fwd, scale, c);
+        } else if (8 == size) {
+            block_run_n<8>(src + col, lds, out + col, ldo, fwd, scale, c);
+        } else {
+            block_run_n<16>(src + col, lds, out + col, ldo, fwd, scale, c);
+        }
+    }
+}
+
+struct dct_block_task
+{
+    const float* src;
+    float* out;
+    os_size_t cols;
+    os_size_t size;
+    os_size_t block_rows;
+    os_size_t block_rows_per_task;
+    bool fwd;
+    dct_norm_t norm;
+    const block_consts* consts;
+};
+
+static void dct_block_task_run(void* arg, os_size_t index)
+{
+    dct_block_task* t = (dct_block_task*)arg;
+
+    os_size_t b0 = index * t->block_rows_per_task;
+    os_size_t b1 = b0 + t->block_rows_per_task;
+    b1 = b1 < t->block_rows ? b1 : t->block_rows;
+
+    for (os_size_t b = b0; b < b1; b++) {
+        os_size_t row = b * t->size * t->cols;
+
+        block_run(t->size,
+                  t->cols / t->size,
+                  t->src + row,
+                  t->cols,
+                  t->out + row,
+                  t->cols,
+                  t->fwd,
+                  t->norm,
+                  *t->consts);
+    }
+}
+
+static int dct_block_image(const uai_mat_t* src,
+                           uai_mat_t* out,
+                           os_size_t size,
+                           dct_norm_t norm,
+                           bool fwd)
+{
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    if (!dct_block::supports(size)) {
+        ERROR("Unsupported dct block size(%d).", (int)size);
+        return NUMDL_EINVAL;
+    }
+
+    if (src->rows != out->rows || src->cols != out->cols ||
+        src->rows % size != 0 || src->cols % size != 0) {
+        ERROR("DCT blocks of %d do not tile %dx%d into %dx%d.",
+              (int)size,
+              (int)src->rows,
+              (int)src->cols,
+              (int)out->rows,
+              (int)out->cols);
+        return NUMDL_EINVAL;
+    }
+
+    dct_block_task task;
+    task.src = src->data;
+    task.out = out->data;
+    task.cols = src->cols;
+    task.size = size;
+    task.block_rows = src->rows / size;
+    task.fwd = fwd;
+    task.norm = norm;
+    task.consts = &block_consts_get();
+
+    os_size_t threads = thread_pool::get_num_threads();
+    os_size_t tasks = 1;
+    if (threads > 1 && (double)src->rows * src->cols >=
+                           NUMDL_DCT_BLOCK_PARALLEL_MIN) {
+        tasks = threads < task.block_rows ? threads : task.block_rows;
+    }
+    task.block_rows_per_task = (task.block_rows + tasks - 1) / tasks;
+
+    return thread_pool::run(dct_block_task_run, &task, tasks);
+}
+
+/**
+ * Whether size x size blocks are supported
+ *
+ * @param size [in] Block edge
+ *
+ * @returns true for 4, 8 and 16
+ */
+bool dct_block::supports(os_size_t size)
+{
+    return 4 == size || 8 == size || 16 == size;
+}
+
+/**
+ * 2D DCT-II of one size x size block, as scipy.fft.dctn(x, 2, norm=...).
+ * out may be src with the same leading dimension.
+ *
+ * @param size [in] Block edge, 4, 8 or 16
+ * @param src  [in] First element of the block
+ * @param lds  [in] Distance between two rows of src
+ * @param out  [out] First coefficient of the output block
+ * @param ldo  [in] Distance between two rows of out
+ * @param norm [in] DCT_NORMAL_ORTHO or DCT_NORMAL_NONE
+ *
+ * @returns 0 if OK
+ */
+int dct_block::forward(os_size_t size,
+                       const float* src,
+                       os_size_t lds,
+                       float* out,
+                       os_size_t ldo,
+                       dct_norm_t norm)
+{
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    if (!supports(size)) {
+        ERROR("Unsupported dct block size(%d).", (int)size);
+        return NUMDL_EINVAL;
+    }
+
+    block_run(size, 1, src, lds, out, ldo, true, norm, block_consts_get());
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Inverse of forward(), as scipy.fft.idctn(x, 2, norm=...)
+ *
+ * @param size [in] Block edge, 4, 8 or 16
+ * @param src  [in] First coefficient of the block
+ * @param lds  [in] Distance between two rows of src
+ * @param out  [out] First element of the output block
+ * @param ldo  [in] Distance between two rows of out
+ * @param norm [in] The norm the coefficients were computed with
+ *
+ * @returns 0 if OK
+ */
+int dct_block::inverse(os_size_t size,
+                       const float* src,
+                       os_size_t lds,
+                       float* out,
+                       os_size_t ldo,
+                       dct_norm_t norm)
+{
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    if (!supports(size)) {
+        ERROR("Unsupported dct block size(%d).", (int)size);
+        return NUMDL_EINVAL;
+    }
+
+    block_run(size, 1, src, lds, out, ldo, false, norm, block_consts_get());
+
+    return NUMDL_EOK;
+}
+
+/**
+ * 2D DCT-II of every size x size block of an image, each block's
+ * coefficients written where the block was, as JPEG lays them out. Rows of
+ * blocks are split across the thread pool. out may be src.
+ *
+ * @param src  [in] Image, rows and cols multiples of size
+ * @param out  [out] Coefficients, same shape as src
+ * @param size [in] Block edge, 4, 8 or 16
+ * @param norm [in] DCT_NORMAL_ORTHO or DCT_NORMAL_NONE
+ *
+ * @returns 0 if OK
+ */
+int dct_block::forward_image(const uai_mat_t* src,
+                             uai_mat_t* out,
+                             os_size_t size,
+                             dct_norm_t norm)
+{
+    return dct_block_image(src, out, size, norm, true);
+}
+
+/**
+ * Inverse of forward_image()
+ *
+ * @param src  [in] Block coefficients, rows and cols multiples of size
+ * @param out  [out] Image, same shape as src
+ * @param size [in] Block edge, 4, 8 or 16
+ * @param norm [in] The norm the coefficients were computed with
+ *
+ * @returns 0 if OK
+ */
+int dct_block::inverse_image(const uai_mat_t* src,
+                             uai_mat_t* out,
+                             os_size_t size,
+                             dct_norm_t norm)
+{
+    return dct_block_image(src, out, size, norm, false);
+}
+
+};  // namespace feature
+};  // namespace uai
@@ -0,0 +1,84 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ * @file        uai_dct_block.h
+ *
+ * @brief       Two-dimensional DCT of small square blocks and of whole images
+ *              cut into such blocks.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#ifndef __UAI_DCT_BLOCK_H__
+#define __UAI_DCT_BLOCK_H__
+
+#include "uai_dct.h"
+#include "uai_matrix.h"
+
+#include <os_stddef.h>
+
+/** Images with fewer elements than this are transformed on one thread */
+#ifndef NUMDL_DCT_BLOCK_PARALLEL_MIN
+#define NUMDL_DCT_BLOCK_PARALLEL_MIN (128 * 128)
+#endif
+
+/** Largest block edge dct_block supports */
+#define UAI_DCT_BLOCK_MAX (16)
+
+namespace uai {
+namespace feature {
+
+/**
+ * 2D DCT-II and its inverse on 4x4, 8x8 and 16x16 blocks, as
+ * scipy.fft.dctn / idctn with type 2 and the same norm. The separable
+ * passes run one butterfly network on several columns at once, AVX lanes
+ * when the build has them, SSE or scalar otherwise.
+ */
+class dct_block
+{
+public:
+    static bool supports(os_size_t size);
+
+    static int forward(os_size_t size,
+                       const float* src,
+                       os_size_t lds,
+                       float* out,
+                       os_size_t ldo,
+                       dct_norm_t norm);
+    static int inverse(os_size_t size,
+                       const float* src,
+                       os_size_t lds,
+                       float* out,
+                       os_size_t ldo,
+                       dct_norm_t norm);
+
+    static int forward_image(const uai_mat_t* src,
+                             uai_mat_t* out,
+                             os_size_t size,
+                             dct_norm_t norm);
+    static int inverse_image(const uai_mat_t* src,
+                             uai_mat_t* out,
+                             os_size_t size,
+                             dct_norm_t norm);
+};
+
+};  // namespace feature
+};  // namespace uai
+
+#endif /* __UAI_DCT_BLOCK_H__ */
@@ -33,21 +33,44 @@
  */
 
 #include "uai_dsp.h"
+#include "uai_gemm.h"
+#include "uai_sparse.h"
+#include "uai_thread_pool.h"
 #include "nd_errno.h"
 
 #define NUMDL_LOG_TAG "uai.dsp"
 #include "nd_log.h"
 
-#include <kiss_fftr.h>
+#include <kiss_fft.h>
 
+#include <float.h>
 #include <math.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 #include <nd_assert.h>
 
 namespace uai {
 namespace feature {
 
+/**
+ * Set the number of threads used by dot and the other parallel functions.
+ * Results do not depend on the number of threads.
+ *
+ * @param num [in] Number of threads, 1 runs everything on the caller thread
+ *
+ * @returns 0 if OK
+ */
+int dsp::set_num_threads(os_size_t num)
+{
+    return thread_pool::set_num_threads(num);
+}
+
 /**
  * Calculate the sum of the array
  *
@@ -79,6 +102,81 @@ float dsp::sum(float* input, os_size_t size)
  * @returns 0 if OK
  */
 int dsp::dot(uai_mat_t* mat1, uai_mat_t* mat2, uai_mat_t* output)
+{
+    return dsp::dot(mat1, mat2, output, OS_NULL);
+}
+
+/**
+ * Multiply two matrices (MxN * NxK matrix) and apply an epilogue to the
+ * product in the same pass, e.g. bias + activation, or the log of a mel
+ * projection.
+ *
+ * @param mat1     [in]  Pointer to matrix1 (MxN)
+ * @param mat2     [in]  Pointer to matrix2 (NxK)
+ * @param output   [out] Pointer to out matrix (MxK)
+ * @param epilogue [in]  Epilogue (bias has K values), OS_NULL for none
+ *
+ * @returns 0 if OK
+ */
+int dsp::dot(uai_mat_t* mat1,
+             uai_mat_t* mat2,
+             uai_mat_t* output,
+             const gemm_epilogue_t* epilogue)
+{
+    NUMDL_ASSERT(mat1 != OS_NULL);
+    NUMDL_ASSERT(mat2 != OS_NULL);
+    NUMDL_ASSERT(output != OS_NULL);
+    NUMDL_ASSERT(mat1->cols == mat2->rows);
+    NUMDL_ASSERT(mat1->rows == output->rows);
+    NUMDL_ASSERT(mat2->cols == output->cols);
+
+    return gemm::sgemm(mat1->rows,
+                       mat2->cols,
+                       mat1->cols,
+                       mat1->data,
+                       mat1->cols,
+                       1,
+                       mat2->data,
+                       mat2->cols,
+                       1,
+                       output->data,
+                       output->cols,
+                       1,
+                       epilogue);
+}
+
+/**
+ * Multiply two matrix views (MxN * NxK matrix). Any of them may be a block,
+ * a transposed or an otherwise strided view, nothing is copied.
+ *
+ * @param mat1   [in]  Pointer to view1 (MxN)
+ * @param mat2   [in]  Pointer to view2 (NxK)
+ * @param output [out] Pointer to out view (MxK), must not overlap the inputs
+ *
+ * @returns 0 if OK
+ */
+int dsp::dot(const uai_mat_view_t* mat1,
+             const uai_mat_view_t* mat2,
+             uai_mat_view_t* output)
+{
+    return dsp::dot(mat1, mat2, output, OS_NULL);
+}
+
+/**
+ * Multiply two matrix views (MxN * NxK matrix) and apply an epilogue to the
+ * product in the same pass.
+ *
+ * @param mat1     [in]  Pointer to view1 (MxN)
+ * @param mat2     [in]  Pointer to view2 (NxK)
+ * @param output   [out] Pointer to out view (MxK), must not overlap the inputs
+ * @param epilogue [in]  Epilogue (bias has K values), OS_NULL for none
+ *
+ * @returns 0 if OK
+ */
+int dsp::dot(const uai_mat_view_t* mat1,
+             const uai_mat_view_t* mat2,
+             uai_mat_view_t* output,
+             const gemm_epilogue_t* epilogue)
 {
     NUMDL_ASSERT(mat1 != OS_NULL);
     NUMDL_ASSERT(mat2 != OS_NULL);
@@ -87,14 +185,262 @@ int dsp::dot(uai_mat_t* mat1, uai_mat_t* mat2, uai_mat_t* output)
     NUMDL_ASSERT(mat1->rows == output->rows);
     NUMDL_ASSERT(mat2->cols == output->cols);
 
-    memset(output->data, 0, output->rows * output->cols * sizeof(float));
+    return gemm::sgemm(mat1->rows,
+                       mat2->cols,
+                       mat1->cols,
+                       uai_mat_view_ptr(mat1, 0, 0),
+                       uai_mat_view_rs(mat1),
+                       uai_mat_view_cs(mat1),
+                       uai_mat_view_ptr(mat2, 0, 0),
+                       uai_mat_view_rs(mat2),
+                       uai_mat_view_cs(mat2),
+                       uai_mat_view_ptr(output, 0, 0),
+                       uai_mat_view_rs(output),
+                       uai_mat_view_cs(output),
+                       epilogue);
+}
+
+/**
+ * Multiply op(mat1) by op(mat2), op(X) is X or its transpose. A transposed
+ * operand is read through its strides, nothing is materialised.
+ *
+ * @param mat1   [in]  Pointer to matrix1, op(mat1) is MxN
+ * @param trans1 [in]  Use the transpose of matrix1
+ * @param mat2   [in]  Pointer to matrix2, op(mat2) is NxK
+ * @param trans2 [in]  Use the transpose of matrix2
+ * @param output [out] Pointer to out matrix (MxK)
+ *
+ * @returns 0 if OK
+ */
+int dsp::dot(const uai_mat_t* mat1,
+             gemm_trans_t trans1,
+             const uai_mat_t* mat2,
+             gemm_trans_t trans2,
+             uai_mat_t* output)
+{
+    return dsp::dot(mat1, trans1, mat2, trans2, output, OS_NULL);
+}
+
+/**
+ * Multiply op(mat1) by op(mat2) and apply an epilogue to the product in the
+ * same pass, e.g. frames (TxF) times filters stored one per row (KxF) is
+ * dot(frames, GEMM_TRANS_NONE, filters, GEMM_TRANS, out).
+ *
+ * @param mat1     [in]  Pointer to matrix1, op(mat1) is MxN
+ * @param trans1   [in]  Use the transpose of matrix1
+ * @param mat2     [in]  Pointer to matrix2, op(mat2) is NxK
+ * @param trans2   [in]  Use the transpose of matrix2
+ * @param output   [out] Pointer to out matrix (MxK)
+ * @param epilogue [in]  Epilogue (bias has K values), OS_NULL for none
+ *
+ * @returns 0 if OK
+ */
+int dsp::dot(const uai_mat_t* mat1,
+             gemm_trans_t trans1,
+             const uai_mat_t* mat2,
+             gemm_trans_t trans2,
+             uai_mat_t* output,
+             const gemm_epilogue_t* epilogue)
+{
+    NUMDL_ASSERT(mat1 != OS_NULL);
+    NUMDL_ASSERT(mat2 != OS_NULL);
+    NUMDL_ASSERT(output != OS_NULL);
 
-    for (os_size_t i = 0; i < mat1->rows; i++) {
-        dsp::dot_by_row(
-            i, mat1->data + (i * mat1->cols), mat1->cols, mat2, output);
+    os_size_t m = GEMM_TRANS == trans1 ? mat1->cols : mat1->rows;
+    os_size_t n = GEMM_TRANS == trans1 ? mat1->rows : mat1->cols;
+    os_size_t k = GEMM_TRANS == trans2 ? mat2->rows : mat2->cols;
+    NUMDL_ASSERT(n == (GEMM_TRANS == trans2 ? mat2->cols : mat2->rows));
+    NUMDL_ASSERT(m == output->rows);
+    NUMDL_ASSERT(k == output->cols);
+
+    return gemm::sgemm(m,
+                       k,
+                       n,
+                       mat1->data,
+                       GEMM_TRANS == trans1 ? 1 : mat1->cols,
+                       GEMM_TRANS == trans1 ? mat1->cols : 1,
+                       mat2->data,
+                       GEMM_TRANS == trans2 ? 1 : mat2->cols,
+                       GEMM_TRANS == trans2 ? mat2->cols : 1,
+                       output->data,
+                       output->cols,
+                       1,
+                       epilogue);
+}
+
+/**
+ * Matrix-vector product output = op(weight) * input, op(W) is W or its
+ * transpose. A frame times row-major weights (1xN * NxK) is GEMM_TRANS,
+ * weights stored transposed (KxN, one row per output) are GEMM_TRANS_NONE.
+ *
+ * @param weight   [in]  Pointer to weight matrix
+ * @param trans    [in]  Use the transpose of weight
+ * @param input    [in]  Input vector, columns of op(weight) values
+ * @param output   [out] Output vector, rows of op(weight) values
+ * @param epilogue [in]  Epilogue (bias per output), OS_NULL for none
+ *
+ * @returns 0 if OK
+ */
+int dsp::gemv(const uai_mat_t* weight,
+              gemm_trans_t trans,
+              const float* input,
+              float* output,
+              const gemm_epilogue_t* epilogue)
+{
+    NUMDL_ASSERT(weight != OS_NULL);
+    NUMDL_ASSERT(input != OS_NULL);
+    NUMDL_ASSERT(output != OS_NULL);
+
+    if (GEMM_TRANS == trans) {
+        return gemm::sgemv(weight->cols,
+                           weight->rows,
+                           weight->data,
+                           1,
+                           weight->cols,
+                           input,
+                           1,
+                           output,
+                           1,
+                           epilogue);
     }
 
-    return NUMDL_EOK;
+    return gemm::sgemv(weight->rows,
+                       weight->cols,
+                       weight->data,
+                       weight->cols,
+                       1,
+                       input,
+                       1,
+                       output,
+                       1,
+                       epilogue);
+}
+
+/**
+ * Batched matrix-vector product, row b of output = op(weight) * row b of
+ * input. Frames that arrive together share the passes over the weights.
+ *
+ * @param weight   [in]  Pointer to weight matrix
+ * @param trans    [in]  Use the transpose of weight
+ * @param input    [in]  One frame per row (B x columns of op(weight))
+ * @param output   [out] One output per row (B x rows of op(weight))
+ * @param epilogue [in]  Epilogue (bias per output), OS_NULL for none
+ *
+ * @returns 0 if OK
+ */
+int dsp::gemv_batch(const uai_mat_t* weight,
+                    gemm_trans_t trans,
+                    const uai_mat_t* input,
+                    uai_mat_t* output,
+                    const gemm_epilogue_t* epilogue)
+{
+    NUMDL_ASSERT(weight != OS_NULL);
+    NUMDL_ASSERT(input != OS_NULL);
+    NUMDL_ASSERT(output != OS_NULL);
+    NUMDL_ASSERT(input->rows == output->rows);
+
+    os_size_t m = GEMM_TRANS == trans ? weight->cols : weight->rows;
+    os_size_t n = GEMM_TRANS == trans ? weight->rows : weight->cols;
+    NUMDL_ASSERT(input->cols == n);
+    NUMDL_ASSERT(output->cols == m);
+
+    return gemm::sgemv_batch(input->rows,
+                             m,
+                             n,
+                             weight->data,
+                             GEMM_TRANS == trans ? 1 : weight->cols,
+                             GEMM_TRANS == trans ? weight->cols : 1,
+                             input->data,
+                             input->cols,
+                             output->data,
+                             output->cols,
+                             epilogue);
+}
+
+/**
+ * Multiply a CSR matrix by a dense one (MxN * NxK matrix), the zeros of
+ * mat1 are skipped
+ *
+ * @param mat1   [in]  Pointer to CSR matrix (MxN)
+ * @param mat2   [in]  Pointer to matrix2 (NxK)
+ * @param output [out] Pointer to out matrix (MxK)
+ *
+ * @returns 0 if OK
+ */
+int dsp::dot(const uai_mat_csr_t* mat1,
+             const uai_mat_t* mat2,
+             uai_mat_t* output)
+{
+    NUMDL_ASSERT(mat1 != OS_NULL);
+    NUMDL_ASSERT(mat2 != OS_NULL);
+    NUMDL_ASSERT(output != OS_NULL);
+    NUMDL_ASSERT(mat1->cols == mat2->rows);
+    NUMDL_ASSERT(mat1->rows == output->rows);
+    NUMDL_ASSERT(mat2->cols == output->cols);
+
+    return sparse::csr_mm(mat1,
+                          mat2->cols,
+                          mat2->data,
+                          mat2->cols,
+                          output->data,
+                          output->cols);
+}
+
+/**
+ * Multiply a block sparse matrix by a dense one (MxN * NxK matrix), the zero
+ * blocks of mat1 are skipped
+ *
+ * @param mat1   [in]  Pointer to BSR matrix (MxN)
+ * @param mat2   [in]  Pointer to matrix2 (NxK)
+ * @param output [out] Pointer to out matrix (MxK)
+ *
+ * @returns 0 if OK
+ */
+int dsp::dot(const uai_mat_bsr_t* mat1,
+             const uai_mat_t* mat2,
+             uai_mat_t* output)
+{
+    NUMDL_ASSERT(mat1 != OS_NULL);
+    NUMDL_ASSERT(mat2 != OS_NULL);
+    NUMDL_ASSERT(output != OS_NULL);
+    NUMDL_ASSERT(mat1->cols == mat2->rows);
+    NUMDL_ASSERT(mat1->rows == output->rows);
+    NUMDL_ASSERT(mat2->cols == output->cols);
+
+    return sparse::bsr_mm(mat1,
+                          mat2->cols,
+                          mat2->data,
+                          mat2->cols,
+                          output->data,
+                          output->cols);
+}
+
+/**
+ * Sparse matrix-vector product, output = weight * input
+ *
+ * @param weight [in]  Pointer to CSR weight matrix (MxN)
+ * @param input  [in]  Input vector (N)
+ * @param output [out] Output vector (M)
+ *
+ * @returns 0 if OK
+ */
+int dsp::gemv(const uai_mat_csr_t* weight, const float* input, float* output)
+{
+    return sparse::csr_mv(weight, input, output);
+}
+
+/**
+ * Block sparse matrix-vector product, output = weight * input
+ *
+ * @param weight [in]  Pointer to BSR weight matrix (MxN)
+ * @param input  [in]  Input vector (N)
+ * @param output [out] Output vector (M)
+ *
+ * @returns 0 if OK
+ */
+int dsp::gemv(const uai_mat_bsr_t* weight, const float* input, float* output)
+{
+    return sparse::bsr_mv(weight, input, output);
 }
 
 /**
@@ -237,6 +583,54 @@ int dsp::log10(uai_mat_t* matrix)
     return NUMDL_EOK;
 }
 
+/**
+ * Calculate the natural log value of a view. Does an in-place replacement.
+ *
+ * @param view [in,out] View (MxN), rows must not overlap
+ *
+ * @returns 0 if OK
+ */
+int dsp::log(uai_mat_view_t* view)
+{
+    NUMDL_ASSERT(view != OS_NULL);
+    NUMDL_ASSERT(view->data != OS_NULL);
+
+    os_size_t cs = uai_mat_view_cs(view);
+
+    for (os_size_t i = 0; i < view->rows; i++) {
+        float* row = uai_mat_view_ptr(view, i, 0);
+        for (os_size_t j = 0; j < view->cols; j++) {
+            row[j * cs] = dsp::log(row[j * cs]);
+        }
+    }
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Calculate the log10 of a view. Does an in-place replacement.
+ *
+ * @param view [in,out] View (MxN), rows must not overlap
+ *
+ * @returns 0 if OK
+ */
+int dsp::log10(uai_mat_view_t* view)
+{
+    NUMDL_ASSERT(view != OS_NULL);
+    NUMDL_ASSERT(view->data != OS_NULL);
+
+    os_size_t cs = uai_mat_view_cs(view);
+
+    for (os_size_t i = 0; i < view->rows; i++) {
+        float* row = uai_mat_view_ptr(view, i, 0);
+        for (os_size_t j = 0; j < view->cols; j++) {
+            row[j * cs] = dsp::log10(row[j * cs]);
+        }
+    }
+
+    return NUMDL_EOK;
+}
+
 /**
  * Return evenly spaced numbers over a specified interval.
  * Returns num evenly spaced samples, calculated over the interval [start,
@@ -357,53 +751,240 @@ int dsp::linspace(os_int32_t start,
     return NUMDL_EOK;
 }
 
-static int kiss_rfft_cpx(const float* src,
-                         kiss_fft_cpx* cpx_out,
-                         os_size_t fft_len)
+static os_size_t rfft_out_len(os_size_t feat_len, rfft_out_t mode)
 {
-    NUMDL_ASSERT(src != NULL);
-    NUMDL_ASSERT(cpx_out != OS_NULL);
+    return RFFT_OUT_COMPLEX == mode ? 2 * feat_len : feat_len;
+}
 
-    kiss_fftr_cfg cfg = kiss_fftr_alloc(fft_len, 0, OS_NULL, OS_NULL);
-    if (OS_NULL == cfg) {
-        ERROR("Allocate fft cfg error.");
-        return NUMDL_ENOMEM;
+/* |X|^2 of 4 bins, bins interleaved as (re, im) pairs */
+#if defined(__SSE__)
+static __m128 rfft_power4(const kiss_fft_cpx* cpx)
+{
+    __m128 a = _mm_loadu_ps((const float*)cpx);
+    __m128 b = _mm_loadu_ps((const float*)(cpx + 2));
+    __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    return _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+}
+#endif
+
+#if defined(__SSE2__)
+/* Natural log of 4 positive normal floats, the Cephes logf polynomial */
+static __m128 rfft_log4(__m128 x)
+{
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128i bits = _mm_castps_si128(x);
+    __m128 e = _mm_cvtepi32_ps(
+        _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0x7e)));
+
+    /* Mantissa in [0.5, 1), moved to [sqrt(0.5), sqrt(2)) - 1 */
+    x = _mm_castsi128_ps(
+        _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x807fffff)),
+                     _mm_set1_epi32(0x3f000000)));
+    __m128 mask = _mm_cmplt_ps(x, _mm_set1_ps(0.707106781186547524f));
+    __m128 tmp = _mm_and_ps(x, mask);
+    x = _mm_sub_ps(x, one);
+    e = _mm_sub_ps(e, _mm_and_ps(one, mask));
+    x = _mm_add_ps(x, tmp);
+
+    __m128 z = _mm_mul_ps(x, x);
+    __m128 y = _mm_set1_ps(7.0376836292e-2f);
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.1514610310e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1676998740e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.2420140846e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.4249322787e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.6668057665e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.0000714765e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-2.4999993993e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(3.3333331174e-1f));
+    y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+
+    y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+    y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    x = _mm_add_ps(x, y);
+    return _mm_add_ps(x, _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+}
+#endif
+
+/* One pass from the complex bins to the requested output, in float */
+static void rfft_output(const kiss_fft_cpx* cpx,
+                        float* out,
+                        os_size_t len,
+                        rfft_out_t mode,
+                        float log_floor)
+{
+    os_size_t i = 0;
+
+    if (RFFT_OUT_COMPLEX == mode) {
+        if ((const float*)cpx != out) {
+            memcpy(out, cpx, len * sizeof(kiss_fft_cpx));
+        }
+        return;
     }
 
-    kiss_fftr(cfg, src, cpx_out);
+#if defined(__SSE2__)
+    /* The polynomial log needs normal inputs, a tiny floor uses logf */
+    if (RFFT_OUT_LOG_POWER == mode && log_floor >= FLT_MIN) {
+        __m128 floor4 = _mm_set1_ps(log_floor);
+        for (; i + 4 <= len; i += 4) {
+            __m128 p = _mm_max_ps(rfft_power4(cpx + i), floor4);
+            _mm_storeu_ps(out + i, rfft_log4(p));
+        }
+    }
+#endif
+
+#if defined(__SSE__)
+    if (RFFT_OUT_LOG_POWER != mode) {
+        for (; i + 4 <= len; i += 4) {
+            __m128 p = rfft_power4(cpx + i);
+            if (RFFT_OUT_MAGNITUDE == mode) {
+                p = _mm_sqrt_ps(p);
+            }
+            _mm_storeu_ps(out + i, p);
+        }
+    }
+#endif
+
+    for (; i < len; i++) {
+        float p = cpx[i].r * cpx[i].r + cpx[i].i * cpx[i].i;
+        if (RFFT_OUT_MAGNITUDE == mode) {
+            p = sqrtf(p);
+        } else if (RFFT_OUT_LOG_POWER == mode) {
+            p = logf(p < log_floor ? log_floor : p);
+        }
+        out[i] = p;
+    }
+}
 
-    free(cfg);
+/* Padded input, bins and the fft scratch, each 16 byte aligned */
+static os_size_t rfft_bins_offset(os_size_t nfft)
+{
+    return (nfft * sizeof(float) + 15) & ~(os_size_t)15;
+}
 
-    return NUMDL_EOK;
+static os_size_t rfft_fft_offset(os_size_t nfft)
+{
+    os_size_t bins = (nfft / 2 + 1) * sizeof(kiss_fft_cpx);
+    return rfft_bins_offset(nfft) + ((bins + 15) & ~(os_size_t)15);
 }
 
-static int kiss_rfft(const float* src,
-                     float* out,
-                     os_size_t fft_len,
-                     os_size_t feat_len)
+/**
+ * Get the scratch dsp::rfft() needs for a plan
+ *
+ * @param plan [in] FFT plan
+ *
+ * @returns Size of the scratch in bytes
+ */
+os_size_t dsp::rfft_scratch_size(const fft_plan_t* plan)
 {
+    NUMDL_ASSERT(plan != OS_NULL);
+
+    return rfft_fft_offset(fft::plan_nfft(plan)) +
+           fft::rfft_scratch_size(plan);
+}
+
+/**
+ * Compute the magnitude of the one-dimensional discrete Fourier Transform
+ * for real input with a prebuilt plan and a caller owned scratch. No heap
+ * call is made when n_fft has no prime factor above 5, other sizes (14,
+ * 22, ...) still allocate inside kissfft's generic butterfly. Results
+ * equal the rfft() taking fft_len.
+ *
+ * @param plan    [in]  FFT plan of n_fft points
+ * @param src     [in]  Source buffer
+ * @param src_len [in]  Size of the source buffer, cropped or zero padded to
+ *                      n_fft
+ * @param out     [out] Output buffer
+ * @param out_len [in]  Size of the output buffer, should be n_fft / 2 + 1
+ * @param scratch [in]  rfft_scratch_size() bytes, 16 byte aligned
+ *
+ * @returns 0 if OK
+ */
+int dsp::rfft(const fft_plan_t* plan,
+              const float* src,
+              os_size_t src_len,
+              float* out,
+              os_size_t out_len,
+              void* scratch)
+{
+    return rfft(plan,
+                src,
+                src_len,
+                out,
+                out_len,
+                scratch,
+                RFFT_OUT_MAGNITUDE,
+                0.0f);
+}
+
+/**
+ * Compute the one-dimensional discrete Fourier Transform for real input
+ * with a prebuilt plan and a caller owned scratch. No heap call is made
+ * when n_fft has no prime factor above 5, see the magnitude overload.
+ * The output is formed in the same pass that reads the bins.
+ *
+ * @param plan      [in]  FFT plan of n_fft points
+ * @param src       [in]  Source buffer
+ * @param src_len   [in]  Size of the source buffer, cropped or zero padded
+ *                        to n_fft
+ * @param out       [out] Output buffer
+ * @param out_len   [in]  Size of the output buffer, n_fft / 2 + 1, twice
+ *                        that for RFFT_OUT_COMPLEX
+ * @param scratch   [in]  rfft_scratch_size() bytes, 16 byte aligned
+ * @param mode      [in]  What to output per bin
+ * @param log_floor [in]  Power clamp before the log of RFFT_OUT_LOG_POWER
+ *
+ * @returns 0 if OK
+ */
+int dsp::rfft(const fft_plan_t* plan,
+              const float* src,
+              os_size_t src_len,
+              float* out,
+              os_size_t out_len,
+              void* scratch,
+              rfft_out_t mode,
+              float log_floor)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
     NUMDL_ASSERT(src != OS_NULL);
     NUMDL_ASSERT(out != OS_NULL);
+    NUMDL_ASSERT(scratch != OS_NULL);
 
-    kiss_fft_cpx* cpx_out =
-        (kiss_fft_cpx*)malloc(feat_len * sizeof(kiss_fft_cpx));
-    if (OS_NULL == cpx_out) {
-        ERROR("Allocate output cpx buffer error.");
-        return NUMDL_ENOMEM;
+    os_size_t fft_len = fft::plan_nfft(plan);
+    os_size_t feat_len = fft_len / 2 + 1;
+    if (rfft_out_len(feat_len, mode) != out_len) {
+        ERROR("The output buffer length(%d) mismatch, should be %d",
+              out_len,
+              rfft_out_len(feat_len, mode));
+        return NUMDL_EINVAL;
+    }
+
+    char* mem = (char*)scratch;
+    kiss_fft_cpx* cpx_out = (kiss_fft_cpx*)(mem + rfft_bins_offset(fft_len));
+    void* fft_scratch = mem + rfft_fft_offset(fft_len);
+
+    /* Complex bins go straight to the output */
+    if (RFFT_OUT_COMPLEX == mode) {
+        cpx_out = (kiss_fft_cpx*)out;
+    }
+
+    /* If fft_len is smaller than the length of the source, the input is
+     * cropped. If it is larger, the source is padded with zeros. */
+    if (src_len < fft_len) {
+        float* padded = (float*)mem;
+        memcpy(padded, src, src_len * sizeof(float));
+        memset(padded + src_len, 0, (fft_len - src_len) * sizeof(float));
+        src = padded;
     }
 
-    int ret = kiss_rfft_cpx(src, cpx_out, fft_len);
+    int ret = fft::rfft(plan, src, cpx_out, fft_scratch);
     if (NUMDL_EOK != ret) {
         ERROR("Kiss rfft error.");
-        free(cpx_out);
         return ret;
     }
 
-    for (os_size_t i = 0; i < feat_len; i++) {
-        out[i] = sqrt(pow(cpx_out[i].r, 2) + pow(cpx_out[i].i, 2));
-    }
+    rfft_output(cpx_out, out, feat_len, mode, log_floor);
 
-    free(cpx_out);
     return NUMDL_EOK;
 }
 
@@ -426,118 +1007,381 @@ int dsp::rfft(const float* src,
               float* out,
               os_size_t out_len,
               os_size_t fft_len)
+{
+    return rfft(
+        src, src_len, out, out_len, fft_len, RFFT_OUT_MAGNITUDE, 0.0f);
+}
+
+/**
+ * Compute the one-dimensional discrete Fourier Transform for real input,
+ * output selected by mode.
+ *
+ * @param src       [in]  Source buffer
+ * @param src_len   [in]  Size of the source buffer
+ * @param out       [out] Output buffer
+ * @param out_len   [in]  Size of the output buffer, n_fft / 2 + 1, twice
+ *                        that for RFFT_OUT_COMPLEX
+ * @param fft_len   [in]  Length of the FFT
+ * @param mode      [in]  What to output per bin
+ * @param log_floor [in]  Power clamp before the log of RFFT_OUT_LOG_POWER
+ *
+ * @returns 0 if OK
+ */
+int dsp::rfft(const float* src,
+              os_size_t src_len,
+              float* out,
+              os_size_t out_len,
+              os_size_t fft_len,
+              rfft_out_t mode,
+              float log_floor)
 {
     NUMDL_ASSERT(src != OS_NULL);
     NUMDL_ASSERT(out != OS_NULL);
 
     os_size_t feat_len = fft_len / 2 + 1;
-    if (feat_len != out_len) {
+    if (rfft_out_len(feat_len, mode) != out_len) {
         ERROR("The output buffer length(%d) mismatch, should be %d",
               out_len,
-              feat_len);
+              rfft_out_len(feat_len, mode));
         return NUMDL_EINVAL;
     }
 
-    /* If fft_len is smaller than the length of the source, the input is
-     * cropped. If it is larger, the source is padded with zeros. */
-    if (src_len > fft_len) {
-        src_len = fft_len;
+    fft_plan_t* plan = fft::plan_get(fft_len);
+    if (OS_NULL == plan) {
+        ERROR("Get fft plan error.");
+        return NUMDL_ENOMEM;
     }
 
-    uai_mat_t* src_mat = uai_mat_create(1, fft_len);
-    if (OS_NULL == src_mat) {
+    void* scratch = uai_mat_aligned_alloc(rfft_scratch_size(plan));
+    if (OS_NULL == scratch) {
+        ERROR("Allocate rfft scratch error.");
+        fft::plan_put(plan);
         return NUMDL_ENOMEM;
     }
 
-    memcpy(src_mat->data, src, src_len * sizeof(float));
+    int ret =
+        rfft(plan, src, src_len, out, out_len, scratch, mode, log_floor);
 
-    int ret = NUMDL_EOK;
+    uai_mat_aligned_free(scratch);
+    fft::plan_put(plan);
 
-    ret = kiss_rfft(src_mat->data, out, fft_len, feat_len);
+    return ret;
+}
 
-    uai_mat_destroy(src_mat);
+struct rfft_rows_task
+{
+    const fft_plan_t* plan;
+    const float* src;
+    os_size_t src_cols;
+    float* out;
+    os_size_t rows;
+    os_size_t rows_per_task;
+    char* scratch;
+    os_size_t scratch_size;
+    rfft_out_t mode;
+    float log_floor;
+    int ret[NUMDL_THREADS_MAX]; /* One status per task */
+};
+
+/* Padded rows, their bins and the batch scratch of one task */
+static os_size_t rfft_rows_scratch_size(const fft_plan_t* plan)
+{
+    os_size_t nfft = fft::plan_nfft(plan);
+    os_size_t pad = UAI_FFT_ROWS * nfft * sizeof(float);
+    os_size_t bins = UAI_FFT_ROWS * (nfft / 2 + 1) * sizeof(kiss_fft_cpx);
+    os_size_t batch = fft::rfft_batch_scratch_size(plan);
 
-    return ret;
+    return ((pad + 15) & ~(os_size_t)15) + ((bins + 15) & ~(os_size_t)15) +
+           ((batch + 15) & ~(os_size_t)15);
 }
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846264338327950288
-#endif  // M_PI
+static void rfft_rows_task_run(void* arg, os_size_t index)
+{
+    rfft_rows_task* t = (rfft_rows_task*)arg;
+    os_size_t nfft = fft::plan_nfft(t->plan);
+    os_size_t bins = nfft / 2 + 1;
+    os_size_t out_cols = rfft_out_len(bins, t->mode);
+
+    char* mem = t->scratch + index * t->scratch_size;
+    float* pad = (float*)mem;
+    os_size_t pad_bytes = UAI_FFT_ROWS * nfft * sizeof(float);
+    os_size_t cpx_offset = (pad_bytes + 15) & ~(os_size_t)15;
+    kiss_fft_cpx* cpx = (kiss_fft_cpx*)(mem + cpx_offset);
+    os_size_t cpx_bytes = UAI_FFT_ROWS * bins * sizeof(kiss_fft_cpx);
+    void* batch = (char*)cpx + ((cpx_bytes + 15) & ~(os_size_t)15);
+
+    os_size_t r0 = index * t->rows_per_task;
+    os_size_t r1 = r0 + t->rows_per_task;
+    r1 = r1 < t->rows ? r1 : t->rows;
+
+    t->ret[index] = NUMDL_EOK;
+    for (os_size_t r = r0; r < r1; r += UAI_FFT_ROWS) {
+        os_size_t count = r1 - r < UAI_FFT_ROWS ? r1 - r : UAI_FFT_ROWS;
+        const float* src = t->src + r * t->src_cols;
+        os_size_t lds = t->src_cols;
+
+        /* Longer rows are cropped in place, shorter ones zero padded */
+        if (t->src_cols < nfft) {
+            for (os_size_t i = 0; i < count; i++) {
+                memcpy(pad + i * nfft,
+                       src + i * t->src_cols,
+                       t->src_cols * sizeof(float));
+                memset(pad + i * nfft + t->src_cols,
+                       0,
+                       (nfft - t->src_cols) * sizeof(float));
+            }
+            src = pad;
+            lds = nfft;
+        }
+
+        /* Complex bins go straight to the output rows */
+        if (RFFT_OUT_COMPLEX == t->mode) {
+            kiss_fft_cpx* out = (kiss_fft_cpx*)(t->out + r * out_cols);
+            int ret =
+                fft::rfft_batch(t->plan, src, lds, count, out, bins, batch);
+            if (ret != NUMDL_EOK) {
+                t->ret[index] = ret;
+                return;
+            }
+            continue;
+        }
+
+        int ret = fft::rfft_batch(t->plan, src, lds, count, cpx, bins, batch);
+        if (ret != NUMDL_EOK) {
+            t->ret[index] = ret;
+            return;
+        }
+
+        for (os_size_t i = 0; i < count; i++) {
+            rfft_output(cpx + i * bins,
+                        t->out + (r + i) * out_cols,
+                        bins,
+                        t->mode,
+                        t->log_floor);
+        }
+    }
+}
 
 /**
- * DCT type II, unscaled
+ * Compute the rfft() of every row of a frame matrix, like a spectrogram.
+ * All rows share one plan, and rows are split across the thread pool,
+ * each thread with its own scratch.
  *
- * Based on https://www.nayuki.io/page/fast-discrete-cosine-transform-algorithms
- * fast-dct-fft.c
+ * @param src     [in]  Frames, one per row, cropped or zero padded to
+ *                      fft_len
+ * @param out     [out] Magnitudes, src->rows x (fft_len / 2 + 1)
+ * @param fft_len [in]  Length of the FFT
  *
- * Copyright (c) 2021, China Mobile Communications Group Co.,Ltd.
- * Copyright (c) 2017 Project Nayuki. (MIT License)
+ * @returns 0 if OK
+ */
+int dsp::rfft(const uai_mat_t* src, uai_mat_t* out, os_size_t fft_len)
+{
+    return rfft(src, out, fft_len, RFFT_OUT_MAGNITUDE, 0.0f);
+}
+
+/**
+ * Compute the rfft() of every row of a frame matrix, output selected by
+ * mode.
+ *
+ * @param src       [in]  Frames, one per row, cropped or zero padded to
+ *                        fft_len
+ * @param out       [out] src->rows x (fft_len / 2 + 1), twice the columns
+ *                        for RFFT_OUT_COMPLEX
+ * @param fft_len   [in]  Length of the FFT
+ * @param mode      [in]  What to output per bin
+ * @param log_floor [in]  Power clamp before the log of RFFT_OUT_LOG_POWER
  *
  * @returns 0 if OK
  */
-static int dct2_transform(float* data, os_size_t data_len)
+int dsp::rfft(const uai_mat_t* src,
+              uai_mat_t* out,
+              os_size_t fft_len,
+              rfft_out_t mode,
+              float log_floor)
 {
-    NUMDL_ASSERT(data != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    os_size_t out_cols = rfft_out_len(fft_len / 2 + 1, mode);
+    if (out->rows != src->rows || out->cols != out_cols) {
+        ERROR("The output shape(%d, %d) mismatch, should be (%d, %d)",
+              out->rows,
+              out->cols,
+              src->rows,
+              out_cols);
+        return NUMDL_EINVAL;
+    }
 
-    float* fft_data_in = (float*)calloc(1, data_len * sizeof(float));
-    if (fft_data_in == OS_NULL) {
-        ERROR("Allocate fft_data_in buffer error.");
+    fft_plan_t* plan = fft::plan_get(fft_len);
+    if (OS_NULL == plan) {
+        ERROR("Get fft plan error.");
         return NUMDL_ENOMEM;
     }
 
-    os_size_t fft_data_out_size = (data_len / 2 + 1) * sizeof(kiss_fft_cpx);
-    kiss_fft_cpx* fft_data_out = (kiss_fft_cpx*)calloc(fft_data_out_size, 1);
-    if (fft_data_out == OS_NULL) {
-        ERROR("Allocate fft_data_out buffer error.");
-        free(fft_data_in);
+    /* Whole groups of UAI_FFT_ROWS rows per task keep the SIMD lanes full */
+    os_size_t threads = thread_pool::get_num_threads();
+    os_size_t groups = (src->rows + UAI_FFT_ROWS - 1) / UAI_FFT_ROWS;
+    os_size_t tasks = 1;
+    if (threads > 1 &&
+        (double)src->rows * fft_len >= NUMDL_FFT_PARALLEL_MIN) {
+        tasks = threads < groups ? threads : groups;
+    }
+
+    rfft_rows_task task;
+    task.plan = plan;
+    task.src = src->data;
+    task.src_cols = src->cols;
+    task.out = out->data;
+    task.rows = src->rows;
+    task.rows_per_task = (groups + tasks - 1) / tasks * UAI_FFT_ROWS;
+    task.mode = mode;
+    task.log_floor = log_floor;
+    task.scratch_size = rfft_rows_scratch_size(plan);
+    task.scratch = (char*)uai_mat_aligned_alloc(tasks * task.scratch_size);
+    if (OS_NULL == task.scratch) {
+        ERROR("Allocate rfft scratch error.");
+        fft::plan_put(plan);
         return NUMDL_ENOMEM;
     }
 
-    /** Preprocess the input buffer with the data */
-    os_size_t half_len = data_len / 2;
-    for (os_size_t i = 0; i < half_len; i++) {
-        fft_data_in[i] = data[i * 2];
-        fft_data_in[data_len - 1 - i] = data[i * 2 + 1];
+    int ret = thread_pool::run(rfft_rows_task_run, &task, tasks);
+    for (os_size_t i = 0; i < tasks && NUMDL_EOK == ret; i++) {
+        ret = task.ret[i];
     }
-    if (data_len % 2 == 1) {
-        fft_data_in[half_len] = data[data_len - 1];
+    if (ret != NUMDL_EOK) {
+        ERROR("rfft of %d rows failed.", (int)src->rows);
     }
 
-    int ret = NUMDL_EOK;
+    uai_mat_aligned_free(task.scratch);
+    fft::plan_put(plan);
 
-    ret = kiss_rfft_cpx(fft_data_in, fft_data_out, data_len);
+    return ret;
+}
 
+/* Lines of a view along the DCT axis: rows for axis 1, columns for 0 */
+struct dct_lines_task
+{
+    const dct_plan_t* plan;
+    const float* src;
+    os_size_t src_ls; /* Distance between two lines */
+    os_size_t src_es; /* Distance between two samples of a line */
+    float* out;
+    os_size_t out_ls;
+    os_size_t out_es;
+    os_size_t lines;
+    os_size_t lines_per_task;
+    char* scratch;
+    os_size_t scratch_size;
+    int ret[NUMDL_THREADS_MAX]; /* One status per task */
+};
+
+static void dct_lines_task_run(void* arg, os_size_t index)
+{
+    dct_lines_task* t = (dct_lines_task*)arg;
 
-    for (os_size_t i = 0; i < data_len / 2 + 1; i++) {
-        float temp = i * M_PI / (data_len * 2);
-        data[i] = fft_data_out[i].r * cos(temp) + fft_data_out[i].i * sin(temp);
-    }
+    os_size_t l0 = index * t->lines_per_task;
+    os_size_t l1 = l0 + t->lines_per_task;
+    l1 = l1 < t->lines ? l1 : t->lines;
 
-    free(fft_data_in);
-    free(fft_data_out);
+    /* Whole groups per task can leave the last tasks without lines */
+    if (l0 >= l1) {
+        t->ret[index] = NUMDL_EOK;
+        return;
+    }
 
-    return ret;
+    int ret = dct::transform_rows(t->plan,
+                                  l1 - l0,
+                                  t->src + l0 * t->src_ls,
+                                  t->src_ls,
+                                  t->src_es,
+                                  t->out + l0 * t->out_ls,
+                                  t->out_ls,
+                                  t->out_es,
+                                  t->scratch + index * t->scratch_size);
+    t->ret[index] = ret;
 }
 
-static int dct2_by_row(float* data, os_size_t length, dct_norm_t mode)
+/*
+ * Run a plan over every line of src along axis. One plan is shared, lines
+ * are split across the thread pool, each thread with its own scratch.
+ */
+static int dct_lines(const dct_plan_t* plan,
+                     const uai_mat_view_t* src,
+                     uai_mat_view_t* out,
+                     int axis)
 {
-    NUMDL_ASSERT(data != OS_NULL);
+    bool cols = (0 == axis);
+
+    dct_lines_task task;
+    task.plan = plan;
+    task.src = uai_mat_view_ptr(src, 0, 0);
+    task.src_ls = cols ? uai_mat_view_cs(src) : uai_mat_view_rs(src);
+    task.src_es = cols ? uai_mat_view_rs(src) : uai_mat_view_cs(src);
+    task.out = uai_mat_view_ptr(out, 0, 0);
+    task.out_ls = cols ? uai_mat_view_cs(out) : uai_mat_view_rs(out);
+    task.out_es = cols ? uai_mat_view_rs(out) : uai_mat_view_cs(out);
+    task.lines = cols ? src->cols : src->rows;
+
+    /* Whole groups of NUMDL_DCT_ROWS lines per task keep the SIMD lanes full */
+    os_size_t threads = thread_pool::get_num_threads();
+    os_size_t groups = (task.lines + NUMDL_DCT_ROWS - 1) / NUMDL_DCT_ROWS;
+    os_size_t tasks = 1;
+    if (threads > 1 && (double)task.lines * dct::plan_size(plan) >=
+                           NUMDL_FFT_PARALLEL_MIN) {
+        tasks = threads < groups ? threads : groups;
+    }
 
-    int ret = dct2_transform(data, length);
+    task.lines_per_task = (groups + tasks - 1) / tasks * NUMDL_DCT_ROWS;
+    task.scratch_size =
+        (dct::rows_scratch_size(plan) + 15) & ~(os_size_t)15;
+    task.scratch = (char*)uai_mat_aligned_alloc(tasks * task.scratch_size);
+    if (OS_NULL == task.scratch) {
+        ERROR("Allocate dct scratch error.");
+        return NUMDL_ENOMEM;
+    }
+
+    int ret = thread_pool::run(dct_lines_task_run, &task, tasks);
+    for (os_size_t i = 0; i < tasks && NUMDL_EOK == ret; i++) {
+        ret = task.ret[i];
+    }
     if (ret != NUMDL_EOK) {
-        return ret;
+        ERROR("DCT of %d lines failed.", (int)task.lines);
     }
 
-    /** for some reason the output is 2x too low... */
-    for (os_size_t i = 0; i < length; i++) {
-        data[i] *= 2;
+    uai_mat_aligned_free(task.scratch);
+
+    return ret;
+}
+
+/*
+ * Check src and out along axis, out may keep fewer coefficients when
+ * truncate is set. Returns the transform size and the number of outputs.
+ */
+static int dct_check_shape(const uai_mat_view_t* src,
+                           const uai_mat_view_t* out,
+                           int axis,
+                           bool truncate,
+                           os_size_t* n,
+                           os_size_t* k)
+{
+    if (axis != 0 && axis != 1 && axis != -1) {
+        ERROR("Invalid dct axis(%d).", axis);
+        return NUMDL_EINVAL;
     }
 
-    if (mode == DCT_NORMAL_ORTHO) {
-        data[0] *= sqrt(1.0f / static_cast<float>(4 * length));
-        for (os_size_t i = 1; i < length; i++) {
-            data[i] *= sqrt(1.0f / static_cast<float>(2 * length));
-        }
+    bool cols = (0 == axis);
+    os_size_t lines = cols ? src->cols : src->rows;
+    os_size_t out_lines = cols ? out->cols : out->rows;
+    *n = cols ? src->rows : src->cols;
+    *k = cols ? out->rows : out->cols;
+
+    if (lines != out_lines || *k > *n || (!truncate && *k != *n)) {
+        ERROR("DCT output(%dx%d) does not fit input(%dx%d).",
+              (int)out->rows,
+              (int)out->cols,
+              (int)src->rows,
+              (int)src->cols);
+        return NUMDL_EINVAL;
     }
 
     return NUMDL_EOK;
@@ -555,15 +1399,204 @@ int dsp::dct2(uai_mat_t* mat, dct_norm_t mode)
 {
     NUMDL_ASSERT(mat != OS_NULL);
 
-    for (os_size_t row = 0; row < mat->rows; row++) {
-        int ret = dct2_by_row(&mat->data[row * mat->cols], mat->cols, mode);
-        if (ret != NUMDL_EOK) {
-            ERROR("DCT2 row %d failed.", row);
-            return ret;
-        }
+    uai_mat_view_t view;
+    uai_mat_view_init(&view, mat);
+
+    return dsp::dct2(&view, mode);
+}
+
+/**
+ * Discrete Cosine Transform of type 2 on every row of a view, in place.
+ * Rows are split across the thread pool as in the truncated version.
+ *
+ * @param view [in,out] input view, rows must not overlap
+ * @param mode [in] DCT_NORMAL_ORTHO or DCT_NORMAL_NONE
+ *
+ * @returns 0 if OK
+ */
+int dsp::dct2(uai_mat_view_t* view, dct_norm_t mode)
+{
+    NUMDL_ASSERT(view != OS_NULL);
+
+    return dsp::dct2(view, view, mode);
+}
+
+/**
+ * Truncated DCT type 2 of every row of a matrix, see the view version
+ *
+ * @param src  [in] input matrix, rows x n
+ * @param out  [out] output matrix, rows x k with k <= n
+ * @param mode [in] DCT_NORMAL_ORTHO or DCT_NORMAL_NONE
+ *
+ * @returns 0 if OK
+ */
+int dsp::dct2(const uai_mat_t* src, uai_mat_t* out, dct_norm_t mode)
+{
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    uai_mat_view_t src_view;
+    uai_mat_view_t out_view;
+    uai_mat_view_init(&src_view, src);
+    uai_mat_view_init(&out_view, out);
+
+    return dsp::dct2(&src_view, &out_view, mode);
+}
+
+/**
+ * Truncated DCT type 2 of every row of a view: only the first out->cols
+ * coefficients of each row are computed. The plan takes the FFT path or a
+ * cached cosine basis, whichever is cheaper for the sizes. One plan is
+ * shared, rows are split across the thread pool, each thread with its own
+ * scratch.
+ *
+ * @param src  [in] input view, rows x n
+ * @param out  [out] output view, rows x k with k <= n, may be src itself
+ * @param mode [in] DCT_NORMAL_ORTHO or DCT_NORMAL_NONE
+ *
+ * @returns 0 if OK
+ */
+int dsp::dct2(const uai_mat_view_t* src,
+              uai_mat_view_t* out,
+              dct_norm_t mode)
+{
+    return dsp::dct(src, out, DCT_TYPE_II, mode, 1);
+}
+
+/**
+ * DCT of every row or column of a matrix, see the view version
+ *
+ * @returns 0 if OK
+ */
+int dsp::dct(const uai_mat_t* src,
+             uai_mat_t* out,
+             dct_type_t type,
+             dct_norm_t norm,
+             int axis)
+{
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    uai_mat_view_t src_view;
+    uai_mat_view_t out_view;
+    uai_mat_view_init(&src_view, src);
+    uai_mat_view_init(&out_view, out);
+
+    return dsp::dct(&src_view, &out_view, type, norm, axis);
+}
+
+/**
+ * DCT of type II, III or IV along an axis, as scipy.fft.dct(x, type, axis,
+ * norm). Columns are read and written through the view strides, nothing
+ * is transposed. Only the first k coefficients of each line are computed,
+ * k being the size of out along the axis.
+ *
+ * @param src  [in] input view
+ * @param out  [out] output view, same lines as src, k <= n along the axis,
+ *                   may be src itself
+ * @param type [in] DCT_TYPE_II, DCT_TYPE_III or DCT_TYPE_IV
+ * @param norm [in] DCT_NORMAL_ORTHO or DCT_NORMAL_NONE
+ * @param axis [in] 1 or -1 transforms each row, 0 each column
+ *
+ * @returns 0 if OK
+ */
+int dsp::dct(const uai_mat_view_t* src,
+             uai_mat_view_t* out,
+             dct_type_t type,
+             dct_norm_t norm,
+             int axis)
+{
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    os_size_t n = 0;
+    os_size_t k = 0;
+    int ret = dct_check_shape(src, out, axis, true, &n, &k);
+    if (ret != NUMDL_EOK) {
+        return ret;
+    }
+    if (0 == src->rows || 0 == src->cols || 0 == k) {
+        return NUMDL_EOK;
     }
 
-    return NUMDL_EOK;
+    dct_plan_t* plan = dct::plan_create(type, n, k, norm, DCT_METHOD_AUTO);
+    if (OS_NULL == plan) {
+        ERROR("Create dct plan error.");
+        return NUMDL_ENOMEM;
+    }
+
+    ret = dct_lines(plan, src, out, axis);
+
+    dct::plan_destroy(plan);
+
+    return ret;
+}
+
+/**
+ * Inverse DCT of every row or column of a matrix, see the view version
+ *
+ * @returns 0 if OK
+ */
+int dsp::idct(const uai_mat_t* src,
+              uai_mat_t* out,
+              dct_type_t type,
+              dct_norm_t norm,
+              int axis)
+{
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    uai_mat_view_t src_view;
+    uai_mat_view_t out_view;
+    uai_mat_view_init(&src_view, src);
+    uai_mat_view_init(&out_view, out);
+
+    return dsp::idct(&src_view, &out_view, type, norm, axis);
+}
+
+/**
+ * Inverse DCT along an axis, as scipy.fft.idct(x, type, axis, norm):
+ * idct(dct(x)) gives x back for the same type and norm, e.g. log-mel
+ * energies from cepstra with type II.
+ *
+ * @param src  [in] input view
+ * @param out  [out] output view of the same shape, may be src itself
+ * @param type [in] Type of the forward transform
+ * @param norm [in] Normalisation of the forward transform
+ * @param axis [in] 1 or -1 transforms each row, 0 each column
+ *
+ * @returns 0 if OK
+ */
+int dsp::idct(const uai_mat_view_t* src,
+              uai_mat_view_t* out,
+              dct_type_t type,
+              dct_norm_t norm,
+              int axis)
+{
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    os_size_t n = 0;
+    os_size_t k = 0;
+    int ret = dct_check_shape(src, out, axis, false, &n, &k);
+    if (ret != NUMDL_EOK) {
+        return ret;
+    }
+    if (0 == src->rows || 0 == src->cols) {
+        return NUMDL_EOK;
+    }
+
+    dct_plan_t* plan = dct::plan_create_inverse(type, n, norm);
+    if (OS_NULL == plan) {
+        ERROR("Create idct plan error.");
+        return NUMDL_ENOMEM;
+    }
+
+    ret = dct_lines(plan, src, out, axis);
+
+    dct::plan_destroy(plan);
+
+    return ret;
 }
 };  // namespace feature
 };  // namespace uai
\ No newline at end of file
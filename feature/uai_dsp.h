@@ -35,6 +35,9 @@
 #ifndef __UAI_DSP_H__
 #define __UAI_DSP_H__
 
+#include "uai_dct.h"
+#include "uai_fft.h"
+#include "uai_gemm.h"
 #include "uai_matrix.h"
 
 #include <os_stddef.h>
@@ -42,20 +45,69 @@
 namespace uai {
 namespace feature {
 
-typedef enum dct_norm
+/** What rfft() outputs per bin */
+typedef enum rfft_out
 {
-    DCT_NORMAL_NONE = 0,
-    DCT_NORMAL_ORTHO
-} dct_norm_t;
+    RFFT_OUT_MAGNITUDE = 0, /* |X| */
+    RFFT_OUT_POWER,         /* |X|^2 */
+    RFFT_OUT_LOG_POWER,     /* ln(max(|X|^2, log_floor)) */
+    RFFT_OUT_COMPLEX        /* (re, im) pairs, twice the bins */
+} rfft_out_t;
 
 /** TODO: 重构参数名称 */
 
 class dsp
 {
 public:
+    static int set_num_threads(os_size_t num);
+
     static float sum(float* input, os_size_t size);
 
     static int dot(uai_mat_t* mat1, uai_mat_t* mat2, uai_mat_t* output);
+    static int dot(const uai_mat_view_t* mat1,
+                   const uai_mat_view_t* mat2,
+                   uai_mat_view_t* output);
+    static int dot(uai_mat_t* mat1,
+                   uai_mat_t* mat2,
+                   uai_mat_t* output,
+                   const gemm_epilogue_t* epilogue);
+    static int dot(const uai_mat_view_t* mat1,
+                   const uai_mat_view_t* mat2,
+                   uai_mat_view_t* output,
+                   const gemm_epilogue_t* epilogue);
+    static int dot(const uai_mat_t* mat1,
+                   gemm_trans_t trans1,
+                   const uai_mat_t* mat2,
+                   gemm_trans_t trans2,
+                   uai_mat_t* output);
+    static int dot(const uai_mat_t* mat1,
+                   gemm_trans_t trans1,
+                   const uai_mat_t* mat2,
+                   gemm_trans_t trans2,
+                   uai_mat_t* output,
+                   const gemm_epilogue_t* epilogue);
+    static int gemv(const uai_mat_t* weight,
+                    gemm_trans_t trans,
+                    const float* input,
+                    float* output,
+                    const gemm_epilogue_t* epilogue);
+    static int gemv_batch(const uai_mat_t* weight,
+                          gemm_trans_t trans,
+                          const uai_mat_t* input,
+                          uai_mat_t* output,
+                          const gemm_epilogue_t* epilogue);
+    static int dot(const uai_mat_csr_t* mat1,
+                   const uai_mat_t* mat2,
+                   uai_mat_t* output);
+    static int dot(const uai_mat_bsr_t* mat1,
+                   const uai_mat_t* mat2,
+                   uai_mat_t* output);
+    static int gemv(const uai_mat_csr_t* weight,
+                    const float* input,
+                    float* output);
+    static int gemv(const uai_mat_bsr_t* weight,
+                    const float* input,
+                    float* output);
     static int dot_by_row(os_size_t mat1_row,
                           float* mat1_row_data,
                           os_size_t mat1_cols,
@@ -72,6 +124,8 @@ public:
 
     static int log(uai_mat_t* matrix);
     static int log10(uai_mat_t* matrix);
+    static int log(uai_mat_view_t* view);
+    static int log10(uai_mat_view_t* view);
 
     static int linspace(float start, float stop, os_size_t num, float* out);
     static int linspace(os_int16_t start,
@@ -88,8 +142,61 @@ public:
                     float* out,
                     os_size_t out_len,
                     os_size_t fft_len);
+    static int rfft(const float* src,
+                    os_size_t src_len,
+                    float* out,
+                    os_size_t out_len,
+                    os_size_t fft_len,
+                    rfft_out_t mode,
+                    float log_floor);
+    static os_size_t rfft_scratch_size(const fft_plan_t* plan);
+    static int rfft(const fft_plan_t* plan,
+                    const float* src,
+                    os_size_t src_len,
+                    float* out,
+                    os_size_t out_len,
+                    void* scratch);
+    static int rfft(const fft_plan_t* plan,
+                    const float* src,
+                    os_size_t src_len,
+                    float* out,
+                    os_size_t out_len,
+                    void* scratch,
+                    rfft_out_t mode,
+                    float log_floor);
+    static int rfft(const uai_mat_t* src, uai_mat_t* out, os_size_t fft_len);
+    static int rfft(const uai_mat_t* src,
+                    uai_mat_t* out,
+                    os_size_t fft_len,
+                    rfft_out_t mode,
+                    float log_floor);
 
     static int dct2(uai_mat_t* mat, dct_norm_t mode);
+    static int dct2(uai_mat_view_t* view, dct_norm_t mode);
+    static int dct2(const uai_mat_t* src, uai_mat_t* out, dct_norm_t mode);
+    static int dct2(const uai_mat_view_t* src,
+                    uai_mat_view_t* out,
+                    dct_norm_t mode);
+    static int dct(const uai_mat_t* src,
+                   uai_mat_t* out,
+                   dct_type_t type,
+                   dct_norm_t norm,
+                   int axis);
+    static int dct(const uai_mat_view_t* src,
+                   uai_mat_view_t* out,
+                   dct_type_t type,
+                   dct_norm_t norm,
+                   int axis);
+    static int idct(const uai_mat_t* src,
+                    uai_mat_t* out,
+                    dct_type_t type,
+                    dct_norm_t norm,
+                    int axis);
+    static int idct(const uai_mat_view_t* src,
+                    uai_mat_view_t* out,
+                    dct_type_t type,
+                    dct_norm_t norm,
+                    int axis);
 };
 
 };  // namespace feature
@@ -0,0 +1,1539 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_fft.cc
+ *
+ * @brief       Reusable real FFT plans and a bounded, thread safe plan cache
+ *              keyed by the transform size.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_fft.h"
+#include "uai_fft_q31.h"
+#include "uai_fft_simd.h"
+#include "uai_matrix.h"
+#include "uai_thread_pool.h"
+#include "nd_errno.h"
+
+#define NUMDL_LOG_TAG "uai.fft"
+#include "nd_log.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nd_assert.h>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#ifdef NUMDL_USING_THREADS
+#include <mutex>
+#endif
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+#include <arm_math.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846264338327950288
+#endif  // M_PI
+
+namespace uai {
+namespace feature {
+
+/**
+ * An even nfft runs as an nfft / 2 point complex FFT of the packed samples
+ * followed by a split with the super twiddles, like kiss_fftr but without
+ * its shared scratch buffer. An odd nfft runs as a full complex FFT.
+ * Header, super twiddles and both kiss states share one allocation.
+ * CMSIS plans only hold the arm_rfft_fast_f32 instance, its tables are
+ * constant data of the library.
+ *
+ * From NUMDL_FFT_FOUR_STEP_MIN points on, the complex FFT runs as
+ * ncfft = n1 * n2 with a six-step scheme instead: transpose, n1 FFTs of n2
+ * points, twiddle, transpose, n2 FFTs of n1 points, transpose. Every pass
+ * works on rows that fit the cache and the FFTs of a pass run on the
+ * thread pool. Its twiddles W^(j1 * k2) are the product of a coarse and a
+ * fine table of about sqrt(ncfft) entries each.
+ */
+struct fft_plan
+{
+    os_size_t nfft;
+    os_size_t ncfft;
+    fft_backend_t backend; /* Never FFT_BACKEND_AUTO */
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+    arm_rfft_fast_instance_f32 cmsis;
+#endif
+    kiss_fft_cfg cfg;
+    kiss_fft_cpx* super_twiddles;
+    void* simd_cfg; /* 4 lane state of even sizes, OS_NULL without SSE */
+    os_size_t bytes;
+
+    /* Four-step plans only, cfg is OS_NULL then */
+    os_size_t n1;
+    os_size_t n2;
+    kiss_fft_cfg cfg1; /* n1 points */
+    kiss_fft_cfg cfg2; /* n2 points */
+    kiss_fft_cpx* tw_coarse; /* W^(q * tw_step) */
+    kiss_fft_cpx* tw_fine;   /* W^r, r < tw_step */
+    os_size_t tw_step;
+
+    /* Cache bookkeeping, guarded by the cache lock */
+    os_size_t refs;
+    bool cached;
+    fft_plan* hash_next;
+    fft_plan* lru_prev;
+    fft_plan* lru_next;
+};
+
+struct fft_cache
+{
+#ifdef NUMDL_USING_THREADS
+    std::mutex lock;
+#endif
+    fft_plan* buckets[UAI_FFT_CACHE_BUCKETS] = {};
+    fft_plan* lru_head = OS_NULL; /* Idle plans, most recently used first */
+    fft_plan* lru_tail = OS_NULL;
+    os_size_t plans = 0;
+    os_size_t bytes = 0;
+    os_size_t max_plans = NUMDL_FFT_CACHE_PLANS;
+    os_size_t max_bytes = NUMDL_FFT_CACHE_BYTES;
+    fft_backend_t backend = (fft_backend_t)NUMDL_FFT_BACKEND;
+
+    ~fft_cache();
+};
+
+#ifdef NUMDL_USING_THREADS
+#define UAI_FFT_CACHE_LOCK(c) std::lock_guard<std::mutex> guard((c).lock)
+#else
+#define UAI_FFT_CACHE_LOCK(c)
+#endif
+
+static fft_cache& cache_get(void)
+{
+    static fft_cache cache;
+    return cache;
+}
+
+static os_size_t fft_align_up(os_size_t size)
+{
+    return (size + 15) & ~(os_size_t)15;
+}
+
+static fft_plan** cache_bucket(fft_cache& c, os_size_t nfft)
+{
+    return &c.buckets[nfft % UAI_FFT_CACHE_BUCKETS];
+}
+
+static void lru_unlink(fft_cache& c, fft_plan* plan)
+{
+    if (plan->lru_prev != OS_NULL) {
+        plan->lru_prev->lru_next = plan->lru_next;
+    } else {
+        c.lru_head = plan->lru_next;
+    }
+    if (plan->lru_next != OS_NULL) {
+        plan->lru_next->lru_prev = plan->lru_prev;
+    } else {
+        c.lru_tail = plan->lru_prev;
+    }
+    plan->lru_prev = OS_NULL;
+    plan->lru_next = OS_NULL;
+}
+
+static void lru_push_front(fft_cache& c, fft_plan* plan)
+{
+    plan->lru_prev = OS_NULL;
+    plan->lru_next = c.lru_head;
+    if (c.lru_head != OS_NULL) {
+        c.lru_head->lru_prev = plan;
+    } else {
+        c.lru_tail = plan;
+    }
+    c.lru_head = plan;
+}
+
+static void cache_unlink(fft_cache& c, fft_plan* plan)
+{
+    fft_plan** link = cache_bucket(c, plan->nfft);
+
+    while (*link != plan) {
+        link = &(*link)->hash_next;
+    }
+    *link = plan->hash_next;
+    plan->hash_next = OS_NULL;
+    plan->cached = false;
+
+    c.plans--;
+    c.bytes -= plan->bytes;
+}
+
+/* Evict idle plans, least recently used first, until one more plan of
+ * the given size fits. Plans in use are never evicted. */
+static bool cache_make_room(fft_cache& c, os_size_t bytes)
+{
+    while ((c.plans + 1 > c.max_plans || c.bytes + bytes > c.max_bytes) &&
+           c.lru_tail != OS_NULL) {
+        fft_plan* victim = c.lru_tail;
+        lru_unlink(c, victim);
+        cache_unlink(c, victim);
+        uai_mat_aligned_free(victim);
+    }
+
+    return c.plans + 1 <= c.max_plans && c.bytes + bytes <= c.max_bytes;
+}
+
+fft_cache::~fft_cache()
+{
+    while (lru_tail != OS_NULL) {
+        fft_plan* victim = lru_tail;
+        lru_unlink(*this, victim);
+        cache_unlink(*this, victim);
+        uai_mat_aligned_free(victim);
+    }
+}
+
+/**
+ * Select the backend of the plans created from now on. Plans already made
+ * keep their backend, cached plans of either backend stay cached.
+ *
+ * @param backend [in] Backend
+ *
+ * @returns 0 if OK
+ */
+int fft::set_backend(fft_backend_t backend)
+{
+    if (backend != FFT_BACKEND_AUTO && backend != FFT_BACKEND_KISSFFT &&
+        backend != FFT_BACKEND_CMSIS) {
+        ERROR("Invalid fft backend(%d).", (int)backend);
+        return NUMDL_EINVAL;
+    }
+#ifndef UAI_CMSIS_DSP_USING_TRANSFORM
+    if (FFT_BACKEND_CMSIS == backend) {
+        ERROR("numDL built without UAI_CMSIS_DSP_USING_TRANSFORM.");
+        return NUMDL_EINVAL;
+    }
+#endif
+
+    fft_cache& c = cache_get();
+    UAI_FFT_CACHE_LOCK(c);
+    c.backend = backend;
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Get the backend new plans are created with
+ *
+ * @returns Backend, NUMDL_FFT_BACKEND unless set otherwise
+ */
+fft_backend_t fft::get_backend(void)
+{
+    fft_cache& c = cache_get();
+    UAI_FFT_CACHE_LOCK(c);
+    return c.backend;
+}
+
+/**
+ * Check whether a backend can transform nfft points
+ *
+ * @param backend [in] Backend
+ * @param nfft    [in] Number of real input samples
+ *
+ * @returns true if plan_create(nfft, backend) may succeed
+ */
+bool fft::backend_supports(fft_backend_t backend, os_size_t nfft)
+{
+    if (nfft < 1) {
+        return false;
+    }
+    if (backend != FFT_BACKEND_CMSIS) {
+        return true;
+    }
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+    return nfft >= 32 && nfft <= 4096 && 0 == (nfft & (nfft - 1));
+#else
+    return false;
+#endif
+}
+
+static fft_backend_t fft_backend_resolve(fft_backend_t backend,
+                                         os_size_t nfft)
+{
+    if (backend != FFT_BACKEND_AUTO) {
+        return backend;
+    }
+    if (nfft >= NUMDL_FFT_CMSIS_MIN && nfft <= NUMDL_FFT_CMSIS_MAX &&
+        fft::backend_supports(FFT_BACKEND_CMSIS, nfft)) {
+        return FFT_BACKEND_CMSIS;
+    }
+    return FFT_BACKEND_KISSFFT;
+}
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+static fft_plan* fft_plan_create_cmsis(os_size_t nfft)
+{
+    os_size_t bytes = fft_align_up(sizeof(fft_plan));
+
+    fft_plan* plan = (fft_plan*)uai_mat_aligned_alloc(bytes);
+    if (OS_NULL == plan) {
+        ERROR("Allocate fft plan of size %d error.", (int)nfft);
+        return OS_NULL;
+    }
+
+    memset(plan, 0, sizeof(fft_plan));
+    plan->nfft = nfft;
+    plan->ncfft = nfft / 2;
+    plan->backend = FFT_BACKEND_CMSIS;
+    plan->bytes = bytes;
+
+    if (arm_rfft_fast_init_f32(&plan->cmsis, (uint16_t)nfft) !=
+        ARM_MATH_SUCCESS) {
+        ERROR("Init arm_rfft_fast_f32 of size %d error.", (int)nfft);
+        uai_mat_aligned_free(plan);
+        return OS_NULL;
+    }
+
+    return plan;
+}
+#endif
+
+/* Split ncfft into n1 * n2 with n1 the largest divisor up to sqrt(ncfft).
+ * Sizes below the threshold or without a useful split stay one FFT. */
+static bool fft_four_step_split(os_size_t ncfft, os_size_t* n1, os_size_t* n2)
+{
+    if (2 * ncfft < NUMDL_FFT_FOUR_STEP_MIN) {
+        return false;
+    }
+
+    os_size_t d = (os_size_t)sqrt((double)ncfft);
+    while (d > 1 && ncfft % d != 0) {
+        d--;
+    }
+    if (d < UAI_FFT_FOUR_STEP_MIN_SPLIT) {
+        return false;
+    }
+
+    *n1 = d;
+    *n2 = ncfft / d;
+    return true;
+}
+
+/* Twiddle tables and the n2 point state of a four-step plan, at mem */
+static void fft_four_step_init(fft_plan* plan,
+                               os_size_t n1,
+                               os_size_t n2,
+                               os_size_t tw_step,
+                               char* mem)
+{
+    os_size_t ncfft = n1 * n2;
+    os_size_t coarse = ncfft / tw_step + 1;
+    os_size_t coarse_bytes = fft_align_up(coarse * sizeof(kiss_fft_cpx));
+    os_size_t fine_bytes = fft_align_up(tw_step * sizeof(kiss_fft_cpx));
+    size_t cfg2_bytes = 0;
+
+    kiss_fft_alloc((int)n2, 0, OS_NULL, &cfg2_bytes);
+
+    plan->n1 = n1;
+    plan->n2 = n2;
+    plan->tw_step = tw_step;
+    plan->tw_coarse = (kiss_fft_cpx*)mem;
+    plan->tw_fine = (kiss_fft_cpx*)(mem + coarse_bytes);
+    plan->cfg2 = kiss_fft_alloc(
+        (int)n2, 0, mem + coarse_bytes + fine_bytes, &cfg2_bytes);
+    NUMDL_ASSERT(plan->cfg2 != OS_NULL);
+
+    for (os_size_t q = 0; q < coarse; q++) {
+        double phase = -2.0 * M_PI * (double)(q * tw_step) / ncfft;
+        plan->tw_coarse[q].r = (kiss_fft_scalar)cos(phase);
+        plan->tw_coarse[q].i = (kiss_fft_scalar)sin(phase);
+    }
+    for (os_size_t r = 0; r < tw_step; r++) {
+        double phase = -2.0 * M_PI * (double)r / ncfft;
+        plan->tw_fine[r].r = (kiss_fft_scalar)cos(phase);
+        plan->tw_fine[r].i = (kiss_fft_scalar)sin(phase);
+    }
+}
+
+/**
+ * Create an FFT plan that is not shared through the cache, with the
+ * backend selected by set_backend()
+ *
+ * @param nfft [in] Number of real input samples
+ *
+ * @returns Plan, OS_NULL on failure
+ */
+fft_plan_t* fft::plan_create(os_size_t nfft)
+{
+    return plan_create(nfft, get_backend());
+}
+
+/**
+ * Create an FFT plan that is not shared through the cache
+ *
+ * @param nfft    [in] Number of real input samples
+ * @param backend [in] Backend, FFT_BACKEND_AUTO picks one for nfft
+ *
+ * @returns Plan, OS_NULL on failure
+ */
+fft_plan_t* fft::plan_create(os_size_t nfft, fft_backend_t backend)
+{
+    if (nfft < 1) {
+        ERROR("Invalid fft size(%d).", (int)nfft);
+        return OS_NULL;
+    }
+
+    backend = fft_backend_resolve(backend, nfft);
+    if (!backend_supports(backend, nfft)) {
+        ERROR("Fft backend(%d) has no size %d.", (int)backend, (int)nfft);
+        return OS_NULL;
+    }
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+    if (FFT_BACKEND_CMSIS == backend) {
+        return fft_plan_create_cmsis(nfft);
+    }
+#endif
+
+    os_size_t ncfft = (nfft % 2 == 0) ? nfft / 2 : nfft;
+    os_size_t twiddles = (nfft % 2 == 0) ? ncfft / 2 : 0;
+    os_size_t n1 = 0;
+    os_size_t n2 = 0;
+    os_size_t tw_step = 0;
+    size_t cfg_bytes = 0;
+    size_t cfg1_bytes = 0;
+    size_t cfg2_bytes = 0;
+    os_size_t four_bytes = 0;
+
+    if (nfft % 2 == 0 && fft_four_step_split(ncfft, &n1, &n2)) {
+        tw_step = (os_size_t)ceil(sqrt((double)ncfft));
+        kiss_fft_alloc((int)n1, 0, OS_NULL, &cfg1_bytes);
+        kiss_fft_alloc((int)n2, 0, OS_NULL, &cfg2_bytes);
+        four_bytes =
+            fft_align_up((ncfft / tw_step + 1) * sizeof(kiss_fft_cpx)) +
+            fft_align_up(tw_step * sizeof(kiss_fft_cpx)) +
+            fft_align_up(cfg2_bytes);
+        cfg_bytes = cfg1_bytes;
+    } else {
+        kiss_fft_alloc((int)ncfft, 0, OS_NULL, &cfg_bytes);
+    }
+
+    os_size_t head = fft_align_up(sizeof(fft_plan));
+    os_size_t tw_bytes = fft_align_up(twiddles * sizeof(kiss_fft_cpx));
+    os_size_t simd_bytes = 0;
+#if defined(__SSE__)
+    if (nfft % 2 == 0 && 0 == n1) {
+        simd_bytes = uai_fft_simd_cfg_size(ncfft);
+    }
+#endif
+    os_size_t four_offset = head + tw_bytes + fft_align_up(simd_bytes);
+    os_size_t cfg_offset = four_offset + four_bytes;
+    os_size_t bytes = cfg_offset + cfg_bytes;
+
+    char* mem = (char*)uai_mat_aligned_alloc(bytes);
+    if (OS_NULL == mem) {
+        ERROR("Allocate fft plan of size %d error.", (int)nfft);
+        return OS_NULL;
+    }
+
+    fft_plan* plan = (fft_plan*)mem;
+    memset(plan, 0, sizeof(fft_plan));
+    plan->nfft = nfft;
+    plan->ncfft = ncfft;
+    plan->backend = FFT_BACKEND_KISSFFT;
+    plan->bytes = bytes;
+    plan->super_twiddles = (kiss_fft_cpx*)(mem + head);
+    if (n1 > 0) {
+        fft_four_step_init(plan, n1, n2, tw_step, mem + four_offset);
+        plan->cfg1 = kiss_fft_alloc((int)n1, 0, mem + cfg_offset, &cfg1_bytes);
+        NUMDL_ASSERT(plan->cfg1 != OS_NULL);
+    } else {
+        plan->cfg = kiss_fft_alloc((int)ncfft, 0, mem + cfg_offset, &cfg_bytes);
+        NUMDL_ASSERT(plan->cfg != OS_NULL);
+    }
+#if defined(__SSE__)
+    if (simd_bytes > 0) {
+        plan->simd_cfg = uai_fft_simd_cfg_init(ncfft, mem + head + tw_bytes);
+    }
+#endif
+
+    for (os_size_t i = 0; i < twiddles; i++) {
+        double phase = -M_PI * ((double)(i + 1) / ncfft + .5);
+        plan->super_twiddles[i].r = (kiss_fft_scalar)cos(phase);
+        plan->super_twiddles[i].i = (kiss_fft_scalar)sin(phase);
+    }
+
+    return plan;
+}
+
+/**
+ * Destroy a plan made by plan_create()
+ *
+ * @param plan [in] Plan, OS_NULL is ignored
+ */
+void fft::plan_destroy(fft_plan_t* plan)
+{
+    if (plan != OS_NULL) {
+        NUMDL_ASSERT(!plan->cached);
+        uai_mat_aligned_free(plan);
+    }
+}
+
+/**
+ * Get the transform size of a plan
+ *
+ * @param plan [in] Plan
+ *
+ * @returns Number of real input samples
+ */
+os_size_t fft::plan_nfft(const fft_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    return plan->nfft;
+}
+
+/**
+ * Get the backend running the transforms of a plan
+ *
+ * @param plan [in] Plan
+ *
+ * @returns FFT_BACKEND_KISSFFT or FFT_BACKEND_CMSIS
+ */
+fft_backend_t fft::plan_backend(const fft_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    return plan->backend;
+}
+
+/**
+ * Get a plan for nfft points on the backend selected by set_backend() from
+ * the cache, building it on a miss. Every plan_get() must be paired with a
+ * plan_put(). When the cache is full of plans in use the plan is private to
+ * the caller and freed by plan_put().
+ *
+ * @param nfft [in] Number of real input samples
+ *
+ * @returns Plan, OS_NULL on failure
+ */
+fft_plan_t* fft::plan_get(os_size_t nfft)
+{
+    fft_cache& c = cache_get();
+    fft_backend_t backend;
+
+    {
+        UAI_FFT_CACHE_LOCK(c);
+        backend = fft_backend_resolve(c.backend, nfft);
+        for (fft_plan* p = *cache_bucket(c, nfft); p != OS_NULL;
+             p = p->hash_next) {
+            if (p->nfft == nfft && p->backend == backend) {
+                if (0 == p->refs++) {
+                    lru_unlink(c, p);
+                }
+                return p;
+            }
+        }
+    }
+
+    /* Build outside the lock, twiddles take a while for large sizes */
+    fft_plan* plan = plan_create(nfft, backend);
+    if (OS_NULL == plan) {
+        return OS_NULL;
+    }
+    plan->refs = 1;
+
+    UAI_FFT_CACHE_LOCK(c);
+
+    /* Another thread may have cached the same plan meanwhile */
+    for (fft_plan* p = *cache_bucket(c, nfft); p != OS_NULL;
+         p = p->hash_next) {
+        if (p->nfft == nfft && p->backend == backend) {
+            if (0 == p->refs++) {
+                lru_unlink(c, p);
+            }
+            uai_mat_aligned_free(plan);
+            return p;
+        }
+    }
+
+    if (cache_make_room(c, plan->bytes)) {
+        fft_plan** bucket = cache_bucket(c, nfft);
+        plan->hash_next = *bucket;
+        *bucket = plan;
+        plan->cached = true;
+        c.plans++;
+        c.bytes += plan->bytes;
+    }
+
+    return plan;
+}
+
+/**
+ * Return a plan got by plan_get(). Idle cached plans stay cached until
+ * evicted, uncached plans are freed.
+ *
+ * @param plan [in] Plan, OS_NULL is ignored
+ */
+void fft::plan_put(fft_plan_t* plan)
+{
+    if (OS_NULL == plan) {
+        return;
+    }
+
+    fft_cache& c = cache_get();
+    UAI_FFT_CACHE_LOCK(c);
+
+    NUMDL_ASSERT(plan->refs > 0);
+    if (--plan->refs > 0) {
+        return;
+    }
+
+    if (plan->cached) {
+        lru_push_front(c, plan);
+    } else {
+        uai_mat_aligned_free(plan);
+    }
+}
+
+/**
+ * Bound the plan cache, idle plans above the new limits are evicted.
+ *
+ * @param plans [in] Most plans kept, 0 disables caching
+ * @param bytes [in] Most bytes kept
+ *
+ * @returns 0 if OK
+ */
+int fft::cache_limit(os_size_t plans, os_size_t bytes)
+{
+    fft_cache& c = cache_get();
+    UAI_FFT_CACHE_LOCK(c);
+
+    c.max_plans = plans;
+    c.max_bytes = bytes;
+
+    while ((c.plans > c.max_plans || c.bytes > c.max_bytes) &&
+           c.lru_tail != OS_NULL) {
+        fft_plan* victim = c.lru_tail;
+        lru_unlink(c, victim);
+        cache_unlink(c, victim);
+        uai_mat_aligned_free(victim);
+    }
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Free every idle cached plan. Plans in use stay valid and leave the cache
+ * when they are put back.
+ */
+void fft::cache_clear(void)
+{
+    fft_cache& c = cache_get();
+    UAI_FFT_CACHE_LOCK(c);
+
+    while (c.lru_tail != OS_NULL) {
+        fft_plan* victim = c.lru_tail;
+        lru_unlink(c, victim);
+        cache_unlink(c, victim);
+        uai_mat_aligned_free(victim);
+    }
+
+    for (os_size_t i = 0; i < UAI_FFT_CACHE_BUCKETS; i++) {
+        fft_plan* p = c.buckets[i];
+        while (p != OS_NULL) {
+            fft_plan* next = p->hash_next;
+            cache_unlink(c, p);
+            p = next;
+        }
+    }
+}
+
+/* Turn the nfft / 2 point complex FFT of the packed even/odd samples into
+ * the first nfft / 2 + 1 bins of the real FFT, in place. Same steps as
+ * kiss_fftr, results are equal to it up to rounding. */
+static void fft_split(const fft_plan* plan, kiss_fft_cpx* out)
+{
+    os_size_t ncfft = plan->ncfft;
+    kiss_fft_cpx tdc = out[0];
+
+    out[0].r = tdc.r + tdc.i;
+    out[ncfft].r = tdc.r - tdc.i;
+    out[0].i = 0;
+    out[ncfft].i = 0;
+
+    for (os_size_t k = 1; k <= ncfft / 2; k++) {
+        kiss_fft_cpx fpk = out[k];
+        kiss_fft_cpx fpnk;
+        fpnk.r = out[ncfft - k].r;
+        fpnk.i = -out[ncfft - k].i;
+
+        kiss_fft_cpx f1k, f2k, tw;
+        f1k.r = fpk.r + fpnk.r;
+        f1k.i = fpk.i + fpnk.i;
+        f2k.r = fpk.r - fpnk.r;
+        f2k.i = fpk.i - fpnk.i;
+
+        const kiss_fft_cpx& st = plan->super_twiddles[k - 1];
+        tw.r = f2k.r * st.r - f2k.i * st.i;
+        tw.i = f2k.r * st.i + f2k.i * st.r;
+
+        out[k].r = (f1k.r + tw.r) * 0.5f;
+        out[k].i = (f1k.i + tw.i) * 0.5f;
+        out[ncfft - k].r = (f1k.r - tw.r) * 0.5f;
+        out[ncfft - k].i = (tw.i - f1k.i) * 0.5f;
+    }
+}
+
+struct fft_four_step_task
+{
+    const fft_plan* plan;
+    const kiss_fft_cpx* src;
+    os_size_t lds;
+    kiss_fft_cpx* dst;
+    os_size_t ldd;
+    os_size_t rows; /* Of src */
+    os_size_t cols;
+    kiss_fft_cfg cfg; /* cols points, FFT passes only */
+    bool twiddle;
+};
+
+/* Rows of the work matrices are padded by a cache line, so the columns a
+ * transpose walks do not all map to the same cache set */
+static os_size_t fft_four_step_ld(os_size_t cols)
+{
+    return cols + UAI_FFT_FOUR_STEP_PAD;
+}
+
+/* Bins of each of the two work matrices of a four-step plan */
+static os_size_t fft_four_step_work(const fft_plan* plan)
+{
+    os_size_t a = plan->n1 * fft_four_step_ld(plan->n2);
+    os_size_t b = plan->n2 * fft_four_step_ld(plan->n1);
+    return a > b ? a : b;
+}
+
+/* dst = transpose of src, one band of UAI_FFT_TILE src rows per task */
+static void fft_transpose_task_run(void* arg, os_size_t index)
+{
+    const fft_four_step_task* t = (const fft_four_step_task*)arg;
+    os_size_t r0 = index * UAI_FFT_TILE;
+    os_size_t r1 = r0 + UAI_FFT_TILE < t->rows ? r0 + UAI_FFT_TILE : t->rows;
+
+    for (os_size_t c0 = 0; c0 < t->cols; c0 += UAI_FFT_TILE) {
+        os_size_t c1 =
+            c0 + UAI_FFT_TILE < t->cols ? c0 + UAI_FFT_TILE : t->cols;
+        for (os_size_t c = c0; c < c1; c++) {
+            kiss_fft_cpx* d = t->dst + c * t->ldd;
+            for (os_size_t r = r0; r < r1; r++) {
+                d[r] = t->src[r * t->lds + c];
+            }
+        }
+    }
+}
+
+/* row[k2] *= W^(j1 * k2), W^i = coarse[i / tw_step] * fine[i % tw_step].
+ * j1 * k2 < ncfft, so the index needs no wrap. */
+static void fft_four_step_twiddle(const fft_plan* plan,
+                                  os_size_t j1,
+                                  kiss_fft_cpx* row,
+                                  os_size_t cols)
+{
+    os_size_t step = plan->tw_step;
+    os_size_t dq = j1 / step;
+    os_size_t dr = j1 % step;
+    os_size_t q = 0;
+    os_size_t r = 0;
+
+    for (os_size_t k2 = 0; k2 < cols; k2++) {
+        const kiss_fft_cpx& a = plan->tw_coarse[q];
+        const kiss_fft_cpx& b = plan->tw_fine[r];
+        kiss_fft_cpx w, x = row[k2];
+        w.r = a.r * b.r - a.i * b.i;
+        w.i = a.r * b.i + a.i * b.r;
+        row[k2].r = x.r * w.r - x.i * w.i;
+        row[k2].i = x.r * w.i + x.i * w.r;
+
+        q += dq;
+        r += dr;
+        if (r >= step) {
+            r -= step;
+            q++;
+        }
+    }
+}
+
+/* FFT of UAI_FFT_ROWS rows per task, twiddled when asked */
+static void fft_rows_task_run(void* arg, os_size_t index)
+{
+    const fft_four_step_task* t = (const fft_four_step_task*)arg;
+    os_size_t r0 = index * UAI_FFT_ROWS;
+    os_size_t r1 = r0 + UAI_FFT_ROWS < t->rows ? r0 + UAI_FFT_ROWS : t->rows;
+
+    for (os_size_t r = r0; r < r1; r++) {
+        kiss_fft_cpx* row = t->dst + r * t->ldd;
+        kiss_fft(t->cfg, t->src + r * t->lds, row);
+        if (t->twiddle) {
+            fft_four_step_twiddle(t->plan, r, row, t->cols);
+        }
+    }
+}
+
+static int fft_four_step_pass(fft_four_step_task* task, thread_task_t run)
+{
+    os_size_t band = (run == fft_rows_task_run) ? UAI_FFT_ROWS : UAI_FFT_TILE;
+
+    return thread_pool::run(run, task, (task->rows + band - 1) / band);
+}
+
+/* Complex FFT of ncfft points, src and out differ. Four-step plans use
+ * 2 * fft_four_step_work() bins of work, other plans none. */
+static int fft_complex(const fft_plan* plan,
+                       const kiss_fft_cpx* src,
+                       kiss_fft_cpx* out,
+                       kiss_fft_cpx* work)
+{
+    if (0 == plan->n1) {
+        kiss_fft(plan->cfg, src, out);
+        return NUMDL_EOK;
+    }
+
+    NUMDL_ASSERT(work != OS_NULL);
+
+    os_size_t n1 = plan->n1;
+    os_size_t n2 = plan->n2;
+    kiss_fft_cpx* a = work;
+    kiss_fft_cpx* b = work + fft_four_step_work(plan);
+
+    /* src[j1 + n1 * j2] as n2 x n1 -> a, n1 x n2 */
+    fft_four_step_task t = {
+        plan, src, n1, a, fft_four_step_ld(n2), n2, n1, OS_NULL, false};
+    int ret = fft_four_step_pass(&t, fft_transpose_task_run);
+
+    /* FFT over j2 and twiddle by W^(j1 * k2) -> b[j1][k2] */
+    if (NUMDL_EOK == ret) {
+        t = {plan, a, t.ldd, b, t.ldd, n1, n2, plan->cfg2, true};
+        ret = fft_four_step_pass(&t, fft_rows_task_run);
+    }
+
+    /* b, n1 x n2 -> a, n2 x n1 */
+    if (NUMDL_EOK == ret) {
+        t = {plan, b, t.ldd, a, fft_four_step_ld(n1), n1, n2, OS_NULL, false};
+        ret = fft_four_step_pass(&t, fft_transpose_task_run);
+    }
+
+    /* FFT over j1 -> b[k2][k1] */
+    if (NUMDL_EOK == ret) {
+        t = {plan, a, t.ldd, b, t.ldd, n2, n1, plan->cfg1, false};
+        ret = fft_four_step_pass(&t, fft_rows_task_run);
+    }
+
+    /* out[k2 + n2 * k1] is b transposed */
+    if (NUMDL_EOK == ret) {
+        t = {plan, b, t.ldd, out, n2, n2, n1, OS_NULL, false};
+        ret = fft_four_step_pass(&t, fft_transpose_task_run);
+    }
+
+    return ret;
+}
+
+/**
+ * Get the scratch an rfft() with the plan needs
+ *
+ * @param plan [in] Plan
+ *
+ * @returns Size of the scratch in bytes, 0 if none is needed
+ */
+os_size_t fft::rfft_scratch_size(const fft_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+
+    if (FFT_BACKEND_CMSIS == plan->backend) {
+        /* arm_rfft_fast_f32 works in place on its input */
+        return plan->nfft * sizeof(float);
+    }
+    if (plan->nfft % 2 == 0) {
+        os_size_t work = plan->n1 > 0 ? 2 * fft_four_step_work(plan) : 0;
+        return work * sizeof(kiss_fft_cpx);
+    }
+    return 2 * plan->nfft * sizeof(kiss_fft_cpx);
+}
+
+/**
+ * Compute the first nfft / 2 + 1 bins of the FFT of nfft real samples.
+ * Many threads may run the same plan at once. Odd sizes, four-step sizes
+ * and CMSIS plans allocate their scratch, use the overload taking a
+ * scratch to avoid it.
+ *
+ * @param plan [in] Plan
+ * @param src  [in] nfft real samples
+ * @param out  [out] nfft / 2 + 1 complex bins
+ *
+ * @returns 0 if OK
+ */
+int fft::rfft(const fft_plan_t* plan, const float* src, kiss_fft_cpx* out)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+
+    os_size_t size = rfft_scratch_size(plan);
+    if (0 == size) {
+        return rfft(plan, src, out, OS_NULL);
+    }
+
+    void* scratch = malloc(size);
+    if (OS_NULL == scratch) {
+        ERROR("Allocate fft scratch error.");
+        return NUMDL_ENOMEM;
+    }
+
+    int ret = rfft(plan, src, out, scratch);
+
+    free(scratch);
+    return ret;
+}
+
+/**
+ * Compute the first nfft / 2 + 1 bins of the FFT of nfft real samples
+ * without touching the heap. Sizes with a prime factor above 5 still
+ * allocate inside kissfft.
+ *
+ * @param plan    [in] Plan
+ * @param src     [in] nfft real samples
+ * @param out     [out] nfft / 2 + 1 complex bins
+ * @param scratch [in] rfft_scratch_size() bytes aligned for floats, may be
+ *                     OS_NULL if that is 0
+ *
+ * @returns 0 if OK
+ */
+int fft::rfft(const fft_plan_t* plan,
+              const float* src,
+              kiss_fft_cpx* out,
+              void* scratch)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+    if (FFT_BACKEND_CMSIS == plan->backend) {
+        NUMDL_ASSERT(scratch != OS_NULL);
+
+        os_size_t nfft = plan->nfft;
+        float* buf = (float*)scratch;
+        float* bins = (float*)out;
+
+        memcpy(buf, src, nfft * sizeof(float));
+        arm_rfft_fast_f32(&plan->cmsis, buf, bins, 0);
+
+        /* CMSIS packs the real Nyquist bin into the imaginary part of DC */
+        bins[nfft] = bins[1];
+        bins[nfft + 1] = 0;
+        bins[1] = 0;
+        return NUMDL_EOK;
+    }
+#endif
+
+    if (plan->nfft % 2 == 0) {
+        /* Input and output differ, so kiss_fft needs no scratch of its own */
+        int ret = fft_complex(
+            plan, (const kiss_fft_cpx*)src, out, (kiss_fft_cpx*)scratch);
+        if (ret != NUMDL_EOK) {
+            return ret;
+        }
+        fft_split(plan, out);
+        return NUMDL_EOK;
+    }
+
+    NUMDL_ASSERT(scratch != OS_NULL);
+
+    os_size_t nfft = plan->nfft;
+    kiss_fft_cpx* buf = (kiss_fft_cpx*)scratch;
+
+    for (os_size_t i = 0; i < nfft; i++) {
+        buf[i].r = src[i];
+        buf[i].i = 0;
+    }
+    kiss_fft(plan->cfg, buf, buf + nfft);
+    memcpy(out, buf + nfft, (nfft / 2 + 1) * sizeof(kiss_fft_cpx));
+
+    return NUMDL_EOK;
+}
+
+#if defined(__SSE__)
+/* Interleave sample i of the 4 frames into dst[i * 4 .. i * 4 + 3] */
+static void fft_simd_pack(const float* src,
+                          os_size_t lds,
+                          os_size_t nfft,
+                          float* dst)
+{
+    const float* s0 = src;
+    const float* s1 = src + lds;
+    const float* s2 = src + 2 * lds;
+    const float* s3 = src + 3 * lds;
+    os_size_t i = 0;
+
+    for (; i + 4 <= nfft; i += 4) {
+        __m128 r0 = _mm_loadu_ps(s0 + i);
+        __m128 r1 = _mm_loadu_ps(s1 + i);
+        __m128 r2 = _mm_loadu_ps(s2 + i);
+        __m128 r3 = _mm_loadu_ps(s3 + i);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_store_ps(dst + i * 4, r0);
+        _mm_store_ps(dst + i * 4 + 4, r1);
+        _mm_store_ps(dst + i * 4 + 8, r2);
+        _mm_store_ps(dst + i * 4 + 12, r3);
+    }
+    for (; i < nfft; i++) {
+        _mm_store_ps(dst + i * 4, _mm_setr_ps(s0[i], s1[i], s2[i], s3[i]));
+    }
+}
+
+/* Scatter bins of 4 real then 4 imaginary parts back to the 4 frames */
+static void fft_simd_unpack(const float* src,
+                            os_size_t bins,
+                            kiss_fft_cpx* out,
+                            os_size_t ldo)
+{
+    float* d0 = (float*)out;
+    float* d1 = (float*)(out + ldo);
+    float* d2 = (float*)(out + 2 * ldo);
+    float* d3 = (float*)(out + 3 * ldo);
+
+    for (os_size_t k = 0; k < bins; k++) {
+        __m128 re = _mm_load_ps(src + k * 8);
+        __m128 im = _mm_load_ps(src + k * 8 + 4);
+        __m128 lo = _mm_unpacklo_ps(re, im);
+        __m128 hi = _mm_unpackhi_ps(re, im);
+        _mm_storel_pi((__m64*)(d0 + k * 2), lo);
+        _mm_storeh_pi((__m64*)(d1 + k * 2), lo);
+        _mm_storel_pi((__m64*)(d2 + k * 2), hi);
+        _mm_storeh_pi((__m64*)(d3 + k * 2), hi);
+    }
+}
+#endif /* __SSE__ */
+
+/**
+ * Get the scratch an rfft_batch() with the plan needs
+ *
+ * @param plan [in] Plan
+ *
+ * @returns Size of the scratch in bytes
+ */
+os_size_t fft::rfft_batch_scratch_size(const fft_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+
+    os_size_t size = rfft_scratch_size(plan);
+
+#if defined(__SSE__)
+    if (plan->simd_cfg != OS_NULL) {
+        os_size_t lanes = UAI_FFT_SIMD_FRAMES;
+        os_size_t packed_bytes = plan->nfft * lanes * sizeof(float);
+        os_size_t simd = fft_align_up(packed_bytes) +
+                         (plan->ncfft + 1) * lanes * sizeof(kiss_fft_cpx);
+        size = simd > size ? simd : size;
+    }
+#endif
+
+    return size;
+}
+
+/**
+ * Real FFT of many frames. With SSE, even sizes run UAI_FFT_SIMD_FRAMES
+ * frames in lock-step through a 4 lane kissfft, the frames left over run
+ * one by one. Results match rfft() to float rounding.
+ *
+ * @param plan    [in] Plan
+ * @param src     [in] frames rows of nfft real samples
+ * @param lds     [in] Distance in floats between two rows of src
+ * @param frames  [in] Number of frames
+ * @param out     [out] frames rows of nfft / 2 + 1 complex bins
+ * @param ldo     [in] Distance in bins between two rows of out
+ * @param scratch [in] rfft_batch_scratch_size() bytes, 16 byte aligned,
+ *                     may be OS_NULL if that is 0
+ *
+ * @returns 0 if OK
+ */
+int fft::rfft_batch(const fft_plan_t* plan,
+                    const float* src,
+                    os_size_t lds,
+                    os_size_t frames,
+                    kiss_fft_cpx* out,
+                    os_size_t ldo,
+                    void* scratch)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    os_size_t f = 0;
+
+#if defined(__SSE__)
+    if (plan->simd_cfg != OS_NULL && frames >= UAI_FFT_SIMD_FRAMES) {
+        os_size_t lanes = UAI_FFT_SIMD_FRAMES;
+        os_size_t packed_bytes = plan->nfft * lanes * sizeof(float);
+        float* packed = (float*)scratch;
+        float* bins = (float*)((char*)scratch + fft_align_up(packed_bytes));
+
+        NUMDL_ASSERT(scratch != OS_NULL);
+        NUMDL_ASSERT(0 == ((os_size_t)scratch & 15));
+
+        for (; f + lanes <= frames; f += lanes) {
+            fft_simd_pack(src + f * lds, lds, plan->nfft, packed);
+            uai_fft_simd_rfft(plan->simd_cfg,
+                              (const float*)plan->super_twiddles,
+                              packed,
+                              bins);
+            fft_simd_unpack(bins, plan->ncfft + 1, out + f * ldo, ldo);
+        }
+    }
+#endif
+
+    for (; f < frames; f++) {
+        int ret = rfft(plan, src + f * lds, out + f * ldo, scratch);
+        if (ret != NUMDL_EOK) {
+            return ret;
+        }
+    }
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Get the scratch an irfft() with the plan needs
+ *
+ * @param plan [in] Plan
+ *
+ * @returns Size of the scratch in bytes
+ */
+os_size_t fft::irfft_scratch_size(const fft_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+
+    if (FFT_BACKEND_CMSIS == plan->backend) {
+        return plan->nfft * sizeof(float);
+    }
+    if (plan->nfft % 2 == 0) {
+        os_size_t work = plan->n1 > 0 ? 2 * fft_four_step_work(plan) : 0;
+        return (plan->ncfft + work) * sizeof(kiss_fft_cpx);
+    }
+    return 2 * plan->nfft * sizeof(kiss_fft_cpx);
+}
+
+/**
+ * Inverse of rfft(): nfft real samples from nfft / 2 + 1 bins, scaled by
+ * 1 / nfft so that irfft(rfft(x)) == x. Even sizes merge the bins like
+ * kiss_fftri, then run the plan's forward FFT on the conjugate, which
+ * equals the inverse FFT and keeps the plan shareable between threads.
+ * No heap call is made.
+ *
+ * @param plan    [in] Plan
+ * @param src     [in] nfft / 2 + 1 complex bins, the imaginary parts of
+ *                     bin 0 and of the Nyquist bin are ignored
+ * @param out     [out] nfft real samples
+ * @param scratch [in] irfft_scratch_size() bytes aligned for floats
+ *
+ * @returns 0 if OK
+ */
+int fft::irfft(const fft_plan_t* plan,
+               const kiss_fft_cpx* src,
+               float* out,
+               void* scratch)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+    NUMDL_ASSERT(scratch != OS_NULL);
+
+    os_size_t nfft = plan->nfft;
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+    if (FFT_BACKEND_CMSIS == plan->backend) {
+        /* Pack like the forward output, the inverse scales by 1 / nfft */
+        float* packed = (float*)scratch;
+        packed[0] = src[0].r;
+        packed[1] = src[nfft / 2].r;
+        memcpy(packed + 2, src + 1, (nfft - 2) * sizeof(float));
+        arm_rfft_fast_f32(&plan->cmsis, packed, out, 1);
+        return NUMDL_EOK;
+    }
+#endif
+
+    float scale = 1.0f / nfft;
+    kiss_fft_cpx* buf = (kiss_fft_cpx*)scratch;
+
+    if (nfft % 2 == 1) {
+        /* Rebuild the hermitian spectrum, conjugated */
+        for (os_size_t k = 0; k <= nfft / 2; k++) {
+            buf[k].r = src[k].r;
+            buf[k].i = k > 0 ? -src[k].i : 0;
+        }
+        for (os_size_t k = nfft / 2 + 1; k < nfft; k++) {
+            buf[k] = src[nfft - k];
+        }
+        kiss_fft(plan->cfg, buf, buf + nfft);
+        for (os_size_t i = 0; i < nfft; i++) {
+            out[i] = buf[nfft + i].r * scale;
+        }
+        return NUMDL_EOK;
+    }
+
+    /* kiss_fftri with the inverse twiddles written as conjugates */
+    os_size_t ncfft = plan->ncfft;
+
+    buf[0].r = src[0].r + src[ncfft].r;
+    buf[0].i = -(src[0].r - src[ncfft].r);
+
+    for (os_size_t k = 1; k <= ncfft / 2; k++) {
+        kiss_fft_cpx fk = src[k];
+        kiss_fft_cpx fnkc;
+        fnkc.r = src[ncfft - k].r;
+        fnkc.i = -src[ncfft - k].i;
+
+        kiss_fft_cpx fek, tmp, fok;
+        fek.r = fk.r + fnkc.r;
+        fek.i = fk.i + fnkc.i;
+        tmp.r = fk.r - fnkc.r;
+        tmp.i = fk.i - fnkc.i;
+
+        const kiss_fft_cpx& st = plan->super_twiddles[k - 1];
+        fok.r = tmp.r * st.r + tmp.i * st.i;
+        fok.i = tmp.i * st.r - tmp.r * st.i;
+
+        /* buf[k] = conj(fek + fok), buf[ncfft - k] = fek - fok */
+        buf[k].r = fek.r + fok.r;
+        buf[k].i = -(fek.i + fok.i);
+        buf[ncfft - k].r = fek.r - fok.r;
+        buf[ncfft - k].i = fek.i - fok.i;
+    }
+
+    kiss_fft_cpx* time = (kiss_fft_cpx*)out;
+    int ret = fft_complex(plan, buf, time, buf + ncfft);
+    if (ret != NUMDL_EOK) {
+        return ret;
+    }
+
+    for (os_size_t i = 0; i < ncfft; i++) {
+        time[i].r = time[i].r * scale;
+        time[i].i = -time[i].i * scale;
+    }
+
+    return NUMDL_EOK;
+}
+
+struct fft_q31_plan
+{
+    os_size_t nfft;
+    void* cfg;
+};
+
+/**
+ * Create a fixed-point real FFT plan
+ *
+ * @param nfft [in] Number of real input samples, even
+ *
+ * @returns Plan, OS_NULL on failure
+ */
+fft_q31_plan_t* fft::q31_plan_create(os_size_t nfft)
+{
+    if (nfft < 2 || nfft % 2 != 0) {
+        ERROR("Invalid q31 fft size(%d), should be even.", (int)nfft);
+        return OS_NULL;
+    }
+
+    os_size_t head = fft_align_up(sizeof(fft_q31_plan));
+    char* mem = (char*)uai_mat_aligned_alloc(head + uai_fft_q31_cfg_size(nfft));
+    if (OS_NULL == mem) {
+        ERROR("Allocate q31 fft plan of size %d error.", (int)nfft);
+        return OS_NULL;
+    }
+
+    fft_q31_plan* plan = (fft_q31_plan*)mem;
+    plan->nfft = nfft;
+    plan->cfg = uai_fft_q31_cfg_init(nfft, mem + head);
+    NUMDL_ASSERT(plan->cfg != OS_NULL);
+
+    return plan;
+}
+
+/**
+ * Destroy a plan made by q31_plan_create()
+ *
+ * @param plan [in] Plan, OS_NULL is ignored
+ */
+void fft::q31_plan_destroy(fft_q31_plan_t* plan)
+{
+    if (plan != OS_NULL) {
+        uai_mat_aligned_free(plan);
+    }
+}
+
+/**
+ * Get the scratch an rfft_q31() or power_q31() with the plan needs
+ *
+ * @param plan [in] Plan
+ *
+ * @returns Size of the scratch in bytes
+ */
+os_size_t fft::rfft_q31_scratch_size(const fft_q31_plan_t* plan)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+
+    /* Scaled samples, then the bins power_q31() squares */
+    return (2 * plan->nfft + 2) * sizeof(os_int32_t);
+}
+
+/* Block floating point: shift the samples up to one bit below full scale,
+ * the spare bit keeps the packed (even, odd) pairs of kissfft from
+ * overflowing. Returns the shift beyond the plain int16 to q30 one. */
+static int fft_q31_load(const os_int16_t* src,
+                        os_size_t src_len,
+                        os_size_t nfft,
+                        os_int32_t* dst)
+{
+    os_size_t len = src_len < nfft ? src_len : nfft;
+    os_int32_t peak = 0;
+    int shift = 0;
+
+    for (os_size_t i = 0; i < len; i++) {
+        os_int32_t v = src[i] < 0 ? -(os_int32_t)src[i] : src[i];
+        peak = v > peak ? v : peak;
+    }
+    while (shift < 15 && (peak << (shift + 1)) <= 32767) {
+        shift++;
+    }
+
+    for (os_size_t i = 0; i < len; i++) {
+        dst[i] = (os_int32_t)((os_uint32_t)(os_int32_t)src[i]
+                              << (15 + shift));
+    }
+    for (os_size_t i = len; i < nfft; i++) {
+        dst[i] = 0;
+    }
+
+    return shift;
+}
+
+/**
+ * Fixed-point real FFT of int16 samples with block scaling. The samples
+ * are shifted up by the headroom of the block, which is reported, then run
+ * through a q31 kissfft that halves at every stage:
+ *     out[k] = X[k] / (nfft * 32768) * 2^shift, in q30
+ * where X is the DFT of the int16 samples. The input is cropped or zero
+ * padded to nfft samples. No heap call and no float operation is made.
+ *
+ * @param plan    [in] Plan
+ * @param src     [in] int16 samples
+ * @param src_len [in] Number of samples
+ * @param out     [out] nfft / 2 + 1 bins of (re, im)
+ * @param shift   [out] Block exponent of the bins, 0 ~ 15
+ * @param scratch [in] rfft_q31_scratch_size() bytes aligned for int32
+ *
+ * @returns 0 if OK
+ */
+int fft::rfft_q31(const fft_q31_plan_t* plan,
+                  const os_int16_t* src,
+                  os_size_t src_len,
+                  os_int32_t* out,
+                  int* shift,
+                  void* scratch)
+{
+    NUMDL_ASSERT(plan != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+    NUMDL_ASSERT(shift != OS_NULL);
+    NUMDL_ASSERT(scratch != OS_NULL);
+
+    os_int32_t* samples = (os_int32_t*)scratch;
+
+    *shift = fft_q31_load(src, src_len, plan->nfft, samples);
+    uai_fft_q31_rfft(plan->cfg, samples, out);
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Power spectrum of int16 samples in fixed point, see rfft_q31():
+ *     out[k] = |X[k] / (nfft * 32768)|^2 * 2^(2 * shift), in q31
+ * saturated to INT32_MAX, which only a full scale DC block reaches.
+ *
+ * @param plan    [in] Plan
+ * @param src     [in] int16 samples
+ * @param src_len [in] Number of samples
+ * @param out     [out] nfft / 2 + 1 powers
+ * @param shift   [out] Block exponent of the bins, 0 ~ 15
+ * @param scratch [in] rfft_q31_scratch_size() bytes aligned for int32
+ *
+ * @returns 0 if OK
+ */
+int fft::power_q31(const fft_q31_plan_t* plan,
+                   const os_int16_t* src,
+                   os_size_t src_len,
+                   os_int32_t* out,
+                   int* shift,
+                   void* scratch)
+{
+    NUMDL_ASSERT(out != OS_NULL);
+
+    os_size_t bins = plan->nfft / 2 + 1;
+    os_int32_t* cpx = (os_int32_t*)scratch + plan->nfft;
+
+    int ret = rfft_q31(plan, src, src_len, cpx, shift, scratch);
+    if (ret != NUMDL_EOK) {
+        return ret;
+    }
+
+    /* q30 * q30 is q60, back to q31 */
+    for (os_size_t k = 0; k < bins; k++) {
+        os_int64_t re = cpx[2 * k];
+        os_int64_t im = cpx[2 * k + 1];
+        os_int64_t p = (re * re + im * im) >> 29;
+        out[k] = p > 0x7fffffff ? 0x7fffffff : (os_int32_t)p;
+    }
+
+    return NUMDL_EOK;
+}
+
+struct fft_ola
+{
+    fft_plan_t* plan;
+    os_size_t hop;
+    const float* window;
+    float* acc;   /* nfft samples, the first hop are due next */
+    float* frame; /* nfft samples */
+    void* scratch;
+};
+
+/**
+ * Create an overlap-add synthesiser. The plan comes from the cache and is
+ * held until ola_destroy().
+ *
+ * @param nfft   [in] Frame length, also the FFT size
+ * @param hop    [in] Samples between two frames, 1 ~ nfft
+ * @param window [in] nfft synthesis window samples, kept by reference, or
+ *                    OS_NULL for none
+ *
+ * @returns Synthesiser, OS_NULL on failure
+ */
+fft_ola_t* fft::ola_create(os_size_t nfft, os_size_t hop, const float* window)
+{
+    if (hop < 1 || hop > nfft) {
+        ERROR("Invalid hop(%d) for frames of %d.", (int)hop, (int)nfft);
+        return OS_NULL;
+    }
+
+    fft_plan_t* plan = plan_get(nfft);
+    if (OS_NULL == plan) {
+        return OS_NULL;
+    }
+
+    os_size_t head = fft_align_up(sizeof(fft_ola));
+    os_size_t frame_bytes = fft_align_up(nfft * sizeof(float));
+    os_size_t bytes = head + 2 * frame_bytes + irfft_scratch_size(plan);
+
+    char* mem = (char*)uai_mat_aligned_alloc(bytes);
+    if (OS_NULL == mem) {
+        ERROR("Allocate overlap-add state error.");
+        plan_put(plan);
+        return OS_NULL;
+    }
+
+    fft_ola* ola = (fft_ola*)mem;
+    ola->plan = plan;
+    ola->hop = hop;
+    ola->window = window;
+    ola->acc = (float*)(mem + head);
+    ola->frame = (float*)(mem + head + frame_bytes);
+    ola->scratch = mem + head + 2 * frame_bytes;
+
+    ola_reset(ola);
+    return ola;
+}
+
+/**
+ * Destroy a synthesiser made by ola_create()
+ *
+ * @param ola [in] Synthesiser, OS_NULL is ignored
+ */
+void fft::ola_destroy(fft_ola_t* ola)
+{
+    if (ola != OS_NULL) {
+        plan_put(ola->plan);
+        uai_mat_aligned_free(ola);
+    }
+}
+
+/**
+ * Drop the tail kept from the previous frames, e.g. between two streams
+ *
+ * @param ola [in] Synthesiser
+ */
+void fft::ola_reset(fft_ola_t* ola)
+{
+    NUMDL_ASSERT(ola != OS_NULL);
+
+    memset(ola->acc, 0, ola->plan->nfft * sizeof(float));
+}
+
+/**
+ * Add the inverse FFT of one frame, windowed, to the tail and emit the hop
+ * samples no later frame overlaps
+ *
+ * @param ola [in] Synthesiser
+ * @param src [in] nfft / 2 + 1 bins of the frame
+ * @param out [out] hop samples
+ *
+ * @returns 0 if OK
+ */
+int fft::ola_synth(fft_ola_t* ola, const kiss_fft_cpx* src, float* out)
+{
+    NUMDL_ASSERT(ola != OS_NULL);
+    NUMDL_ASSERT(out != OS_NULL);
+
+    os_size_t nfft = ola->plan->nfft;
+    os_size_t hop = ola->hop;
+    float* acc = ola->acc;
+    float* frame = ola->frame;
+
+    int ret = irfft(ola->plan, src, frame, ola->scratch);
+    if (ret != NUMDL_EOK) {
+        return ret;
+    }
+
+    if (ola->window != OS_NULL) {
+        for (os_size_t i = 0; i < nfft; i++) {
+            acc[i] += frame[i] * ola->window[i];
+        }
+    } else {
+        for (os_size_t i = 0; i < nfft; i++) {
+            acc[i] += frame[i];
+        }
+    }
+
+    memcpy(out, acc, hop * sizeof(float));
+    memmove(acc, acc + hop, (nfft - hop) * sizeof(float));
+    memset(acc + nfft - hop, 0, hop * sizeof(float));
+
+    return NUMDL_EOK;
+}
+
+};  // namespace feature
+};  // namespace uai
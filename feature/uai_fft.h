@@ -0,0 +1,192 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_fft.h
+ *
+ * @brief       Reusable real FFT plans and a bounded, thread safe plan cache
+ *              keyed by the transform size.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#ifndef __UAI_FFT_H__
+#define __UAI_FFT_H__
+
+#include <kiss_fft.h>
+#include <os_stddef.h>
+
+/** Most plans the cache keeps, plans in use are never evicted */
+#ifndef NUMDL_FFT_CACHE_PLANS
+#define NUMDL_FFT_CACHE_PLANS (8)
+#endif
+
+/** Most bytes of twiddles and factors the cache keeps */
+#ifndef NUMDL_FFT_CACHE_BYTES
+#define NUMDL_FFT_CACHE_BYTES (64 * 1024)
+#endif
+
+/** Frame matrices with fewer rows * fft_len samples stay on one thread */
+#ifndef NUMDL_FFT_PARALLEL_MIN
+#define NUMDL_FFT_PARALLEL_MIN (64 * 512)
+#endif
+
+/**
+ * Backend new plans use until fft::set_backend() is called:
+ * 0 auto, 1 kissfft, 2 CMSIS-DSP. kissfft unless opted in, so defining
+ * UAI_CMSIS_DSP_USING_TRANSFORM alone does not move existing sizes over.
+ */
+#ifndef NUMDL_FFT_BACKEND
+#define NUMDL_FFT_BACKEND (1)
+#endif
+
+/** Sizes the auto backend hands to CMSIS, run the fft bench to tune them */
+#ifndef NUMDL_FFT_CMSIS_MIN
+#define NUMDL_FFT_CMSIS_MIN (32)
+#endif
+
+#ifndef NUMDL_FFT_CMSIS_MAX
+#define NUMDL_FFT_CMSIS_MAX (4096)
+#endif
+
+/** Real sizes from which the complex FFT runs as a four-step split */
+#ifndef NUMDL_FFT_FOUR_STEP_MIN
+#define NUMDL_FFT_FOUR_STEP_MIN (1 << 20)
+#endif
+
+/** Smallest factor a four-step split may have */
+#define UAI_FFT_FOUR_STEP_MIN_SPLIT (16)
+
+/** Square tile of the transposes of a four-step FFT */
+#define UAI_FFT_TILE (16)
+
+/** Bins a four-step FFT pads its work rows by, one cache line */
+#define UAI_FFT_FOUR_STEP_PAD (8)
+
+/** Rows a task of a frame matrix rfft pads and transforms at once */
+#define UAI_FFT_ROWS (16)
+
+/** Hash buckets of the plan cache */
+#define UAI_FFT_CACHE_BUCKETS (16)
+
+namespace uai {
+namespace feature {
+
+/**
+ * Library running the transforms of a plan. CMSIS-DSP needs
+ * UAI_CMSIS_DSP_USING_TRANSFORM and handles powers of two from 32 to 4096
+ * only. Auto takes CMSIS for those sizes within NUMDL_FFT_CMSIS_MIN ~
+ * NUMDL_FFT_CMSIS_MAX and kissfft for every other size.
+ */
+typedef enum fft_backend
+{
+    FFT_BACKEND_AUTO = 0,
+    FFT_BACKEND_KISSFFT,
+    FFT_BACKEND_CMSIS
+} fft_backend_t;
+
+/**
+ * Precomputed state of an nfft point real FFT. A plan is never written by a
+ * transform, so one plan may serve any number of threads at once.
+ */
+typedef struct fft_plan fft_plan_t;
+
+/**
+ * Fixed-point real FFT of int16 samples, even sizes only. No float
+ * operation runs from the samples to the power spectrum.
+ */
+typedef struct fft_q31_plan fft_q31_plan_t;
+
+/**
+ * Streaming overlap-add synthesis: every frame spectrum in, hop samples
+ * out. The tail of the previous frames is kept between calls and all
+ * memory is allocated once by ola_create().
+ */
+typedef struct fft_ola fft_ola_t;
+
+class fft
+{
+public:
+    static int set_backend(fft_backend_t backend);
+    static fft_backend_t get_backend(void);
+    static bool backend_supports(fft_backend_t backend, os_size_t nfft);
+
+    static fft_plan_t* plan_create(os_size_t nfft);
+    static fft_plan_t* plan_create(os_size_t nfft, fft_backend_t backend);
+    static void plan_destroy(fft_plan_t* plan);
+    static os_size_t plan_nfft(const fft_plan_t* plan);
+    static fft_backend_t plan_backend(const fft_plan_t* plan);
+
+    static fft_plan_t* plan_get(os_size_t nfft);
+    static void plan_put(fft_plan_t* plan);
+    static int cache_limit(os_size_t plans, os_size_t bytes);
+    static void cache_clear(void);
+
+    static os_size_t rfft_scratch_size(const fft_plan_t* plan);
+    static int rfft(const fft_plan_t* plan,
+                    const float* src,
+                    kiss_fft_cpx* out);
+    static int rfft(const fft_plan_t* plan,
+                    const float* src,
+                    kiss_fft_cpx* out,
+                    void* scratch);
+
+    static os_size_t rfft_batch_scratch_size(const fft_plan_t* plan);
+    static int rfft_batch(const fft_plan_t* plan,
+                          const float* src,
+                          os_size_t lds,
+                          os_size_t frames,
+                          kiss_fft_cpx* out,
+                          os_size_t ldo,
+                          void* scratch);
+
+    static os_size_t irfft_scratch_size(const fft_plan_t* plan);
+    static int irfft(const fft_plan_t* plan,
+                     const kiss_fft_cpx* src,
+                     float* out,
+                     void* scratch);
+
+    static fft_q31_plan_t* q31_plan_create(os_size_t nfft);
+    static void q31_plan_destroy(fft_q31_plan_t* plan);
+    static os_size_t rfft_q31_scratch_size(const fft_q31_plan_t* plan);
+    static int rfft_q31(const fft_q31_plan_t* plan,
+                        const os_int16_t* src,
+                        os_size_t src_len,
+                        os_int32_t* out,
+                        int* shift,
+                        void* scratch);
+    static int power_q31(const fft_q31_plan_t* plan,
+                         const os_int16_t* src,
+                         os_size_t src_len,
+                         os_int32_t* out,
+                         int* shift,
+                         void* scratch);
+
+    static fft_ola_t* ola_create(os_size_t nfft,
+                                 os_size_t hop,
+                                 const float* window);
+    static void ola_destroy(fft_ola_t* ola);
+    static void ola_reset(fft_ola_t* ola);
+    static int ola_synth(fft_ola_t* ola, const kiss_fft_cpx* src, float* out);
+};
+
+};  // namespace feature
+};  // namespace uai
+
+#endif /* __UAI_FFT_H__ */
@@ -0,0 +1,141 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_fft_q31.c
+ *
+ * @brief       kissfft built with FIXED_POINT=32, real FFT of q31 samples
+ *              without a float operation.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_fft_q31.h"
+
+/* A second copy of kissfft with int32_t scalars, renamed so it links next
+ * to the float build used everywhere else. Every butterfly divides by its
+ * radix, so the complex FFT of ncfft points comes out scaled by 1 / ncfft
+ * and cannot overflow. */
+#define FIXED_POINT             32
+#define kiss_fft_alloc          uai_fft_q31_kiss_alloc
+#define kiss_fft                uai_fft_q31_kiss
+#define kiss_fft_stride         uai_fft_q31_kiss_stride
+#define kiss_fft_cleanup        uai_fft_q31_kiss_cleanup
+#define kiss_fft_next_fast_size uai_fft_q31_kiss_next_fast_size
+#include <kiss_fft.c>
+
+/* The super twiddles of the real split follow the complex state */
+static os_size_t uai_fft_q31_kiss_size(os_size_t ncfft)
+{
+    size_t bytes = 0;
+
+    uai_fft_q31_kiss_alloc((int)ncfft, 0, OS_NULL, &bytes);
+    return (bytes + 15) & ~(size_t)15;
+}
+
+/**
+ * Get the bytes of a q31 real FFT state
+ *
+ * @param nfft [in] Number of real samples, even
+ *
+ * @returns Size in bytes
+ */
+os_size_t uai_fft_q31_cfg_size(os_size_t nfft)
+{
+    os_size_t ncfft = nfft / 2;
+
+    return uai_fft_q31_kiss_size(ncfft) + ncfft / 2 * sizeof(kiss_fft_cpx);
+}
+
+/**
+ * Build a q31 real FFT state in place
+ *
+ * @param nfft [in] Number of real samples, even
+ * @param mem  [in] uai_fft_q31_cfg_size() bytes, 8 byte aligned
+ *
+ * @returns The state, at mem
+ */
+void* uai_fft_q31_cfg_init(os_size_t nfft, void* mem)
+{
+    os_size_t ncfft = nfft / 2;
+    size_t bytes = uai_fft_q31_kiss_size(ncfft);
+    kiss_fft_cpx* super_twiddles =
+        (kiss_fft_cpx*)((char*)mem + uai_fft_q31_kiss_size(ncfft));
+    os_size_t i;
+
+    kiss_fft_cfg st = uai_fft_q31_kiss_alloc((int)ncfft, 0, mem, &bytes);
+
+    for (i = 0; i < ncfft / 2; i++) {
+        double phase = -3.14159265358979323846 * ((double)(i + 1) / ncfft + .5);
+        kf_cexp(super_twiddles + i, phase);
+    }
+
+    return st;
+}
+
+/**
+ * Real FFT of nfft q31 samples, same split as kiss_fftr with FIXED_POINT.
+ * The bins come out scaled by 1 / nfft. Many threads may share one state.
+ *
+ * @param cfg [in] State built by uai_fft_q31_cfg_init()
+ * @param src [in] nfft samples, 8 byte aligned
+ * @param out [out] nfft / 2 + 1 bins of (re, im), 8 byte aligned
+ */
+void uai_fft_q31_rfft(const void* cfg,
+                      const os_int32_t* src,
+                      os_int32_t* out)
+{
+    kiss_fft_cfg st = (kiss_fft_cfg)cfg;
+    kiss_fft_cpx* freq = (kiss_fft_cpx*)out;
+    int ncfft = st->nfft;
+    const kiss_fft_cpx* super_twiddles =
+        (const kiss_fft_cpx*)((const char*)cfg +
+                              uai_fft_q31_kiss_size((os_size_t)ncfft));
+    int k;
+
+    /* Input and output differ, so kissfft needs no scratch of its own */
+    uai_fft_q31_kiss(st, (const kiss_fft_cpx*)src, freq);
+
+    kiss_fft_cpx tdc = freq[0];
+    C_FIXDIV(tdc, 2);
+    freq[0].r = tdc.r + tdc.i;
+    freq[ncfft].r = tdc.r - tdc.i;
+    freq[0].i = 0;
+    freq[ncfft].i = 0;
+
+    for (k = 1; k <= ncfft / 2; k++) {
+        kiss_fft_cpx fpk = freq[k];
+        kiss_fft_cpx fpnk;
+        kiss_fft_cpx f1k, f2k, tw;
+
+        fpnk.r = freq[ncfft - k].r;
+        fpnk.i = -freq[ncfft - k].i;
+        C_FIXDIV(fpk, 2);
+        C_FIXDIV(fpnk, 2);
+
+        C_ADD(f1k, fpk, fpnk);
+        C_SUB(f2k, fpk, fpnk);
+        C_MUL(tw, f2k, super_twiddles[k - 1]);
+
+        freq[k].r = HALF_OF(f1k.r + tw.r);
+        freq[k].i = HALF_OF(f1k.i + tw.i);
+        freq[ncfft - k].r = HALF_OF(f1k.r - tw.r);
+        freq[ncfft - k].i = HALF_OF(tw.i - f1k.i);
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_fft_q31.h
+ *
+ * @brief       kissfft built with FIXED_POINT=32, real FFT of q31 samples
+ *              without a float operation.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#ifndef __UAI_FFT_Q31_H__
+#define __UAI_FFT_Q31_H__
+
+#include <os_stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+os_size_t uai_fft_q31_cfg_size(os_size_t nfft);
+void* uai_fft_q31_cfg_init(os_size_t nfft, void* mem);
+
+void uai_fft_q31_rfft(const void* cfg,
+                      const os_int32_t* src,
+                      os_int32_t* out);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __UAI_FFT_Q31_H__ */
@@ -0,0 +1,123 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_fft_simd.c
+ *
+ * @brief       kissfft built with USE_SIMD, runs the FFTs of 4 frames in
+ *              lock-step, one frame per SSE lane.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_fft_simd.h"
+
+#if defined(__SSE__)
+
+/* A second copy of kissfft with __m128 scalars, renamed so it links next to
+ * the float build used everywhere else. See library/kissfft/README.simd. */
+#define USE_SIMD
+#define kiss_fft_alloc          uai_fft_simd_kiss_alloc
+#define kiss_fft                uai_fft_simd_kiss
+#define kiss_fft_stride         uai_fft_simd_kiss_stride
+#define kiss_fft_cleanup        uai_fft_simd_kiss_cleanup
+#define kiss_fft_next_fast_size uai_fft_simd_kiss_next_fast_size
+#include <kiss_fft.c>
+
+/**
+ * Get the bytes of a 4 lane kissfft state
+ *
+ * @param ncfft [in] Points of the complex FFT
+ *
+ * @returns Size in bytes
+ */
+os_size_t uai_fft_simd_cfg_size(os_size_t ncfft)
+{
+    size_t bytes = 0;
+
+    uai_fft_simd_kiss_alloc((int)ncfft, 0, OS_NULL, &bytes);
+    return bytes;
+}
+
+/**
+ * Build a 4 lane kissfft state in place
+ *
+ * @param ncfft [in] Points of the complex FFT
+ * @param mem   [in] uai_fft_simd_cfg_size() bytes, 16 byte aligned
+ *
+ * @returns The state, at mem
+ */
+void* uai_fft_simd_cfg_init(os_size_t ncfft, void* mem)
+{
+    size_t bytes = uai_fft_simd_cfg_size(ncfft);
+
+    return uai_fft_simd_kiss_alloc((int)ncfft, 0, mem, &bytes);
+}
+
+/**
+ * Real FFT of 4 frames of 2 * ncfft samples at once. Same split as
+ * kiss_fftr, done in place on the output of the complex FFT.
+ *
+ * @param cfg            [in] State built by uai_fft_simd_cfg_init()
+ * @param super_twiddles [in] ncfft / 2 (re, im) pairs of the real split
+ * @param src            [in] 2 * ncfft groups of 4 samples, sample i of
+ *                            frame f at src[i * 4 + f], 16 byte aligned
+ * @param out            [out] ncfft + 1 bins of 4 real parts then 4
+ *                             imaginary parts, 16 byte aligned
+ */
+void uai_fft_simd_rfft(const void* cfg,
+                       const float* super_twiddles,
+                       const float* src,
+                       float* out)
+{
+    kiss_fft_cfg st = (kiss_fft_cfg)cfg;
+    kiss_fft_cpx* freq = (kiss_fft_cpx*)out;
+    int ncfft = st->nfft;
+    int k;
+
+    uai_fft_simd_kiss(st, (const kiss_fft_cpx*)src, freq);
+
+    kiss_fft_cpx tdc = freq[0];
+    freq[0].r = tdc.r + tdc.i;
+    freq[ncfft].r = tdc.r - tdc.i;
+    freq[0].i = _mm_setzero_ps();
+    freq[ncfft].i = _mm_setzero_ps();
+
+    for (k = 1; k <= ncfft / 2; k++) {
+        kiss_fft_cpx fpk = freq[k];
+        kiss_fft_cpx fpnk;
+        kiss_fft_cpx f1k, f2k, tw, twiddle;
+
+        fpnk.r = freq[ncfft - k].r;
+        fpnk.i = _mm_setzero_ps() - freq[ncfft - k].i;
+        twiddle.r = _mm_set1_ps(super_twiddles[2 * (k - 1)]);
+        twiddle.i = _mm_set1_ps(super_twiddles[2 * (k - 1) + 1]);
+
+        C_ADD(f1k, fpk, fpnk);
+        C_SUB(f2k, fpk, fpnk);
+        C_MUL(tw, f2k, twiddle);
+
+        freq[k].r = HALF_OF(f1k.r + tw.r);
+        freq[k].i = HALF_OF(f1k.i + tw.i);
+        freq[ncfft - k].r = HALF_OF(f1k.r - tw.r);
+        freq[ncfft - k].i = HALF_OF(tw.i - f1k.i);
+    }
+}
+
+#endif /* __SSE__ */
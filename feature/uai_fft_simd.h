@@ -0,0 +1,57 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_fft_simd.h
+ *
+ * @brief       kissfft built with USE_SIMD, runs the FFTs of 4 frames in
+ *              lock-step, one frame per SSE lane.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#ifndef __UAI_FFT_SIMD_H__
+#define __UAI_FFT_SIMD_H__
+
+#include <os_stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** Frames transformed by one call, the lanes of kissfft's __m128 scalar */
+#define UAI_FFT_SIMD_FRAMES (4)
+
+#if defined(__SSE__)
+
+os_size_t uai_fft_simd_cfg_size(os_size_t ncfft);
+void* uai_fft_simd_cfg_init(os_size_t ncfft, void* mem);
+
+void uai_fft_simd_rfft(const void* cfg,
+                       const float* super_twiddles,
+                       const float* src,
+                       float* out);
+
+#endif /* __SSE__ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __UAI_FFT_SIMD_H__ */
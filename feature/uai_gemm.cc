@@ -0,0 +1,1009 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ * @file        uai_gemm.cc
+ *
+ * @brief       GotoBLAS style GEMM: B is packed into KC x NC panels, A into
+ *              MC x KC panels, and a MR x NR micro-kernel accumulates in
+ *              registers.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_gemm.h"
+#include "uai_thread_pool.h"
+#include "uai_matrix.h"
+#include "nd_errno.h"
+
+#define NUMDL_LOG_TAG "uai.gemm"
+#include "nd_log.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <nd_assert.h>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace uai {
+namespace feature {
+
+/**
+ * Pack a mc x kc block of A into MR-row slivers, zero padding the last one.
+ * Sliver layout is kc columns of MR contiguous values.
+ */
+static void gemm_pack_a(os_size_t mc,
+                        os_size_t kc,
+                        const float* a,
+                        os_size_t rsa,
+                        os_size_t csa,
+                        float* ap)
+{
+    for (os_size_t ir = 0; ir < mc; ir += UAI_GEMM_MR) {
+        os_size_t mr = mc - ir < UAI_GEMM_MR ? mc - ir : UAI_GEMM_MR;
+        const float* src = a + ir * rsa;
+
+        for (os_size_t p = 0; p < kc; p++) {
+            os_size_t i = 0;
+            for (; i < mr; i++) {
+                ap[i] = src[i * rsa + p * csa];
+            }
+            for (; i < UAI_GEMM_MR; i++) {
+                ap[i] = 0.0f;
+            }
+            ap += UAI_GEMM_MR;
+        }
+    }
+}
+
+/**
+ * Pack a kc x nc block of B into NR-column slivers, zero padding the last one.
+ * Sliver layout is kc rows of NR contiguous values.
+ */
+static void gemm_pack_b(os_size_t kc,
+                        os_size_t nc,
+                        const float* b,
+                        os_size_t rsb,
+                        os_size_t csb,
+                        float* bp)
+{
+    for (os_size_t jr = 0; jr < nc; jr += UAI_GEMM_NR) {
+        os_size_t nr = nc - jr < UAI_GEMM_NR ? nc - jr : UAI_GEMM_NR;
+        const float* src = b + jr * csb;
+
+        if (nr == UAI_GEMM_NR && csb == 1) {
+            for (os_size_t p = 0; p < kc; p++) {
+                memcpy(bp, src + p * rsb, UAI_GEMM_NR * sizeof(float));
+                bp += UAI_GEMM_NR;
+            }
+            continue;
+        }
+
+        for (os_size_t p = 0; p < kc; p++) {
+            os_size_t j = 0;
+            for (; j < nr; j++) {
+                bp[j] = src[p * rsb + j * csb];
+            }
+            for (; j < UAI_GEMM_NR; j++) {
+                bp[j] = 0.0f;
+            }
+            bp += UAI_GEMM_NR;
+        }
+    }
+}
+
+/**
+ * Apply the epilogue to n contiguous results of one output row, col is the
+ * output column of the first one. Each stage is its own loop so the compiler
+ * can vectorise it.
+ */
+static void gemm_epilogue_row(const gemm_epilogue_t* ep,
+                              float* v,
+                              os_size_t n,
+                              os_size_t col)
+{
+    if (ep->scale != 1.0f) {
+        for (os_size_t j = 0; j < n; j++) {
+            v[j] *= ep->scale;
+        }
+    }
+
+    if (ep->bias != OS_NULL) {
+        const float* bias = ep->bias + col;
+        for (os_size_t j = 0; j < n; j++) {
+            v[j] += bias[j];
+        }
+    }
+
+    switch (ep->act) {
+    case GEMM_ACT_RELU:
+        for (os_size_t j = 0; j < n; j++) {
+            v[j] = v[j] < 0.0f ? 0.0f : v[j];
+        }
+        break;
+    case GEMM_ACT_SIGMOID:
+        for (os_size_t j = 0; j < n; j++) {
+            v[j] = 1.0f / (1.0f + expf(-v[j]));
+        }
+        break;
+    case GEMM_ACT_TANH:
+        for (os_size_t j = 0; j < n; j++) {
+            v[j] = tanhf(v[j]);
+        }
+        break;
+    default:
+        break;
+    }
+
+    switch (ep->log) {
+    case GEMM_LOG_E:
+        for (os_size_t j = 0; j < n; j++) {
+            v[j] = logf(v[j] < ep->log_floor ? ep->log_floor : v[j]);
+        }
+        break;
+    case GEMM_LOG_10:
+        for (os_size_t j = 0; j < n; j++) {
+            v[j] = log10f(v[j] < ep->log_floor ? ep->log_floor : v[j]);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * MR x NR micro-kernel. The accumulation order is the same on every path, so
+ * the SIMD and the portable kernels agree up to rounding: a compiler that
+ * contracts a * b + c into FMA (-mfma, ARM VFMA) rounds them differently.
+ *
+ * @param accumulate [in] Add to C instead of overwriting it
+ * @param ep         [in] Epilogue for the last K panel, or OS_NULL
+ * @param col        [in] Output column of the tile, indexes the bias
+ */
+static void gemm_micro_kernel(os_size_t kc,
+                              const float* ap,
+                              const float* bp,
+                              float* c,
+                              os_size_t rsc,
+                              os_size_t csc,
+                              os_size_t mr,
+                              os_size_t nr,
+                              bool accumulate,
+                              const gemm_epilogue_t* ep,
+                              os_size_t col)
+{
+    float acc[UAI_GEMM_MR][UAI_GEMM_NR];
+
+#if defined(__SSE__)
+    __m128 c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps();
+    __m128 c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+    __m128 c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps();
+    __m128 c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+
+    for (os_size_t p = 0; p < kc; p++) {
+        __m128 b0 = _mm_load_ps(bp);
+        __m128 b1 = _mm_load_ps(bp + 4);
+        __m128 a;
+
+        a = _mm_set1_ps(ap[0]);
+        c00 = _mm_add_ps(c00, _mm_mul_ps(a, b0));
+        c01 = _mm_add_ps(c01, _mm_mul_ps(a, b1));
+        a = _mm_set1_ps(ap[1]);
+        c10 = _mm_add_ps(c10, _mm_mul_ps(a, b0));
+        c11 = _mm_add_ps(c11, _mm_mul_ps(a, b1));
+        a = _mm_set1_ps(ap[2]);
+        c20 = _mm_add_ps(c20, _mm_mul_ps(a, b0));
+        c21 = _mm_add_ps(c21, _mm_mul_ps(a, b1));
+        a = _mm_set1_ps(ap[3]);
+        c30 = _mm_add_ps(c30, _mm_mul_ps(a, b0));
+        c31 = _mm_add_ps(c31, _mm_mul_ps(a, b1));
+
+        ap += UAI_GEMM_MR;
+        bp += UAI_GEMM_NR;
+    }
+
+    _mm_storeu_ps(&acc[0][0], c00);
+    _mm_storeu_ps(&acc[0][4], c01);
+    _mm_storeu_ps(&acc[1][0], c10);
+    _mm_storeu_ps(&acc[1][4], c11);
+    _mm_storeu_ps(&acc[2][0], c20);
+    _mm_storeu_ps(&acc[2][4], c21);
+    _mm_storeu_ps(&acc[3][0], c30);
+    _mm_storeu_ps(&acc[3][4], c31);
+#else
+    for (os_size_t i = 0; i < UAI_GEMM_MR; i++) {
+        for (os_size_t j = 0; j < UAI_GEMM_NR; j++) {
+            acc[i][j] = 0.0f;
+        }
+    }
+
+    for (os_size_t p = 0; p < kc; p++) {
+        for (os_size_t i = 0; i < UAI_GEMM_MR; i++) {
+            float a = ap[i];
+            for (os_size_t j = 0; j < UAI_GEMM_NR; j++) {
+                acc[i][j] += a * bp[j];
+            }
+        }
+        ap += UAI_GEMM_MR;
+        bp += UAI_GEMM_NR;
+    }
+#endif
+
+    for (os_size_t i = 0; i < mr; i++) {
+        float* row = c + i * rsc;
+        if (accumulate) {
+            for (os_size_t j = 0; j < nr; j++) {
+                acc[i][j] = row[j * csc] + acc[i][j];
+            }
+        }
+        if (ep != OS_NULL) {
+            gemm_epilogue_row(ep, acc[i], nr, col);
+        }
+        for (os_size_t j = 0; j < nr; j++) {
+            row[j * csc] = acc[i][j];
+        }
+    }
+}
+
+static int gemm_serial(os_size_t m,
+                       os_size_t n,
+                       os_size_t k,
+                       const float* a,
+                       os_size_t rsa,
+                       os_size_t csa,
+                       const float* b,
+                       os_size_t rsb,
+                       os_size_t csb,
+                       float* c,
+                       os_size_t rsc,
+                       os_size_t csc,
+                       const gemm_epilogue_t* ep)
+{
+    if (0 == k) {
+        for (os_size_t i = 0; i < m; i++) {
+            for (os_size_t j = 0; j < n; j++) {
+                float v = 0.0f;
+                if (ep != OS_NULL) {
+                    gemm_epilogue_row(ep, &v, 1, j);
+                }
+                c[i * rsc + j * csc] = v;
+            }
+        }
+        return NUMDL_EOK;
+    }
+
+    os_size_t kc_max = k < NUMDL_GEMM_KC ? k : NUMDL_GEMM_KC;
+    os_size_t mc_max = m < NUMDL_GEMM_MC ? m : NUMDL_GEMM_MC;
+    os_size_t nc_max = n < NUMDL_GEMM_NC ? n : NUMDL_GEMM_NC;
+
+    mc_max = (mc_max + UAI_GEMM_MR - 1) / UAI_GEMM_MR * UAI_GEMM_MR;
+    nc_max = (nc_max + UAI_GEMM_NR - 1) / UAI_GEMM_NR * UAI_GEMM_NR;
+
+    float* ap = (float*)uai_mat_aligned_alloc(mc_max * kc_max * sizeof(float));
+    float* bp = (float*)uai_mat_aligned_alloc(kc_max * nc_max * sizeof(float));
+    if (OS_NULL == ap || OS_NULL == bp) {
+        ERROR("Alloc gemm pack buffers failed, no enough memory.");
+        uai_mat_aligned_free(ap);
+        uai_mat_aligned_free(bp);
+        return NUMDL_ENOMEM;
+    }
+
+    for (os_size_t jc = 0; jc < n; jc += NUMDL_GEMM_NC) {
+        os_size_t nc = n - jc < NUMDL_GEMM_NC ? n - jc : NUMDL_GEMM_NC;
+
+        for (os_size_t pc = 0; pc < k; pc += NUMDL_GEMM_KC) {
+            os_size_t kc = k - pc < NUMDL_GEMM_KC ? k - pc : NUMDL_GEMM_KC;
+
+            gemm_pack_b(kc, nc, b + pc * rsb + jc * csb, rsb, csb, bp);
+
+            for (os_size_t ic = 0; ic < m; ic += NUMDL_GEMM_MC) {
+                os_size_t mc = m - ic < NUMDL_GEMM_MC ? m - ic : NUMDL_GEMM_MC;
+
+                gemm_pack_a(mc, kc, a + ic * rsa + pc * csa, rsa, csa, ap);
+
+                for (os_size_t jr = 0; jr < nc; jr += UAI_GEMM_NR) {
+                    os_size_t nr =
+                        nc - jr < UAI_GEMM_NR ? nc - jr : UAI_GEMM_NR;
+
+                    for (os_size_t ir = 0; ir < mc; ir += UAI_GEMM_MR) {
+                        os_size_t mr =
+                            mc - ir < UAI_GEMM_MR ? mc - ir : UAI_GEMM_MR;
+
+                        gemm_micro_kernel(
+                            kc,
+                            ap + ir * kc,
+                            bp + jr * kc,
+                            c + (ic + ir) * rsc + (jc + jr) * csc,
+                            rsc,
+                            csc,
+                            mr,
+                            nr,
+                            pc != 0,
+                            pc + kc == k ? ep : OS_NULL,
+                            jc + jr);
+                    }
+                }
+            }
+        }
+    }
+
+    uai_mat_aligned_free(ap);
+    uai_mat_aligned_free(bp);
+
+    return NUMDL_EOK;
+}
+
+struct gemm_task
+{
+    os_size_t m;
+    os_size_t n;
+    os_size_t k;
+    const float* a;
+    os_size_t rsa;
+    os_size_t csa;
+    const float* b;
+    os_size_t rsb;
+    os_size_t csb;
+    float* c;
+    os_size_t rsc;
+    os_size_t csc;
+    const gemm_epilogue_t* ep;
+
+    os_size_t tiles_m;
+    os_size_t tiles_n;
+    os_size_t tile_m;
+    os_size_t tile_n;
+
+    /* One status per task, no two workers write the same slot */
+    int ret[NUMDL_THREADS_MAX];
+};
+
+static void gemm_tile_task(void* arg, os_size_t index)
+{
+    gemm_task* t = (gemm_task*)arg;
+
+    os_size_t i0 = (index / t->tiles_n) * t->tile_m;
+    os_size_t j0 = (index % t->tiles_n) * t->tile_n;
+    t->ret[index] = NUMDL_EOK;
+    if (i0 >= t->m || j0 >= t->n) {
+        return;
+    }
+
+    os_size_t mt = t->m - i0 < t->tile_m ? t->m - i0 : t->tile_m;
+    os_size_t nt = t->n - j0 < t->tile_n ? t->n - j0 : t->tile_n;
+
+    /* The tile starts at column j0, shift the bias with it */
+    gemm_epilogue_t ep;
+    if (t->ep != OS_NULL) {
+        ep = *t->ep;
+        if (ep.bias != OS_NULL) {
+            ep.bias += j0;
+        }
+    }
+
+    int ret = gemm_serial(mt,
+                          nt,
+                          t->k,
+                          t->a + i0 * t->rsa,
+                          t->rsa,
+                          t->csa,
+                          t->b + j0 * t->csb,
+                          t->rsb,
+                          t->csb,
+                          t->c + i0 * t->rsc + j0 * t->csc,
+                          t->rsc,
+                          t->csc,
+                          t->ep != OS_NULL ? &ep : OS_NULL);
+    t->ret[index] = ret;
+}
+
+/**
+ * R weight rows dotted with F frames. Writes acc[f][t + r]. Each weight load
+ * is shared by the F frames, each frame load by the R rows.
+ */
+template <os_size_t R, os_size_t F>
+static void gemv_dot_tile(os_size_t n,
+                          const float* a,
+                          os_size_t rsa,
+                          const float* x,
+                          os_size_t ldx,
+                          float (*acc)[UAI_GEMV_CHUNK],
+                          os_size_t t)
+{
+    float sum[R][F];
+    os_size_t p = 0;
+
+#if defined(__SSE__)
+    __m128 v[R][F];
+    for (os_size_t r = 0; r < R; r++) {
+        for (os_size_t f = 0; f < F; f++) {
+            v[r][f] = _mm_setzero_ps();
+        }
+    }
+
+    for (; p + 4 <= n; p += 4) {
+        __m128 av[R];
+        for (os_size_t r = 0; r < R; r++) {
+            av[r] = _mm_loadu_ps(a + r * rsa + p);
+        }
+        for (os_size_t f = 0; f < F; f++) {
+            __m128 xv = _mm_loadu_ps(x + f * ldx + p);
+            for (os_size_t r = 0; r < R; r++) {
+                v[r][f] = _mm_add_ps(v[r][f], _mm_mul_ps(av[r], xv));
+            }
+        }
+    }
+
+    for (os_size_t r = 0; r < R; r++) {
+        for (os_size_t f = 0; f < F; f++) {
+            float tmp[4];
+            _mm_storeu_ps(tmp, v[r][f]);
+            sum[r][f] = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+        }
+    }
+#else
+    for (os_size_t r = 0; r < R; r++) {
+        for (os_size_t f = 0; f < F; f++) {
+            sum[r][f] = 0.0f;
+        }
+    }
+#endif
+
+    for (; p < n; p++) {
+        for (os_size_t r = 0; r < R; r++) {
+            for (os_size_t f = 0; f < F; f++) {
+                sum[r][f] += a[r * rsa + p] * x[f * ldx + p];
+            }
+        }
+    }
+
+    for (os_size_t r = 0; r < R; r++) {
+        for (os_size_t f = 0; f < F; f++) {
+            acc[f][t + r] = sum[r][f];
+        }
+    }
+}
+
+struct gemv_task
+{
+    os_size_t batch;
+    os_size_t m;
+    os_size_t n;
+    const float* a;
+    os_size_t rsa;
+    os_size_t csa;
+    const float* x;
+    os_size_t incx;
+    os_size_t ldx;
+    float* y;
+    os_size_t incy;
+    os_size_t ldy;
+    const gemm_epilogue_t* ep;
+    os_size_t bias_inc; /* 0 when every output shares bias[0] */
+    os_size_t chunk;
+};
+
+/**
+ * cnt outputs of F frames, rows of A are contiguous. A single frame keeps
+ * four rows in flight, several frames share two.
+ */
+template <os_size_t F>
+static void gemv_rows_frames(const gemv_task* g,
+                             const float* a,
+                             os_size_t cnt,
+                             const float* x,
+                             float (*acc)[UAI_GEMV_CHUNK])
+{
+    const os_size_t R = 1 == F ? 4 : 2;
+    os_size_t t = 0;
+
+    for (; t + R <= cnt; t += R) {
+        gemv_dot_tile<R, F>(g->n, a + t * g->rsa, g->rsa, x, g->ldx, acc, t);
+    }
+    for (; t < cnt; t++) {
+        gemv_dot_tile<1, F>(g->n, a + t * g->rsa, g->rsa, x, g->ldx, acc, t);
+    }
+}
+
+/** Outputs i0 ... i0 + cnt - 1 of nf frames, rows of A are contiguous */
+static void gemv_rows(const gemv_task* g,
+                      os_size_t i0,
+                      os_size_t cnt,
+                      const float* x,
+                      os_size_t nf,
+                      float (*acc)[UAI_GEMV_CHUNK])
+{
+    const float* a = g->a + i0 * g->rsa;
+
+    switch (nf) {
+    case 1:
+        gemv_rows_frames<1>(g, a, cnt, x, acc);
+        break;
+    case 2:
+        gemv_rows_frames<2>(g, a, cnt, x, acc);
+        break;
+    case 3:
+        gemv_rows_frames<3>(g, a, cnt, x, acc);
+        break;
+    default:
+        gemv_rows_frames<4>(g, a, cnt, x, acc);
+        break;
+    }
+}
+
+/**
+ * Add R rows of A, scaled by the matching inputs of F frames, to acc[f].
+ * Rows are streamed contiguously and each load of acc serves R rows.
+ */
+template <os_size_t R, os_size_t F>
+static void gemv_axpy_rows(os_size_t cnt,
+                           const float* a,
+                           os_size_t csa,
+                           const float* x,
+                           os_size_t ldx,
+                           float (*acc)[UAI_GEMV_CHUNK])
+{
+    os_size_t t = 0;
+
+#if defined(__SSE__)
+    __m128 xb[R][F];
+    for (os_size_t r = 0; r < R; r++) {
+        for (os_size_t f = 0; f < F; f++) {
+            xb[r][f] = _mm_set1_ps(x[f * ldx + r]);
+        }
+    }
+
+    for (; t + 4 <= cnt; t += 4) {
+        __m128 av[R];
+        for (os_size_t r = 0; r < R; r++) {
+            av[r] = _mm_loadu_ps(a + r * csa + t);
+        }
+        for (os_size_t f = 0; f < F; f++) {
+            __m128 sum = _mm_loadu_ps(&acc[f][t]);
+            for (os_size_t r = 0; r < R; r++) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(av[r], xb[r][f]));
+            }
+            _mm_storeu_ps(&acc[f][t], sum);
+        }
+    }
+#endif
+
+    for (; t < cnt; t++) {
+        for (os_size_t f = 0; f < F; f++) {
+            float sum = acc[f][t];
+            for (os_size_t r = 0; r < R; r++) {
+                sum += a[r * csa + t] * x[f * ldx + r];
+            }
+            acc[f][t] = sum;
+        }
+    }
+}
+
+/** cnt outputs of F frames, columns of A are contiguous */
+template <os_size_t F>
+static void gemv_cols_frames(const gemv_task* g,
+                             const float* a,
+                             os_size_t cnt,
+                             const float* x,
+                             float (*acc)[UAI_GEMV_CHUNK])
+{
+    os_size_t csa = g->csa;
+    os_size_t p = 0;
+
+    for (os_size_t f = 0; f < F; f++) {
+        memset(acc[f], 0, cnt * sizeof(float));
+    }
+
+    for (; p + 4 <= g->n; p += 4) {
+        gemv_axpy_rows<4, F>(cnt, a + p * csa, csa, x + p, g->ldx, acc);
+    }
+    for (; p < g->n; p++) {
+        gemv_axpy_rows<1, F>(cnt, a + p * csa, csa, x + p, g->ldx, acc);
+    }
+}
+
+/** Outputs i0 ... i0 + cnt - 1 of nf frames, columns of A are contiguous */
+static void gemv_cols(const gemv_task* g,
+                      os_size_t i0,
+                      os_size_t cnt,
+                      const float* x,
+                      os_size_t nf,
+                      float (*acc)[UAI_GEMV_CHUNK])
+{
+    const float* a = g->a + i0;
+
+    switch (nf) {
+    case 1:
+        gemv_cols_frames<1>(g, a, cnt, x, acc);
+        break;
+    case 2:
+        gemv_cols_frames<2>(g, a, cnt, x, acc);
+        break;
+    case 3:
+        gemv_cols_frames<3>(g, a, cnt, x, acc);
+        break;
+    default:
+        gemv_cols_frames<4>(g, a, cnt, x, acc);
+        break;
+    }
+}
+
+/** Any strides, scalar */
+static void gemv_strided(const gemv_task* g,
+                         os_size_t i0,
+                         os_size_t cnt,
+                         const float* x,
+                         os_size_t nf,
+                         float (*acc)[UAI_GEMV_CHUNK])
+{
+    for (os_size_t f = 0; f < nf; f++) {
+        const float* xf = x + f * g->ldx;
+        for (os_size_t t = 0; t < cnt; t++) {
+            const float* ai = g->a + (i0 + t) * g->rsa;
+            float sum = 0.0f;
+            for (os_size_t p = 0; p < g->n; p++) {
+                sum += ai[p * g->csa] * xf[p * g->incx];
+            }
+            acc[f][t] = sum;
+        }
+    }
+}
+
+static void gemv_chunk_task(void* arg, os_size_t index)
+{
+    const gemv_task* g = (const gemv_task*)arg;
+    float acc[UAI_GEMV_FRAMES][UAI_GEMV_CHUNK];
+
+    os_size_t i0 = index * g->chunk;
+    if (i0 >= g->m) {
+        return;
+    }
+    os_size_t cnt = g->m - i0 < g->chunk ? g->m - i0 : g->chunk;
+
+    for (os_size_t f0 = 0; f0 < g->batch; f0 += UAI_GEMV_FRAMES) {
+        os_size_t nf = g->batch - f0 < UAI_GEMV_FRAMES ? g->batch - f0
+                                                      : UAI_GEMV_FRAMES;
+        const float* x = g->x + f0 * g->ldx;
+
+        if (1 == g->incx && 1 == g->csa) {
+            gemv_rows(g, i0, cnt, x, nf, acc);
+        } else if (1 == g->incx && 1 == g->rsa) {
+            gemv_cols(g, i0, cnt, x, nf, acc);
+        } else {
+            gemv_strided(g, i0, cnt, x, nf, acc);
+        }
+
+        for (os_size_t f = 0; f < nf; f++) {
+            if (g->ep != OS_NULL) {
+                if (g->bias_inc != 0) {
+                    gemm_epilogue_row(g->ep, acc[f], cnt, i0);
+                } else {
+                    for (os_size_t t = 0; t < cnt; t++) {
+                        gemm_epilogue_row(g->ep, acc[f] + t, 1, 0);
+                    }
+                }
+            }
+
+            float* y = g->y + (f0 + f) * g->ldy + i0 * g->incy;
+            for (os_size_t t = 0; t < cnt; t++) {
+                y[t * g->incy] = acc[f][t];
+            }
+        }
+    }
+}
+
+/**
+ * y[f] = ep(A * x[f]) for every frame, A is MxN. Outputs are split into
+ * chunks of at most UAI_GEMV_CHUNK, run on the thread pool when the work is
+ * large enough. Each output is computed the same way whatever the split.
+ */
+static int gemv_run(gemv_task* g)
+{
+    if (0 == g->m || 0 == g->batch) {
+        return NUMDL_EOK;
+    }
+
+    os_size_t threads = thread_pool::get_num_threads();
+
+    g->chunk = UAI_GEMV_CHUNK;
+    if (threads > 1 &&
+        (double)g->batch * g->m * g->n >= NUMDL_GEMM_PARALLEL_MIN) {
+        os_size_t per_thread = (g->m + threads - 1) / threads;
+        per_thread = (per_thread + UAI_GEMM_NR - 1) / UAI_GEMM_NR * UAI_GEMM_NR;
+        g->chunk = per_thread < g->chunk ? per_thread : g->chunk;
+    }
+
+    return thread_pool::run(
+        gemv_chunk_task, g, (g->m + g->chunk - 1) / g->chunk);
+}
+
+/**
+ * Fill an epilogue that leaves the product unchanged: scale 1, no bias, no
+ * activation, no log, log floor NUMDL_GEMM_LOG_FLOOR.
+ *
+ * @param ep [out] Epilogue
+ */
+void gemm::epilogue_init(gemm_epilogue_t* ep)
+{
+    NUMDL_ASSERT(ep != OS_NULL);
+
+    ep->bias = OS_NULL;
+    ep->scale = 1.0f;
+    ep->act = GEMM_ACT_NONE;
+    ep->log = GEMM_LOG_NONE;
+    ep->log_floor = NUMDL_GEMM_LOG_FLOOR;
+}
+
+/**
+ * Single precision matrix multiply C = A * B, A is MxK, B is KxN, C is MxN.
+ * Every operand is addressed through a row stride and a column stride, so
+ * transposed or sliced operands can be passed without copying.
+ *
+ * @param m   [in]  Rows of A and C
+ * @param n   [in]  Columns of B and C
+ * @param k   [in]  Columns of A and rows of B
+ * @param a   [in]  Pointer to A
+ * @param rsa [in]  Row stride of A, in elements
+ * @param csa [in]  Column stride of A, in elements
+ * @param b   [in]  Pointer to B
+ * @param rsb [in]  Row stride of B, in elements
+ * @param csb [in]  Column stride of B, in elements
+ * @param c   [out] Pointer to C
+ * @param rsc [in]  Row stride of C, in elements
+ * @param csc [in]  Column stride of C, in elements
+ *
+ * Large products are split into M/N tiles run on the thread pool. Tiles are
+ * whole multiples of MR x NR and every tile walks K in the same panel order,
+ * so the result is bitwise identical for any number of threads.
+ *
+ * @returns 0 if OK
+ */
+int gemm::sgemm(os_size_t m,
+                os_size_t n,
+                os_size_t k,
+                const float* a,
+                os_size_t rsa,
+                os_size_t csa,
+                const float* b,
+                os_size_t rsb,
+                os_size_t csb,
+                float* c,
+                os_size_t rsc,
+                os_size_t csc)
+{
+    return sgemm(m, n, k, a, rsa, csa, b, rsb, csb, c, rsc, csc, OS_NULL);
+}
+
+/**
+ * Single precision matrix multiply C = ep(A * B). Same as the plain sgemm,
+ * the epilogue is applied to each register tile right after its last K panel,
+ * so C is written once instead of being re-read by a separate pass.
+ *
+ * @param ep [in] Epilogue, OS_NULL for a plain product
+ *
+ * @returns 0 if OK
+ */
+int gemm::sgemm(os_size_t m,
+                os_size_t n,
+                os_size_t k,
+                const float* a,
+                os_size_t rsa,
+                os_size_t csa,
+                const float* b,
+                os_size_t rsb,
+                os_size_t csb,
+                float* c,
+                os_size_t rsc,
+                os_size_t csc,
+                const gemm_epilogue_t* ep)
+{
+    NUMDL_ASSERT(a != OS_NULL);
+    NUMDL_ASSERT(b != OS_NULL);
+    NUMDL_ASSERT(c != OS_NULL);
+
+    if (0 == m || 0 == n) {
+        return NUMDL_EOK;
+    }
+
+    /* A single row or column of C is a matrix-vector product */
+    if (1 == m || 1 == n) {
+        gemv_task g;
+        g.batch = 1;
+        g.ldx = 0;
+        g.ldy = 0;
+        g.ep = ep;
+        g.n = k;
+        if (1 == m) {
+            g.m = n;
+            g.a = b;
+            g.rsa = csb;
+            g.csa = rsb;
+            g.x = a;
+            g.incx = csa;
+            g.y = c;
+            g.incy = csc;
+            g.bias_inc = 1;
+        } else {
+            g.m = m;
+            g.a = a;
+            g.rsa = rsa;
+            g.csa = csa;
+            g.x = b;
+            g.incx = rsb;
+            g.y = c;
+            g.incy = rsc;
+            g.bias_inc = 0;
+        }
+        return gemv_run(&g);
+    }
+
+    os_size_t threads = thread_pool::get_num_threads();
+    if (threads <= 1 || (double)m * n * k < NUMDL_GEMM_PARALLEL_MIN) {
+        return gemm_serial(m, n, k, a, rsa, csa, b, rsb, csb, c, rsc, csc, ep);
+    }
+
+    /* Split the rows first, the columns take what is left */
+    os_size_t blocks_m = (m + UAI_GEMM_MR - 1) / UAI_GEMM_MR;
+    os_size_t blocks_n = (n + UAI_GEMM_NR - 1) / UAI_GEMM_NR;
+
+    os_size_t tiles_m = threads < blocks_m ? threads : blocks_m;
+    os_size_t tiles_n = threads / tiles_m;
+    tiles_n = tiles_n < blocks_n ? tiles_n : blocks_n;
+
+    gemm_task task;
+    task.m = m;
+    task.n = n;
+    task.k = k;
+    task.a = a;
+    task.rsa = rsa;
+    task.csa = csa;
+    task.b = b;
+    task.rsb = rsb;
+    task.csb = csb;
+    task.c = c;
+    task.rsc = rsc;
+    task.csc = csc;
+    task.ep = ep;
+    task.tiles_m = tiles_m;
+    task.tiles_n = tiles_n;
+    task.tile_m = (blocks_m + tiles_m - 1) / tiles_m * UAI_GEMM_MR;
+    task.tile_n = (blocks_n + tiles_n - 1) / tiles_n * UAI_GEMM_NR;
+
+    os_size_t tasks = tiles_m * tiles_n;
+    int ret = thread_pool::run(gemm_tile_task, &task, tasks);
+    for (os_size_t i = 0; i < tasks && NUMDL_EOK == ret; i++) {
+        ret = task.ret[i];
+    }
+
+    return ret;
+}
+
+/**
+ * Matrix-vector product y = ep(A * x), A is MxN. Pass A with swapped strides
+ * for y = ep(x * A), e.g. a frame against row-major weights:
+ *     sgemv(cols, rows, w, 1, cols, x, 1, y, 1, ep)
+ *
+ * @param m    [in]  Rows of A, number of outputs
+ * @param n    [in]  Columns of A, length of x
+ * @param a    [in]  Pointer to A
+ * @param rsa  [in]  Row stride of A, in elements
+ * @param csa  [in]  Column stride of A, in elements
+ * @param x    [in]  Input vector
+ * @param incx [in]  Stride of x, in elements
+ * @param y    [out] Output vector, must not overlap the inputs
+ * @param incy [in]  Stride of y, in elements
+ * @param ep   [in]  Epilogue, bias has M values, OS_NULL for none
+ *
+ * Rows of A with unit column stride use a dot-product kernel, columns with
+ * unit row stride an axpy kernel, other layouts a scalar loop.
+ *
+ * @returns 0 if OK
+ */
+int gemm::sgemv(os_size_t m,
+                os_size_t n,
+                const float* a,
+                os_size_t rsa,
+                os_size_t csa,
+                const float* x,
+                os_size_t incx,
+                float* y,
+                os_size_t incy,
+                const gemm_epilogue_t* ep)
+{
+    NUMDL_ASSERT(a != OS_NULL);
+    NUMDL_ASSERT(x != OS_NULL);
+    NUMDL_ASSERT(y != OS_NULL);
+
+    gemv_task g;
+    g.batch = 1;
+    g.m = m;
+    g.n = n;
+    g.a = a;
+    g.rsa = rsa;
+    g.csa = csa;
+    g.x = x;
+    g.incx = incx;
+    g.ldx = 0;
+    g.y = y;
+    g.incy = incy;
+    g.ldy = 0;
+    g.ep = ep;
+    g.bias_inc = 1;
+
+    return gemv_run(&g);
+}
+
+/**
+ * Batched matrix-vector product y[f] = ep(A * x[f]) for frames that arrive
+ * together. Up to UAI_GEMV_FRAMES frames share each pass over A, so the
+ * weights are read once per group instead of once per frame.
+ *
+ * @param batch [in]  Number of frames
+ * @param m     [in]  Rows of A, outputs per frame
+ * @param n     [in]  Columns of A, inputs per frame
+ * @param a     [in]  Pointer to A
+ * @param rsa   [in]  Row stride of A, in elements
+ * @param csa   [in]  Column stride of A, in elements
+ * @param x     [in]  Frames, each n contiguous values
+ * @param ldx   [in]  Distance between two frames of x, in elements
+ * @param y     [out] Outputs, each m contiguous values
+ * @param ldy   [in]  Distance between two outputs of y, in elements
+ * @param ep    [in]  Epilogue, bias has M values, OS_NULL for none
+ *
+ * @returns 0 if OK
+ */
+int gemm::sgemv_batch(os_size_t batch,
+                      os_size_t m,
+                      os_size_t n,
+                      const float* a,
+                      os_size_t rsa,
+                      os_size_t csa,
+                      const float* x,
+                      os_size_t ldx,
+                      float* y,
+                      os_size_t ldy,
+                      const gemm_epilogue_t* ep)
+{
+    NUMDL_ASSERT(a != OS_NULL);
+    NUMDL_ASSERT(x != OS_NULL);
+    NUMDL_ASSERT(y != OS_NULL);
+
+    gemv_task g;
+    g.batch = batch;
+    g.m = m;
+    g.n = n;
+    g.a = a;
+    g.rsa = rsa;
+    g.csa = csa;
+    g.x = x;
+    g.incx = 1;
+    g.ldx = ldx;
+    g.y = y;
+    g.incy = 1;
+    g.ldy = ldy;
+    g.ep = ep;
+    g.bias_inc = 1;
+
+    return gemv_run(&g);
+}
+
+};  // namespace feature
+};  // namespace uai
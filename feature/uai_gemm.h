@@ -0,0 +1,162 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ * @file        uai_gemm.h
+ *
+ * @brief       Cache-blocked, register-tiled single precision GEMM engine.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#ifndef __UAI_GEMM_H__
+#define __UAI_GEMM_H__
+
+#include <os_stddef.h>
+
+/** Rows of A kept in L2 per packed panel */
+#ifndef NUMDL_GEMM_MC
+#define NUMDL_GEMM_MC (96)
+#endif
+
+/** Depth of a packed panel, a KC x NR sliver of B should stay in L1 */
+#ifndef NUMDL_GEMM_KC
+#define NUMDL_GEMM_KC (256)
+#endif
+
+/** Columns of B kept in L3 per packed panel */
+#ifndef NUMDL_GEMM_NC
+#define NUMDL_GEMM_NC (2048)
+#endif
+
+/** Products smaller than this many multiply-adds stay on one thread */
+#ifndef NUMDL_GEMM_PARALLEL_MIN
+#define NUMDL_GEMM_PARALLEL_MIN (64 * 64 * 64)
+#endif
+
+/** Default clamp applied before the log of an epilogue */
+#ifndef NUMDL_GEMM_LOG_FLOOR
+#define NUMDL_GEMM_LOG_FLOOR (1.0e-10f)
+#endif
+
+/** Register tile of the micro-kernel */
+#define UAI_GEMM_MR (4)
+#define UAI_GEMM_NR (8)
+
+/** Outputs a GEMV task keeps in L1, also the unit split across threads */
+#define UAI_GEMV_CHUNK (256)
+
+/** Frames of a batched GEMV that share one pass over the weights */
+#define UAI_GEMV_FRAMES (4)
+
+namespace uai {
+namespace feature {
+
+typedef enum gemm_trans
+{
+    GEMM_TRANS_NONE = 0,
+    GEMM_TRANS
+} gemm_trans_t;
+
+typedef enum gemm_act
+{
+    GEMM_ACT_NONE = 0,
+    GEMM_ACT_RELU,
+    GEMM_ACT_SIGMOID,
+    GEMM_ACT_TANH
+} gemm_act_t;
+
+typedef enum gemm_log
+{
+    GEMM_LOG_NONE = 0,
+    GEMM_LOG_E,
+    GEMM_LOG_10
+} gemm_log_t;
+
+/**
+ * Applied to every output element while its tile is still in registers:
+ *     y = log(max(act(acc * scale + bias[col]), log_floor))
+ * Fill it with gemm::epilogue_init() and override what is needed.
+ */
+typedef struct gemm_epilogue
+{
+    const float* bias; /* One value per output column, or OS_NULL */
+    float scale;
+    gemm_act_t act;
+    gemm_log_t log;
+    float log_floor; /* Clamp before the log, keeps log(0) finite */
+} gemm_epilogue_t;
+
+class gemm
+{
+public:
+    static void epilogue_init(gemm_epilogue_t* ep);
+
+    static int sgemm(os_size_t m,
+                     os_size_t n,
+                     os_size_t k,
+                     const float* a,
+                     os_size_t rsa,
+                     os_size_t csa,
+                     const float* b,
+                     os_size_t rsb,
+                     os_size_t csb,
+                     float* c,
+                     os_size_t rsc,
+                     os_size_t csc);
+    static int sgemm(os_size_t m,
+                     os_size_t n,
+                     os_size_t k,
+                     const float* a,
+                     os_size_t rsa,
+                     os_size_t csa,
+                     const float* b,
+                     os_size_t rsb,
+                     os_size_t csb,
+                     float* c,
+                     os_size_t rsc,
+                     os_size_t csc,
+                     const gemm_epilogue_t* ep);
+
+    static int sgemv(os_size_t m,
+                     os_size_t n,
+                     const float* a,
+                     os_size_t rsa,
+                     os_size_t csa,
+                     const float* x,
+                     os_size_t incx,
+                     float* y,
+                     os_size_t incy,
+                     const gemm_epilogue_t* ep);
+    static int sgemv_batch(os_size_t batch,
+                           os_size_t m,
+                           os_size_t n,
+                           const float* a,
+                           os_size_t rsa,
+                           os_size_t csa,
+                           const float* x,
+                           os_size_t ldx,
+                           float* y,
+                           os_size_t ldy,
+                           const gemm_epilogue_t* ep);
+};
+
+};  // namespace feature
+};  // namespace uai
+
+#endif /* __UAI_GEMM_H__ */
@@ -23,15 +23,26 @@
  */
 
 #include "uai_matrix.h"
+#include "nd_errno.h"
 
 #define UAI_LOG_TAG "uai.mat"
 #include "nd_log.h"
 
 #include <os_memory.h>
 #include <nd_assert.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#define UAI_MAT_ALIGN_UP(x) \
+    (((x) + UAI_MAT_ALIGN - 1) & ~(os_size_t)(UAI_MAT_ALIGN - 1))
 
 /**
- * Create a matrix of size [rows x cols]
+ * Create a matrix of size [rows x cols]. The header and the zeroed buffer
+ * share one allocation, the buffer is UAI_MAT_ALIGN aligned.
  *
  * @param rows [in] Number of rows of the matrix
  * @param cols [in] Number of cols of the matrix
@@ -42,22 +53,239 @@ uai_mat_t* uai_mat_create(os_size_t rows, os_size_t cols)
 {
     NUMDL_ASSERT(rows > 0 && cols > 0);
 
-    uai_mat_t* mat = (uai_mat_t*)os_calloc(1, sizeof(uai_mat_t));
+    os_size_t buff_size = sizeof(float) * rows * cols;
+    os_size_t total = sizeof(uai_mat_t) + UAI_MAT_ALIGN - 1 + buff_size;
+
+    uai_mat_t* mat = (uai_mat_t*)os_calloc(1, total);
     if (OS_NULL == mat) {
-        ERROR("Create matrix instance failed, no enough memory.");
+        ERROR("Create matrix(%d bytes) failed, no enough memory.", total);
         return OS_NULL;
     }
 
-    os_size_t buff_size = sizeof(float) * rows * cols;
+    mat->rows = rows;
+    mat->cols = cols;
+    mat->data = (float*)UAI_MAT_ALIGN_UP((os_size_t)(mat + 1));
+
+    return mat;
+}
+
+/**
+ * Destory a matrix
+ *
+ * @param mat [in] Pointer to matrix
+ */
+void uai_mat_destroy(uai_mat_t* mat)
+{
+    NUMDL_ASSERT(mat != OS_NULL);
+
+    os_free(mat);
+}
+
+/**
+ * Allocate a UAI_MAT_ALIGN aligned block from the heap
+ *
+ * @param size [in] Size in bytes
+ *
+ * @returns Pointer to the block if OK, release it with uai_mat_aligned_free
+ */
+void* uai_mat_aligned_alloc(os_size_t size)
+{
+    os_uint8_t* raw = (os_uint8_t*)os_malloc(size + UAI_MAT_ALIGN +
+                                             sizeof(void*));
+    if (OS_NULL == raw) {
+        ERROR("Alloc aligned buffer(%d bytes) failed, no enough memory.",
+              size);
+        return OS_NULL;
+    }
+
+    void** ptr = (void**)UAI_MAT_ALIGN_UP((os_size_t)(raw + sizeof(void*)));
+    ptr[-1] = raw;
+
+    return ptr;
+}
+
+/**
+ * Free a block allocated by uai_mat_aligned_alloc
+ *
+ * @param ptr [in] Pointer to the block, may be OS_NULL
+ */
+void uai_mat_aligned_free(void* ptr)
+{
+    if (ptr != OS_NULL) {
+        os_free(((void**)ptr)[-1]);
+    }
+}
+
+/**
+ * Create an arena owning a heap buffer of `size` bytes
+ *
+ * @param size [in] Capacity in bytes
+ *
+ * @returns Pointer to arena if OK
+ */
+uai_mat_arena_t* uai_mat_arena_create(os_size_t size)
+{
+    uai_mat_arena_t* arena =
+        (uai_mat_arena_t*)os_calloc(1, sizeof(uai_mat_arena_t));
+    if (OS_NULL == arena) {
+        ERROR("Create arena instance failed, no enough memory.");
+        return OS_NULL;
+    }
 
-    float* buff = (float*)os_calloc(1, buff_size);
+    void* buff = uai_mat_aligned_alloc(size);
     if (OS_NULL == buff) {
-        ERROR("Alloc matrix data buffer(%d bytes) failed, no enough memory.",
-              buff_size);
-        os_free(mat);
+        os_free(arena);
         return OS_NULL;
     }
 
+    uai_mat_arena_init(arena, buff, size);
+    arena->owned = OS_TRUE;
+
+    return arena;
+}
+
+/**
+ * Destroy an arena made by uai_mat_arena_create. Every matrix created in it
+ * becomes invalid.
+ *
+ * @param arena [in] Pointer to arena
+ */
+void uai_mat_arena_destroy(uai_mat_arena_t* arena)
+{
+    NUMDL_ASSERT(arena != OS_NULL);
+
+    if (arena->owned) {
+        uai_mat_aligned_free(arena->base);
+    }
+
+    os_free(arena);
+}
+
+/**
+ * Set up an arena on a caller supplied buffer, e.g. a static array
+ *
+ * @param arena [out] Pointer to arena
+ * @param buff  [in]  Backing buffer, need not be aligned
+ * @param size  [in]  Size of the backing buffer in bytes
+ *
+ * @returns 0 if OK
+ */
+int uai_mat_arena_init(uai_mat_arena_t* arena, void* buff, os_size_t size)
+{
+    NUMDL_ASSERT(arena != OS_NULL);
+    NUMDL_ASSERT(buff != OS_NULL);
+
+    arena->base = (os_uint8_t*)buff;
+    arena->size = size;
+    arena->used = 0;
+    arena->peak = 0;
+    arena->owned = OS_FALSE;
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Take a UAI_MAT_ALIGN aligned block from the arena
+ *
+ * @param arena [in] Pointer to arena
+ * @param size  [in] Size in bytes
+ *
+ * @returns Pointer to the block if OK, OS_NULL if the arena is full
+ */
+void* uai_mat_arena_alloc(uai_mat_arena_t* arena, os_size_t size)
+{
+    NUMDL_ASSERT(arena != OS_NULL);
+
+    os_size_t start = (os_size_t)arena->base + arena->used;
+    os_size_t offset = UAI_MAT_ALIGN_UP(start) - (os_size_t)arena->base;
+
+    if (offset > arena->size || size > arena->size - offset) {
+        ERROR("Arena full, %d of %d bytes used, %d bytes requested.",
+              arena->used,
+              arena->size,
+              size);
+        return OS_NULL;
+    }
+
+    arena->used = offset + size;
+    if (arena->used > arena->peak) {
+        arena->peak = arena->used;
+    }
+
+    return arena->base + offset;
+}
+
+/**
+ * Remember the current fill level of the arena
+ *
+ * @param arena [in] Pointer to arena
+ *
+ * @returns Mark to pass to uai_mat_arena_reset_to
+ */
+uai_mat_arena_mark_t uai_mat_arena_mark(const uai_mat_arena_t* arena)
+{
+    NUMDL_ASSERT(arena != OS_NULL);
+
+    return arena->used;
+}
+
+/**
+ * Release everything allocated after `mark` was taken
+ *
+ * @param arena [in] Pointer to arena
+ * @param mark  [in] Mark from uai_mat_arena_mark
+ */
+void uai_mat_arena_reset_to(uai_mat_arena_t* arena, uai_mat_arena_mark_t mark)
+{
+    NUMDL_ASSERT(arena != OS_NULL);
+    NUMDL_ASSERT(mark <= arena->used);
+
+    arena->used = mark;
+}
+
+/**
+ * Release everything allocated from the arena
+ *
+ * @param arena [in] Pointer to arena
+ */
+void uai_mat_arena_reset(uai_mat_arena_t* arena)
+{
+    NUMDL_ASSERT(arena != OS_NULL);
+
+    arena->used = 0;
+}
+
+/**
+ * Create a zeroed matrix of size [rows x cols] in an arena. It is released
+ * with the arena, do not call uai_mat_destroy on it.
+ *
+ * @param arena [in] Pointer to arena
+ * @param rows  [in] Number of rows of the matrix
+ * @param cols  [in] Number of cols of the matrix
+ *
+ * @returns Pointer to matrix if OK
+ */
+uai_mat_t* uai_mat_create_in(uai_mat_arena_t* arena,
+                             os_size_t rows,
+                             os_size_t cols)
+{
+    NUMDL_ASSERT(rows > 0 && cols > 0);
+
+    uai_mat_arena_mark_t mark = uai_mat_arena_mark(arena);
+
+    uai_mat_t* mat = (uai_mat_t*)uai_mat_arena_alloc(arena, sizeof(uai_mat_t));
+    if (OS_NULL == mat) {
+        return OS_NULL;
+    }
+
+    float* buff = uai_mat_buffer_in(arena, rows * cols);
+    if (OS_NULL == buff) {
+        uai_mat_arena_reset_to(arena, mark);
+        return OS_NULL;
+    }
+
+    memset(buff, 0, rows * cols * sizeof(float));
+
     mat->rows = rows;
     mat->cols = cols;
     mat->data = buff;
@@ -66,17 +294,434 @@ uai_mat_t* uai_mat_create(os_size_t rows, os_size_t cols)
 }
 
 /**
- * Destory a matrix
+ * Take an uninitialised buffer of `count` floats from an arena
  *
- * @param mat [in] Pointer to matrix
+ * @param arena [in] Pointer to arena
+ * @param count [in] Number of floats
+ *
+ * @returns Pointer to buffer if OK
  */
-void uai_mat_destroy(uai_mat_t* mat)
+float* uai_mat_buffer_in(uai_mat_arena_t* arena, os_size_t count)
+{
+    return (float*)uai_mat_arena_alloc(arena, count * sizeof(float));
+}
+
+/** Transpose one tile, 4x4 of it at a time in registers */
+static void uai_mat_transpose_tile(float* dst,
+                                   os_size_t ldd,
+                                   const float* src,
+                                   os_size_t lds,
+                                   os_size_t rows,
+                                   os_size_t cols)
+{
+    os_size_t i = 0;
+
+#if defined(__SSE__)
+    for (; i + 4 <= rows; i += 4) {
+        os_size_t j = 0;
+        for (; j + 4 <= cols; j += 4) {
+            const float* s = src + i * lds + j;
+            float* d = dst + j * ldd + i;
+            __m128 r0 = _mm_loadu_ps(s);
+            __m128 r1 = _mm_loadu_ps(s + lds);
+            __m128 r2 = _mm_loadu_ps(s + 2 * lds);
+            __m128 r3 = _mm_loadu_ps(s + 3 * lds);
+
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            _mm_storeu_ps(d, r0);
+            _mm_storeu_ps(d + ldd, r1);
+            _mm_storeu_ps(d + 2 * ldd, r2);
+            _mm_storeu_ps(d + 3 * ldd, r3);
+        }
+        for (; j < cols; j++) {
+            for (os_size_t r = i; r < i + 4; r++) {
+                dst[j * ldd + r] = src[r * lds + j];
+            }
+        }
+    }
+#endif
+
+    for (; i < rows; i++) {
+        for (os_size_t j = 0; j < cols; j++) {
+            dst[j * ldd + i] = src[i * lds + j];
+        }
+    }
+}
+
+/**
+ * Transpose a [rows x cols] row-major buffer into a [cols x rows] one, tile
+ * by tile so both sides stay in cache. The buffers must not overlap.
+ *
+ * @param dst  [out] Destination buffer
+ * @param ldd  [in]  Distance in elements between two rows of dst
+ * @param src  [in]  Source buffer
+ * @param lds  [in]  Distance in elements between two rows of src
+ * @param rows [in]  Number of rows of src
+ * @param cols [in]  Number of cols of src
+ *
+ * @returns 0 if OK
+ */
+int uai_mat_transpose_buffer(float* dst,
+                             os_size_t ldd,
+                             const float* src,
+                             os_size_t lds,
+                             os_size_t rows,
+                             os_size_t cols)
+{
+    NUMDL_ASSERT(dst != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+
+    if (lds < cols || ldd < rows) {
+        ERROR("Invalid leading dimension(%d, %d) for %dx%d.",
+              lds,
+              ldd,
+              rows,
+              cols);
+        return NUMDL_EINVAL;
+    }
+
+    for (os_size_t i = 0; i < rows; i += NUMDL_MAT_TRANSPOSE_BLOCK) {
+        os_size_t mb = rows - i < NUMDL_MAT_TRANSPOSE_BLOCK
+                           ? rows - i
+                           : NUMDL_MAT_TRANSPOSE_BLOCK;
+        for (os_size_t j = 0; j < cols; j += NUMDL_MAT_TRANSPOSE_BLOCK) {
+            os_size_t nb = cols - j < NUMDL_MAT_TRANSPOSE_BLOCK
+                               ? cols - j
+                               : NUMDL_MAT_TRANSPOSE_BLOCK;
+            uai_mat_transpose_tile(
+                dst + j * ldd + i, ldd, src + i * lds + j, lds, mb, nb);
+        }
+    }
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Physically transpose a matrix, dst = src^T. Use a transposed view or the
+ * transpose flags of dsp::dot instead when the data need not move.
+ *
+ * @param dst [out] Pointer to matrix (cols x rows of src), not src itself
+ * @param src [in]  Pointer to matrix
+ *
+ * @returns 0 if OK
+ */
+int uai_mat_transpose(uai_mat_t* dst, const uai_mat_t* src)
+{
+    NUMDL_ASSERT(dst != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+    NUMDL_ASSERT(dst->data != src->data);
+
+    if (dst->rows != src->cols || dst->cols != src->rows) {
+        ERROR("Transpose %dx%d into %dx%d.",
+              src->rows,
+              src->cols,
+              dst->rows,
+              dst->cols);
+        return NUMDL_EINVAL;
+    }
+
+    return uai_mat_transpose_buffer(
+        dst->data, dst->cols, src->data, src->cols, src->rows, src->cols);
+}
+
+/**
+ * Convert a dense matrix to CSR, keeping the elements with |x| > threshold.
+ * The header and the arrays share one allocation.
+ *
+ * @param mat       [in] Pointer to dense matrix
+ * @param threshold [in] Magnitude at or below which an element is dropped,
+ *                       0 keeps every non-zero
+ *
+ * @returns Pointer to CSR matrix if OK
+ */
+uai_mat_csr_t* uai_mat_csr_from_dense(const uai_mat_t* mat, float threshold)
 {
     NUMDL_ASSERT(mat != OS_NULL);
 
-    if (mat->data != OS_NULL) {
-        os_free(mat->data);
+    os_size_t nnz = 0;
+    for (os_size_t i = 0; i < mat->rows * mat->cols; i++) {
+        nnz += fabsf(mat->data[i]) > threshold;
     }
 
-    os_free(mat);
+    os_size_t idx_size = sizeof(os_uint32_t) * (mat->rows + 1 + nnz);
+    os_size_t total = sizeof(uai_mat_csr_t) + idx_size + UAI_MAT_ALIGN - 1 +
+                      sizeof(float) * nnz;
+
+    uai_mat_csr_t* csr = (uai_mat_csr_t*)os_calloc(1, total);
+    if (OS_NULL == csr) {
+        ERROR("Create CSR matrix(%d bytes) failed, no enough memory.", total);
+        return OS_NULL;
+    }
+
+    csr->rows = mat->rows;
+    csr->cols = mat->cols;
+    csr->nnz = nnz;
+    csr->row_ptr = (os_uint32_t*)(csr + 1);
+    csr->col_idx = csr->row_ptr + mat->rows + 1;
+    csr->val = (float*)UAI_MAT_ALIGN_UP((os_size_t)(csr->col_idx + nnz));
+
+    os_size_t p = 0;
+    for (os_size_t i = 0; i < mat->rows; i++) {
+        const float* row = mat->data + i * mat->cols;
+
+        csr->row_ptr[i] = (os_uint32_t)p;
+        for (os_size_t j = 0; j < mat->cols; j++) {
+            if (fabsf(row[j]) > threshold) {
+                csr->col_idx[p] = (os_uint32_t)j;
+                csr->val[p] = row[j];
+                p++;
+            }
+        }
+    }
+    csr->row_ptr[mat->rows] = (os_uint32_t)p;
+
+    return csr;
+}
+
+/**
+ * Destroy a CSR matrix
+ *
+ * @param csr [in] Pointer to CSR matrix
+ */
+void uai_mat_csr_destroy(uai_mat_csr_t* csr)
+{
+    NUMDL_ASSERT(csr != OS_NULL);
+
+    os_free(csr);
+}
+
+static os_bool_t uai_mat_block_used(const uai_mat_t* mat,
+                                    os_size_t row,
+                                    os_size_t col,
+                                    os_size_t block_rows,
+                                    os_size_t block_cols,
+                                    float threshold)
+{
+    for (os_size_t i = row; i < row + block_rows && i < mat->rows; i++) {
+        for (os_size_t j = col; j < col + block_cols && j < mat->cols; j++) {
+            if (fabsf(mat->data[i * mat->cols + j]) > threshold) {
+                return OS_TRUE;
+            }
+        }
+    }
+
+    return OS_FALSE;
+}
+
+/**
+ * Convert a dense matrix to block sparse rows. A block is stored when any of
+ * its elements has |x| > threshold, e.g. 1x4 blocks for pruned fully
+ * connected weights or 4x4 for structured pruning.
+ *
+ * @param mat        [in] Pointer to dense matrix
+ * @param block_rows [in] Rows of a block
+ * @param block_cols [in] Cols of a block
+ * @param threshold  [in] Magnitude at or below which an element is treated
+ *                        as zero
+ *
+ * @returns Pointer to BSR matrix if OK
+ */
+uai_mat_bsr_t* uai_mat_bsr_from_dense(const uai_mat_t* mat,
+                                      os_size_t block_rows,
+                                      os_size_t block_cols,
+                                      float threshold)
+{
+    NUMDL_ASSERT(mat != OS_NULL);
+    NUMDL_ASSERT(block_rows > 0 && block_cols > 0);
+
+    os_size_t brows = (mat->rows + block_rows - 1) / block_rows;
+    os_size_t bcols = (mat->cols + block_cols - 1) / block_cols;
+    os_size_t bsize = block_rows * block_cols;
+
+    os_size_t nnzb = 0;
+    for (os_size_t i = 0; i < brows; i++) {
+        for (os_size_t j = 0; j < bcols; j++) {
+            nnzb += uai_mat_block_used(mat,
+                                       i * block_rows,
+                                       j * block_cols,
+                                       block_rows,
+                                       block_cols,
+                                       threshold);
+        }
+    }
+
+    os_size_t idx_size = sizeof(os_uint32_t) * (brows + 1 + nnzb);
+    os_size_t total = sizeof(uai_mat_bsr_t) + idx_size + UAI_MAT_ALIGN - 1 +
+                      sizeof(float) * nnzb * bsize;
+
+    uai_mat_bsr_t* bsr = (uai_mat_bsr_t*)os_calloc(1, total);
+    if (OS_NULL == bsr) {
+        ERROR("Create BSR matrix(%d bytes) failed, no enough memory.", total);
+        return OS_NULL;
+    }
+
+    bsr->rows = mat->rows;
+    bsr->cols = mat->cols;
+    bsr->block_rows = block_rows;
+    bsr->block_cols = block_cols;
+    bsr->nnzb = nnzb;
+    bsr->row_ptr = (os_uint32_t*)(bsr + 1);
+    bsr->col_idx = bsr->row_ptr + brows + 1;
+    bsr->val = (float*)UAI_MAT_ALIGN_UP((os_size_t)(bsr->col_idx + nnzb));
+
+    os_size_t b = 0;
+    for (os_size_t i = 0; i < brows; i++) {
+        bsr->row_ptr[i] = (os_uint32_t)b;
+        for (os_size_t j = 0; j < bcols; j++) {
+            os_size_t row = i * block_rows;
+            os_size_t col = j * block_cols;
+            if (!uai_mat_block_used(
+                    mat, row, col, block_rows, block_cols, threshold)) {
+                continue;
+            }
+
+            /* Padding stays zero from os_calloc */
+            float* blk = bsr->val + b * bsize;
+            for (os_size_t r = 0; r < block_rows && row + r < mat->rows; r++) {
+                for (os_size_t c = 0;
+                     c < block_cols && col + c < mat->cols;
+                     c++) {
+                    blk[r * block_cols + c] =
+                        mat->data[(row + r) * mat->cols + col + c];
+                }
+            }
+            bsr->col_idx[b] = (os_uint32_t)j;
+            b++;
+        }
+    }
+    bsr->row_ptr[brows] = (os_uint32_t)b;
+
+    return bsr;
+}
+
+/**
+ * Destroy a BSR matrix
+ *
+ * @param bsr [in] Pointer to BSR matrix
+ */
+void uai_mat_bsr_destroy(uai_mat_bsr_t* bsr)
+{
+    NUMDL_ASSERT(bsr != OS_NULL);
+
+    os_free(bsr);
+}
+
+/**
+ * Make a view on a whole matrix, no memory is allocated
+ *
+ * @param view [out] Pointer to view
+ * @param mat  [in]  Pointer to matrix
+ *
+ * @returns 0 if OK
+ */
+int uai_mat_view_init(uai_mat_view_t* view, const uai_mat_t* mat)
+{
+    NUMDL_ASSERT(view != OS_NULL);
+    NUMDL_ASSERT(mat != OS_NULL);
+
+    return uai_mat_view_strided(
+        view, mat->data, mat->rows, mat->cols, mat->cols, 1);
+}
+
+/**
+ * Make a view on any strided buffer, e.g. overlapping frames of a signal with
+ * row_stride set to the hop size.
+ *
+ * @param view       [out] Pointer to view
+ * @param data       [in]  Pointer to the first element
+ * @param rows       [in]  Number of rows of the view
+ * @param cols       [in]  Number of cols of the view
+ * @param row_stride [in]  Distance in elements between two rows
+ * @param col_stride [in]  Distance in elements between two cols
+ *
+ * @returns 0 if OK
+ */
+int uai_mat_view_strided(uai_mat_view_t* view,
+                         float* data,
+                         os_size_t rows,
+                         os_size_t cols,
+                         os_size_t row_stride,
+                         os_size_t col_stride)
+{
+    NUMDL_ASSERT(view != OS_NULL);
+    NUMDL_ASSERT(data != OS_NULL);
+
+    view->rows = rows;
+    view->cols = cols;
+    view->offset = 0;
+    view->row_stride = row_stride;
+    view->col_stride = col_stride;
+    view->transposed = OS_FALSE;
+    view->data = data;
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Make a view on a [rows x cols] block of another view, starting at
+ * (row, col). The block shares the buffer of the source.
+ *
+ * @param view [out] Pointer to the block view, may be the same as src
+ * @param src  [in]  Pointer to the source view
+ * @param row  [in]  First row of the block
+ * @param col  [in]  First col of the block
+ * @param rows [in]  Number of rows of the block
+ * @param cols [in]  Number of cols of the block
+ *
+ * @returns 0 if OK
+ */
+int uai_mat_view_block(uai_mat_view_t* view,
+                       const uai_mat_view_t* src,
+                       os_size_t row,
+                       os_size_t col,
+                       os_size_t rows,
+                       os_size_t cols)
+{
+    NUMDL_ASSERT(view != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+
+    if (row + rows > src->rows || col + cols > src->cols) {
+        ERROR("Block [%d, %d] + [%d x %d] out of view [%d x %d].",
+              row,
+              col,
+              rows,
+              cols,
+              src->rows,
+              src->cols);
+        return NUMDL_EINVAL;
+    }
+
+    os_size_t offset = src->offset + row * uai_mat_view_rs(src) +
+                       col * uai_mat_view_cs(src);
+
+    *view = *src;
+    view->rows = rows;
+    view->cols = cols;
+    view->offset = offset;
+
+    return NUMDL_EOK;
+}
+
+/**
+ * Make the transposed view of another view, no data is moved
+ *
+ * @param view [out] Pointer to the transposed view, may be the same as src
+ * @param src  [in]  Pointer to the source view
+ *
+ * @returns 0 if OK
+ */
+int uai_mat_view_transpose(uai_mat_view_t* view, const uai_mat_view_t* src)
+{
+    NUMDL_ASSERT(view != OS_NULL);
+    NUMDL_ASSERT(src != OS_NULL);
+
+    os_size_t rows = src->rows;
+
+    *view = *src;
+    view->rows = src->cols;
+    view->cols = rows;
+    view->transposed = !src->transposed;
+
+    return NUMDL_EOK;
 }
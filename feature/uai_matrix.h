@@ -31,6 +31,14 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/** Alignment in bytes of every matrix buffer, one cache line */
+#define UAI_MAT_ALIGN (64)
+
+/** Edge of the square tiles a transpose moves at once, both fit in L1 */
+#ifndef NUMDL_MAT_TRANSPOSE_BLOCK
+#define NUMDL_MAT_TRANSPOSE_BLOCK (32)
+#endif
+
 typedef struct uai_mat_size
 {
     os_size_t rows;
@@ -45,9 +53,152 @@ typedef struct uai_mat
     float* data;
 } uai_mat_t;
 
+/**
+ * Strided view on matrix data, it never owns the buffer.
+ *
+ * Element (i, j) of the view is stored at
+ *     data[offset + i * row_stride + j * col_stride]
+ * or, when transposed is set, at
+ *     data[offset + j * row_stride + i * col_stride]
+ * rows and cols always give the shape seen through the view.
+ */
+typedef struct uai_mat_view
+{
+    os_size_t rows;
+    os_size_t cols;
+
+    os_size_t offset;
+    os_size_t row_stride;
+    os_size_t col_stride;
+    os_bool_t transposed;
+
+    float* data;
+} uai_mat_view_t;
+
+/**
+ * Bump allocator for per-frame temporaries. Every block is UAI_MAT_ALIGN
+ * aligned, nothing is freed on its own: go back to a mark or reset the whole
+ * arena, both in O(1).
+ */
+typedef struct uai_mat_arena
+{
+    os_uint8_t* base;
+    os_size_t size;
+    os_size_t used;
+    os_size_t peak;
+
+    os_bool_t owned;
+} uai_mat_arena_t;
+
+typedef os_size_t uai_mat_arena_mark_t;
+
+/**
+ * Compressed sparse row matrix. The non-zeros of row i are
+ *     val[row_ptr[i]] ... val[row_ptr[i + 1] - 1]
+ * at columns col_idx[row_ptr[i]] ... The arrays share one allocation with
+ * the header.
+ */
+typedef struct uai_mat_csr
+{
+    os_size_t rows;
+    os_size_t cols;
+    os_size_t nnz;
+
+    os_uint32_t* row_ptr;
+    os_uint32_t* col_idx;
+    float* val;
+} uai_mat_csr_t;
+
+/**
+ * Block sparse row matrix made of dense [block_rows x block_cols] blocks.
+ * Block row i holds blocks row_ptr[i] ... row_ptr[i + 1] - 1, block b starts
+ * at column col_idx[b] * block_cols and its values are stored row major at
+ * val + b * block_rows * block_cols. Edge blocks are zero padded.
+ */
+typedef struct uai_mat_bsr
+{
+    os_size_t rows;
+    os_size_t cols;
+    os_size_t block_rows;
+    os_size_t block_cols;
+    os_size_t nnzb;
+
+    os_uint32_t* row_ptr;
+    os_uint32_t* col_idx;
+    float* val;
+} uai_mat_bsr_t;
+
 uai_mat_t* uai_mat_create(os_size_t rows, os_size_t cols);
 void uai_mat_destroy(uai_mat_t* mat);
 
+void* uai_mat_aligned_alloc(os_size_t size);
+void uai_mat_aligned_free(void* ptr);
+
+uai_mat_arena_t* uai_mat_arena_create(os_size_t size);
+void uai_mat_arena_destroy(uai_mat_arena_t* arena);
+int uai_mat_arena_init(uai_mat_arena_t* arena, void* buff, os_size_t size);
+void* uai_mat_arena_alloc(uai_mat_arena_t* arena, os_size_t size);
+uai_mat_arena_mark_t uai_mat_arena_mark(const uai_mat_arena_t* arena);
+void uai_mat_arena_reset_to(uai_mat_arena_t* arena, uai_mat_arena_mark_t mark);
+void uai_mat_arena_reset(uai_mat_arena_t* arena);
+
+uai_mat_t* uai_mat_create_in(uai_mat_arena_t* arena,
+                             os_size_t rows,
+                             os_size_t cols);
+float* uai_mat_buffer_in(uai_mat_arena_t* arena, os_size_t count);
+
+int uai_mat_transpose(uai_mat_t* dst, const uai_mat_t* src);
+int uai_mat_transpose_buffer(float* dst,
+                             os_size_t ldd,
+                             const float* src,
+                             os_size_t lds,
+                             os_size_t rows,
+                             os_size_t cols);
+
+uai_mat_csr_t* uai_mat_csr_from_dense(const uai_mat_t* mat, float threshold);
+void uai_mat_csr_destroy(uai_mat_csr_t* csr);
+uai_mat_bsr_t* uai_mat_bsr_from_dense(const uai_mat_t* mat,
+                                      os_size_t block_rows,
+                                      os_size_t block_cols,
+                                      float threshold);
+void uai_mat_bsr_destroy(uai_mat_bsr_t* bsr);
+
+int uai_mat_view_init(uai_mat_view_t* view, const uai_mat_t* mat);
+int uai_mat_view_strided(uai_mat_view_t* view,
+                         float* data,
+                         os_size_t rows,
+                         os_size_t cols,
+                         os_size_t row_stride,
+                         os_size_t col_stride);
+int uai_mat_view_block(uai_mat_view_t* view,
+                       const uai_mat_view_t* src,
+                       os_size_t row,
+                       os_size_t col,
+                       os_size_t rows,
+                       os_size_t cols);
+int uai_mat_view_transpose(uai_mat_view_t* view, const uai_mat_view_t* src);
+
+/** Distance in elements between two rows seen through the view */
+static inline os_size_t uai_mat_view_rs(const uai_mat_view_t* view)
+{
+    return view->transposed ? view->col_stride : view->row_stride;
+}
+
+/** Distance in elements between two columns seen through the view */
+static inline os_size_t uai_mat_view_cs(const uai_mat_view_t* view)
+{
+    return view->transposed ? view->row_stride : view->col_stride;
+}
+
+/** Pointer to element (row, col) of the view */
+static inline float* uai_mat_view_ptr(const uai_mat_view_t* view,
+                                      os_size_t row,
+                                      os_size_t col)
+{
+    return view->data + view->offset + row * uai_mat_view_rs(view) +
+           col * uai_mat_view_cs(view);
+}
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
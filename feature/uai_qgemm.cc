@@ -0,0 +1,986 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_qgemm.cc
+ *
+ * @brief       Quantised int8/int16 matrix multiply with the requantisation
+ *              semantics of CMSIS-NN, so host results are bit exact with the
+ *              MCU build.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_qgemm.h"
+#include "uai_gemm.h"
+#include "uai_thread_pool.h"
+#include "nd_errno.h"
+
+#define NUMDL_LOG_TAG "uai.qgemm"
+#include "nd_log.h"
+
+#include <math.h>
+
+#include <nd_assert.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Unsigned by signed byte dot product into int32 lanes */
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+#define UAI_QGEMM_DPBUSD(acc, u, s) _mm256_dpbusd_epi32(acc, u, s)
+#elif defined(__AVXVNNI__)
+#define UAI_QGEMM_DPBUSD(acc, u, s) _mm256_dpbusd_avx_epi32(acc, u, s)
+#endif
+
+/* The tile loops of the kernels must unroll, or the accumulators end up in
+ * memory; -O2 alone does not unroll them */
+#if defined(__GNUC__) && !defined(__clang__)
+#define UAI_QGEMM_UNROLL _Pragma("GCC unroll 8")
+#else
+#define UAI_QGEMM_UNROLL
+#endif
+
+/* dpbusd takes unsigned lhs bytes, the kernels then feed lhs + 128 and take
+ * 128 * row sum of rhs back out with the lhs offset */
+#if defined(UAI_QGEMM_DPBUSD)
+#define UAI_QGEMM_LHS_BIAS (128)
+#else
+#define UAI_QGEMM_LHS_BIAS (0)
+#endif
+
+namespace uai {
+namespace feature {
+
+/** Same operations, in the same order, as arm_nn_requantize */
+static inline os_int32_t q_requantize(os_int32_t val,
+                                      os_int32_t multiplier,
+                                      os_int32_t shift)
+{
+    os_int32_t left = shift > 0 ? shift : 0;
+    os_int32_t right = shift > 0 ? 0 : -shift;
+
+    /* Doubling high multiply without saturation */
+    os_int32_t m1 = (os_int32_t)((os_uint32_t)val * ((os_uint32_t)1 << left));
+    os_int64_t mult = ((os_int64_t)1 << 30) + (os_int64_t)m1 * multiplier;
+    os_int32_t result = (os_int32_t)(mult >> 31);
+
+    /* Rounding divide by power of two, midpoint away from zero */
+    os_int32_t remainder_mask = (1 << right) - 1;
+    os_int32_t remainder = remainder_mask & result;
+    os_int32_t threshold = remainder_mask >> 1;
+
+    result = result >> right;
+    if (result < 0) {
+        threshold++;
+    }
+    if (remainder > threshold) {
+        result++;
+    }
+
+    return result;
+}
+
+/** Same operations, in the same order, as arm_nn_requantize_s64 */
+static inline os_int32_t q_requantize_s64(os_int64_t val,
+                                          os_int32_t reduced_multiplier,
+                                          os_int32_t shift)
+{
+    os_int64_t new_val = val * reduced_multiplier;
+    os_int32_t result = (os_int32_t)(new_val >> (14 - shift));
+
+    return (result + 1) >> 1;
+}
+
+static inline os_int32_t q_clamp(os_int32_t val, os_int32_t min, os_int32_t max)
+{
+    val = val > min ? val : min;
+    return val < max ? val : max;
+}
+
+#if defined(__AVX2__)
+static inline os_int32_t q_hsum_epi32(__m256i v)
+{
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+static inline os_int64_t q_hsum_epi32_s64(__m256i v)
+{
+    os_int32_t lanes[8];
+    os_int64_t sum = 0;
+
+    _mm256_storeu_si256((__m256i*)lanes, v);
+    for (os_int32_t i = 0; i < 8; i++) {
+        sum += lanes[i];
+    }
+    return sum;
+}
+#elif defined(__SSE2__)
+static inline os_int32_t q_hsum_epi32(__m128i s)
+{
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+static inline os_int64_t q_hsum_epi32_s64(__m128i v)
+{
+    os_int32_t lanes[4];
+
+    _mm_storeu_si128((__m128i*)lanes, v);
+    return (os_int64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+/** Load 8 int8 and sign extend them to int16 */
+static inline __m128i q_load_s8x8(const os_int8_t* p)
+{
+    __m128i v = _mm_loadl_epi64((const __m128i*)p);
+    return _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+}
+#endif
+
+#if defined(__SSE2__)
+/** Horizontal sums of 4 vectors at once, out[j] = sum of lanes of vj */
+static inline void q_hsum4_epi32(__m128i v0,
+                                 __m128i v1,
+                                 __m128i v2,
+                                 __m128i v3,
+                                 os_int32_t* out)
+{
+    __m128i t0 = _mm_unpacklo_epi32(v0, v1);
+    __m128i t1 = _mm_unpackhi_epi32(v0, v1);
+    __m128i t2 = _mm_unpacklo_epi32(v2, v3);
+    __m128i t3 = _mm_unpackhi_epi32(v2, v3);
+    __m128i s0 = _mm_add_epi32(_mm_unpacklo_epi64(t0, t2),
+                               _mm_unpackhi_epi64(t0, t2));
+    __m128i s1 = _mm_add_epi32(_mm_unpacklo_epi64(t1, t3),
+                               _mm_unpackhi_epi64(t1, t3));
+    _mm_storeu_si128((__m128i*)out, _mm_add_epi32(s0, s1));
+}
+#endif
+
+#if defined(__AVX2__)
+static inline __m128i q_fold_epi32(__m256i v)
+{
+    return _mm_add_epi32(_mm256_castsi256_si128(v),
+                         _mm256_extracti128_si256(v, 1));
+}
+#endif
+
+/** Sum of every rhs row, lhs_offset * sum turns a raw dot into the CMSIS one */
+static void q8_row_sums(const os_int8_t* rhs,
+                        os_int32_t k,
+                        os_int32_t rows,
+                        os_int32_t* sums)
+{
+    for (os_int32_t r = 0; r < rows; r++) {
+        const os_int8_t* row = rhs + (os_size_t)r * k;
+        os_int32_t sum = 0;
+        os_int32_t i = 0;
+
+#if defined(__AVX2__)
+        /* sad against zero sums the bytes of rhs + 128 into 64 bit lanes */
+        const __m256i flip = _mm256_set1_epi8((char)0x80);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 32 <= k; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(row + i));
+            acc = _mm256_add_epi64(
+                acc,
+                _mm256_sad_epu8(_mm256_xor_si256(v, flip),
+                                _mm256_setzero_si256()));
+        }
+        sum = q_hsum_epi32(acc) - 128 * i;
+#elif defined(__SSE2__)
+        const __m128i flip = _mm_set1_epi8((char)0x80);
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 16 <= k; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(row + i));
+            acc = _mm_add_epi64(
+                acc, _mm_sad_epu8(_mm_xor_si128(v, flip), _mm_setzero_si128()));
+        }
+        sum = q_hsum_epi32(acc) - 128 * i;
+#endif
+
+        for (; i < k; i++) {
+            sum += row[i];
+        }
+        sums[r] = sum;
+    }
+}
+
+#if defined(__AVX2__)
+/** Lane sums of the L x R accumulators of q8_dot */
+template <os_int32_t L, os_int32_t R>
+static inline void q8_reduce(const __m256i* acc, os_int32_t* out)
+{
+    UAI_QGEMM_UNROLL
+    for (os_int32_t j = 0; j < L * R; j += 4) {
+        if (j + 4 <= L * R) {
+            q_hsum4_epi32(q_fold_epi32(acc[j]),
+                          q_fold_epi32(acc[j + 1]),
+                          q_fold_epi32(acc[j + 2]),
+                          q_fold_epi32(acc[j + 3]),
+                          out + j);
+        } else {
+            for (os_int32_t t = j; t < L * R; t++) {
+                out[t] = q_hsum_epi32(acc[t]);
+            }
+        }
+    }
+}
+#elif defined(__SSE2__)
+template <os_int32_t L, os_int32_t R>
+static inline void q8_reduce(const __m128i* acc, os_int32_t* out)
+{
+    UAI_QGEMM_UNROLL
+    for (os_int32_t j = 0; j < L * R; j += 4) {
+        if (j + 4 <= L * R) {
+            q_hsum4_epi32(acc[j], acc[j + 1], acc[j + 2], acc[j + 3], out + j);
+        } else {
+            for (os_int32_t t = j; t < L * R; t++) {
+                out[t] = q_hsum_epi32(acc[t]);
+            }
+        }
+    }
+}
+#endif
+
+/**
+ * Dot products of L lhs rows with R rhs rows, all of length k, with
+ * UAI_QGEMM_LHS_BIAS added to every lhs value.
+ */
+template <os_int32_t L, os_int32_t R>
+static void q8_dot(const os_int8_t* lhs,
+                   const os_int8_t* rhs,
+                   os_int32_t k,
+                   os_int32_t* out)
+{
+    os_int32_t i = 0;
+
+    UAI_QGEMM_UNROLL
+    for (os_int32_t j = 0; j < L * R; j++) {
+        out[j] = 0;
+    }
+
+#if defined(UAI_QGEMM_DPBUSD)
+    const __m256i flip = _mm256_set1_epi8((char)0x80);
+    __m256i acc[L * R];
+
+    UAI_QGEMM_UNROLL
+    for (os_int32_t j = 0; j < L * R; j++) {
+        acc[j] = _mm256_setzero_si256();
+    }
+
+    for (; i + 32 <= k; i += 32) {
+        __m256i l[L];
+        UAI_QGEMM_UNROLL
+        for (os_int32_t a = 0; a < L; a++) {
+            l[a] = _mm256_xor_si256(
+                _mm256_loadu_si256((const __m256i*)(lhs + a * k + i)), flip);
+        }
+        UAI_QGEMM_UNROLL
+        for (os_int32_t b = 0; b < R; b++) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(rhs + b * k + i));
+            UAI_QGEMM_UNROLL
+            for (os_int32_t a = 0; a < L; a++) {
+                acc[a * R + b] = UAI_QGEMM_DPBUSD(acc[a * R + b], l[a], v);
+            }
+        }
+    }
+
+    q8_reduce<L, R>(acc, out);
+#elif defined(__AVX2__)
+    /* A madd pair of int8 products fits int16 x int16 -> int32 */
+    __m256i acc[L * R];
+
+    UAI_QGEMM_UNROLL
+    for (os_int32_t j = 0; j < L * R; j++) {
+        acc[j] = _mm256_setzero_si256();
+    }
+
+    for (; i + 16 <= k; i += 16) {
+        __m256i l[L];
+        UAI_QGEMM_UNROLL
+        for (os_int32_t a = 0; a < L; a++) {
+            l[a] = _mm256_cvtepi8_epi16(
+                _mm_loadu_si128((const __m128i*)(lhs + a * k + i)));
+        }
+        UAI_QGEMM_UNROLL
+        for (os_int32_t b = 0; b < R; b++) {
+            __m256i v = _mm256_cvtepi8_epi16(
+                _mm_loadu_si128((const __m128i*)(rhs + b * k + i)));
+            UAI_QGEMM_UNROLL
+            for (os_int32_t a = 0; a < L; a++) {
+                __m256i p = _mm256_madd_epi16(l[a], v);
+                acc[a * R + b] = _mm256_add_epi32(acc[a * R + b], p);
+            }
+        }
+    }
+
+    q8_reduce<L, R>(acc, out);
+#elif defined(__SSE2__)
+    __m128i acc[L * R];
+
+    UAI_QGEMM_UNROLL
+    for (os_int32_t j = 0; j < L * R; j++) {
+        acc[j] = _mm_setzero_si128();
+    }
+
+    for (; i + 8 <= k; i += 8) {
+        __m128i l[L];
+        UAI_QGEMM_UNROLL
+        for (os_int32_t a = 0; a < L; a++) {
+            l[a] = q_load_s8x8(lhs + a * k + i);
+        }
+        UAI_QGEMM_UNROLL
+        for (os_int32_t b = 0; b < R; b++) {
+            __m128i v = q_load_s8x8(rhs + b * k + i);
+            UAI_QGEMM_UNROLL
+            for (os_int32_t a = 0; a < L; a++) {
+                acc[a * R + b] =
+                    _mm_add_epi32(acc[a * R + b], _mm_madd_epi16(l[a], v));
+            }
+        }
+    }
+
+    q8_reduce<L, R>(acc, out);
+#endif
+
+    UAI_QGEMM_UNROLL
+    for (os_int32_t a = 0; a < L; a++) {
+        UAI_QGEMM_UNROLL
+        for (os_int32_t b = 0; b < R; b++) {
+            const os_int8_t* l = lhs + a * k;
+            const os_int8_t* v = rhs + b * k;
+            os_int32_t sum = 0;
+            for (os_int32_t t = i; t < k; t++) {
+                sum += (l[t] + UAI_QGEMM_LHS_BIAS) * v[t];
+            }
+            out[a * R + b] += sum;
+        }
+    }
+}
+
+struct q8_args
+{
+    const os_int8_t* lhs;
+    const os_int8_t* rhs;
+    const os_int32_t* bias;
+    os_int8_t* dst;
+    const os_int32_t* multipliers; /* Per channel, or OS_NULL */
+    const os_int32_t* shifts;
+    os_int32_t multiplier;
+    os_int32_t shift;
+    os_int32_t lhs_rows;
+    os_int32_t rhs_rows;
+    os_int32_t rhs_cols;
+    os_int32_t lhs_offset;
+    os_int32_t dst_offset;
+    os_int32_t activation_min;
+    os_int32_t activation_max;
+};
+
+/** Requantise a rows x cols tile of raw dots into dst at (r, c) */
+static void q8_store(const q8_args* q,
+                     const os_int32_t* acc,
+                     os_int32_t rows,
+                     os_int32_t cols,
+                     os_int32_t r,
+                     os_int32_t c,
+                     const os_int32_t* sums)
+{
+    os_uint32_t offset = (os_uint32_t)(q->lhs_offset - UAI_QGEMM_LHS_BIAS);
+
+    for (os_int32_t a = 0; a < rows; a++) {
+        os_int8_t* dst = q->dst + (os_size_t)(r + a) * q->rhs_rows;
+
+        for (os_int32_t b = 0; b < cols; b++) {
+            os_int32_t ch = c + b;
+
+            /* Wraps around like the int32 sum of CMSIS-NN */
+            os_uint32_t sum = (os_uint32_t)acc[a * cols + b] +
+                              offset * (os_uint32_t)sums[b];
+            if (q->bias != OS_NULL) {
+                sum += (os_uint32_t)q->bias[ch];
+            }
+
+            os_int32_t mult =
+                q->multipliers ? q->multipliers[ch] : q->multiplier;
+            os_int32_t shift = q->shifts ? q->shifts[ch] : q->shift;
+
+            os_int32_t val = q_requantize((os_int32_t)sum, mult, shift);
+            val = q_clamp(val + q->dst_offset,
+                          q->activation_min,
+                          q->activation_max);
+            dst[ch] = (os_int8_t)val;
+        }
+    }
+}
+
+/** L lhs rows from r against the rhs rows c0 ... c1 - 1 */
+template <os_int32_t L>
+static void q8_tile(const q8_args* q,
+                    os_int32_t r,
+                    os_int32_t c0,
+                    os_int32_t c1,
+                    const os_int32_t* sums)
+{
+    os_int32_t k = q->rhs_cols;
+    const os_int8_t* lhs = q->lhs + (os_size_t)r * k;
+    os_int32_t acc[L * 4];
+    os_int32_t c = c0;
+
+    for (; c + 4 <= c1; c += 4) {
+        q8_dot<L, 4>(lhs, q->rhs + (os_size_t)c * k, k, acc);
+        q8_store(q, acc, L, 4, r, c, sums + (c - c0));
+    }
+    for (; c < c1; c++) {
+        q8_dot<L, 1>(lhs, q->rhs + (os_size_t)c * k, k, acc);
+        q8_store(q, acc, L, 1, r, c, sums + (c - c0));
+    }
+}
+
+/** lhs rows r0 ... r1 - 1 against every rhs row, rhs walked in L2 blocks */
+static void q8_rows(const q8_args* q, os_int32_t r0, os_int32_t r1)
+{
+    os_int32_t k = q->rhs_cols;
+    os_int32_t sums[NUMDL_QGEMM_RHS_BLOCK];
+
+    for (os_int32_t c0 = 0; c0 < q->rhs_rows; c0 += NUMDL_QGEMM_RHS_BLOCK) {
+        os_int32_t c1 = q->rhs_rows - c0 < NUMDL_QGEMM_RHS_BLOCK
+                            ? q->rhs_rows
+                            : c0 + NUMDL_QGEMM_RHS_BLOCK;
+
+        q8_row_sums(q->rhs + (os_size_t)c0 * k, k, c1 - c0, sums);
+
+        os_int32_t r = r0;
+        for (; r + 2 <= r1; r += 2) {
+            q8_tile<2>(q, r, c0, c1, sums);
+        }
+        for (; r < r1; r++) {
+            q8_tile<1>(q, r, c0, c1, sums);
+        }
+    }
+}
+
+static void q8_task(void* arg, os_size_t index)
+{
+    const q8_args* q = (const q8_args*)arg;
+    os_int32_t r0 = (os_int32_t)index * UAI_QGEMM_LHS_BLOCK;
+    os_int32_t r1 = q->lhs_rows - r0 < UAI_QGEMM_LHS_BLOCK
+                        ? q->lhs_rows
+                        : r0 + UAI_QGEMM_LHS_BLOCK;
+
+    q8_rows(q, r0, r1);
+}
+
+/**
+ * R dot products of one s16 lhs row with R consecutive s8 rhs rows of length
+ * k, into 64 bit sums.
+ */
+template <os_int32_t R>
+static void q16_dot(const os_int16_t* lhs,
+                    const os_int8_t* rhs,
+                    os_int32_t k,
+                    os_int64_t* out)
+{
+    os_int64_t sum[R];
+    os_int32_t i = 0;
+
+    UAI_QGEMM_UNROLL
+    for (os_int32_t r = 0; r < R; r++) {
+        sum[r] = 0;
+    }
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    /* A madd lane grows by at most 2^23 per step, move the lanes to 64 bit
+     * every 128 steps before they can overflow */
+#if defined(__AVX2__)
+    const os_int32_t step = 16;
+#else
+    const os_int32_t step = 8;
+#endif
+    while (i + step <= k) {
+        os_int32_t end = k - i > step * 128 ? i + step * 128 : k;
+
+#if defined(__AVX2__)
+        __m256i acc[R];
+        UAI_QGEMM_UNROLL
+        for (os_int32_t r = 0; r < R; r++) {
+            acc[r] = _mm256_setzero_si256();
+        }
+        for (; i + step <= end; i += step) {
+            __m256i l = _mm256_loadu_si256((const __m256i*)(lhs + i));
+            UAI_QGEMM_UNROLL
+            for (os_int32_t r = 0; r < R; r++) {
+                __m256i v = _mm256_cvtepi8_epi16(
+                    _mm_loadu_si128((const __m128i*)(rhs + r * k + i)));
+                acc[r] = _mm256_add_epi32(acc[r], _mm256_madd_epi16(l, v));
+            }
+        }
+#else
+        __m128i acc[R];
+        UAI_QGEMM_UNROLL
+        for (os_int32_t r = 0; r < R; r++) {
+            acc[r] = _mm_setzero_si128();
+        }
+        for (; i + step <= end; i += step) {
+            __m128i l = _mm_loadu_si128((const __m128i*)(lhs + i));
+            UAI_QGEMM_UNROLL
+            for (os_int32_t r = 0; r < R; r++) {
+                __m128i v = q_load_s8x8(rhs + r * k + i);
+                acc[r] = _mm_add_epi32(acc[r], _mm_madd_epi16(l, v));
+            }
+        }
+#endif
+
+        UAI_QGEMM_UNROLL
+        for (os_int32_t r = 0; r < R; r++) {
+            sum[r] += q_hsum_epi32_s64(acc[r]);
+        }
+    }
+#endif
+
+    for (; i < k; i++) {
+        os_int64_t l = lhs[i];
+        UAI_QGEMM_UNROLL
+        for (os_int32_t r = 0; r < R; r++) {
+            sum[r] += l * rhs[r * k + i];
+        }
+    }
+
+    UAI_QGEMM_UNROLL
+    for (os_int32_t r = 0; r < R; r++) {
+        out[r] = sum[r];
+    }
+}
+
+struct q16_args
+{
+    const os_int16_t* lhs;
+    const os_int8_t* rhs;
+    const os_int64_t* bias;
+    os_int16_t* dst;
+    os_int32_t multiplier;
+    os_int32_t shift;
+    os_int32_t lhs_rows;
+    os_int32_t rhs_rows;
+    os_int32_t rhs_cols;
+    os_int32_t activation_min;
+    os_int32_t activation_max;
+};
+
+static void q16_store(const q16_args* q,
+                      const os_int64_t* acc,
+                      os_int32_t count,
+                      os_int32_t ch,
+                      os_int16_t* dst)
+{
+    for (os_int32_t j = 0; j < count; j++, ch++) {
+        os_int64_t val = acc[j];
+        if (q->bias != OS_NULL) {
+            val += q->bias[ch];
+        }
+
+        os_int32_t res = q_requantize_s64(val, q->multiplier, q->shift);
+        res = q_clamp(res, q->activation_min, q->activation_max);
+        dst[ch] = (os_int16_t)res;
+    }
+}
+
+static void q16_rows(const q16_args* q, os_int32_t r0, os_int32_t r1)
+{
+    os_int32_t k = q->rhs_cols;
+
+    for (os_int32_t c0 = 0; c0 < q->rhs_rows; c0 += NUMDL_QGEMM_RHS_BLOCK) {
+        os_int32_t c1 = q->rhs_rows - c0 < NUMDL_QGEMM_RHS_BLOCK
+                            ? q->rhs_rows
+                            : c0 + NUMDL_QGEMM_RHS_BLOCK;
+
+        for (os_int32_t r = r0; r < r1; r++) {
+            const os_int16_t* lhs = q->lhs + (os_size_t)r * k;
+            os_int16_t* dst = q->dst + (os_size_t)r * q->rhs_rows;
+            os_int64_t acc[4];
+            os_int32_t c = c0;
+
+            for (; c + 4 <= c1; c += 4) {
+                q16_dot<4>(lhs, q->rhs + (os_size_t)c * k, k, acc);
+                q16_store(q, acc, 4, c, dst);
+            }
+            for (; c < c1; c++) {
+                q16_dot<1>(lhs, q->rhs + (os_size_t)c * k, k, acc);
+                q16_store(q, acc, 1, c, dst);
+            }
+        }
+    }
+}
+
+static void q16_task(void* arg, os_size_t index)
+{
+    const q16_args* q = (const q16_args*)arg;
+    os_int32_t r0 = (os_int32_t)index * UAI_QGEMM_LHS_BLOCK;
+    os_int32_t r1 = q->lhs_rows - r0 < UAI_QGEMM_LHS_BLOCK
+                        ? q->lhs_rows
+                        : r0 + UAI_QGEMM_LHS_BLOCK;
+
+    q16_rows(q, r0, r1);
+}
+
+/** Split the lhs rows across the pool when the product is large enough */
+static int q_run(thread_task_t task,
+                 void* arg,
+                 os_int32_t lhs_rows,
+                 os_int32_t rhs_rows,
+                 os_int32_t rhs_cols)
+{
+    os_size_t blocks =
+        ((os_size_t)lhs_rows + UAI_QGEMM_LHS_BLOCK - 1) / UAI_QGEMM_LHS_BLOCK;
+
+    if ((double)lhs_rows * rhs_rows * rhs_cols < NUMDL_GEMM_PARALLEL_MIN) {
+        for (os_size_t i = 0; i < blocks; i++) {
+            task(arg, i);
+        }
+        return NUMDL_EOK;
+    }
+
+    return thread_pool::run(task, arg, blocks);
+}
+
+/**
+ * s8 matrix multiply, lhs (lhs_rows x rhs_cols) times the transpose of rhs
+ * (rhs_rows x rhs_cols), with per-channel requantisation. Bit exact with
+ * arm_nn_mat_mult_nt_t_s8.
+ *
+ * @param lhs             [in]  Left-hand side matrix
+ * @param rhs             [in]  Right-hand side matrix, one row per channel
+ * @param bias            [in]  One value per channel, or OS_NULL
+ * @param dst             [out] Output matrix (lhs_rows x rhs_rows)
+ * @param dst_multipliers [in]  One multiplier per channel
+ * @param dst_shifts      [in]  One shift per channel
+ * @param lhs_rows        [in]  Rows of lhs
+ * @param rhs_rows        [in]  Rows of rhs, number of channels
+ * @param rhs_cols        [in]  Columns of lhs and rhs
+ * @param lhs_offset      [in]  Added to every lhs value, -127 ~ 128
+ * @param dst_offset      [in]  Added to every output, -128 ~ 127
+ * @param activation_min  [in]  Lower clamp of the output
+ * @param activation_max  [in]  Upper clamp of the output
+ *
+ * @returns 0 if OK
+ */
+int qgemm::mat_mult_nt_t_s8(const os_int8_t* lhs,
+                            const os_int8_t* rhs,
+                            const os_int32_t* bias,
+                            os_int8_t* dst,
+                            const os_int32_t* dst_multipliers,
+                            const os_int32_t* dst_shifts,
+                            os_int32_t lhs_rows,
+                            os_int32_t rhs_rows,
+                            os_int32_t rhs_cols,
+                            os_int32_t lhs_offset,
+                            os_int32_t dst_offset,
+                            os_int32_t activation_min,
+                            os_int32_t activation_max)
+{
+    NUMDL_ASSERT(lhs != OS_NULL);
+    NUMDL_ASSERT(rhs != OS_NULL);
+    NUMDL_ASSERT(dst != OS_NULL);
+    NUMDL_ASSERT(dst_multipliers != OS_NULL);
+    NUMDL_ASSERT(dst_shifts != OS_NULL);
+
+    if (lhs_rows < 0 || rhs_rows < 0 || rhs_cols < 0) {
+        ERROR("Invalid qgemm size(%d, %d, %d).", lhs_rows, rhs_rows, rhs_cols);
+        return NUMDL_EINVAL;
+    }
+
+    q8_args q;
+    q.lhs = lhs;
+    q.rhs = rhs;
+    q.bias = bias;
+    q.dst = dst;
+    q.multipliers = dst_multipliers;
+    q.shifts = dst_shifts;
+    q.multiplier = 0;
+    q.shift = 0;
+    q.lhs_rows = lhs_rows;
+    q.rhs_rows = rhs_rows;
+    q.rhs_cols = rhs_cols;
+    q.lhs_offset = lhs_offset;
+    q.dst_offset = dst_offset;
+    q.activation_min = activation_min;
+    q.activation_max = activation_max;
+
+    return q_run(q8_task, &q, lhs_rows, rhs_rows, rhs_cols);
+}
+
+/**
+ * s8 vector times the transpose of a s8 matrix with one requantisation for
+ * all channels. Bit exact with arm_nn_vec_mat_mult_t_s8.
+ *
+ * @param lhs            [in]  Input vector (rhs_cols)
+ * @param rhs            [in]  Matrix (rhs_rows x rhs_cols)
+ * @param bias           [in]  One value per row of rhs, or OS_NULL
+ * @param dst            [out] Output vector (rhs_rows)
+ * @param lhs_offset     [in]  Added to every lhs value, -127 ~ 128
+ * @param rhs_offset     [in]  Not used, kept for the CMSIS-NN signature
+ * @param dst_offset     [in]  Added to every output, -128 ~ 127
+ * @param dst_multiplier [in]  Output multiplier
+ * @param dst_shift      [in]  Output shift
+ * @param rhs_cols       [in]  Columns of rhs
+ * @param rhs_rows       [in]  Rows of rhs
+ * @param activation_min [in]  Lower clamp of the output
+ * @param activation_max [in]  Upper clamp of the output
+ *
+ * @returns 0 if OK
+ */
+int qgemm::vec_mat_mult_t_s8(const os_int8_t* lhs,
+                             const os_int8_t* rhs,
+                             const os_int32_t* bias,
+                             os_int8_t* dst,
+                             os_int32_t lhs_offset,
+                             os_int32_t rhs_offset,
+                             os_int32_t dst_offset,
+                             os_int32_t dst_multiplier,
+                             os_int32_t dst_shift,
+                             os_int32_t rhs_cols,
+                             os_int32_t rhs_rows,
+                             os_int32_t activation_min,
+                             os_int32_t activation_max)
+{
+    NUMDL_ASSERT(lhs != OS_NULL);
+    NUMDL_ASSERT(rhs != OS_NULL);
+    NUMDL_ASSERT(dst != OS_NULL);
+    (void)rhs_offset;
+
+    if (rhs_rows < 0 || rhs_cols < 0) {
+        ERROR("Invalid qgemm size(%d, %d).", rhs_rows, rhs_cols);
+        return NUMDL_EINVAL;
+    }
+
+    q8_args q;
+    q.lhs = lhs;
+    q.rhs = rhs;
+    q.bias = bias;
+    q.dst = dst;
+    q.multipliers = OS_NULL;
+    q.shifts = OS_NULL;
+    q.multiplier = dst_multiplier;
+    q.shift = dst_shift;
+    q.lhs_rows = 1;
+    q.rhs_rows = rhs_rows;
+    q.rhs_cols = rhs_cols;
+    q.lhs_offset = lhs_offset;
+    q.dst_offset = dst_offset;
+    q.activation_min = activation_min;
+    q.activation_max = activation_max;
+
+    q8_rows(&q, 0, 1);
+
+    return NUMDL_EOK;
+}
+
+/**
+ * s16 matrix times the transpose of a s8 matrix, 64 bit accumulation. Every
+ * row gives the same outputs as arm_nn_vec_mat_mult_t_s16 on that row.
+ *
+ * @param lhs            [in]  Input matrix (lhs_rows x rhs_cols)
+ * @param rhs            [in]  Matrix (rhs_rows x rhs_cols)
+ * @param bias           [in]  One value per row of rhs, or OS_NULL
+ * @param dst            [out] Output matrix (lhs_rows x rhs_rows)
+ * @param dst_multiplier [in]  Reduced output multiplier, see
+ *                             reduce_multiplier()
+ * @param dst_shift      [in]  Output shift
+ * @param lhs_rows       [in]  Rows of lhs
+ * @param rhs_rows       [in]  Rows of rhs
+ * @param rhs_cols       [in]  Columns of lhs and rhs
+ * @param activation_min [in]  Lower clamp of the output
+ * @param activation_max [in]  Upper clamp of the output
+ *
+ * @returns 0 if OK
+ */
+int qgemm::mat_mult_nt_t_s16(const os_int16_t* lhs,
+                             const os_int8_t* rhs,
+                             const os_int64_t* bias,
+                             os_int16_t* dst,
+                             os_int32_t dst_multiplier,
+                             os_int32_t dst_shift,
+                             os_int32_t lhs_rows,
+                             os_int32_t rhs_rows,
+                             os_int32_t rhs_cols,
+                             os_int32_t activation_min,
+                             os_int32_t activation_max)
+{
+    NUMDL_ASSERT(lhs != OS_NULL);
+    NUMDL_ASSERT(rhs != OS_NULL);
+    NUMDL_ASSERT(dst != OS_NULL);
+
+    if (lhs_rows < 0 || rhs_rows < 0 || rhs_cols < 0) {
+        ERROR("Invalid qgemm size(%d, %d, %d).", lhs_rows, rhs_rows, rhs_cols);
+        return NUMDL_EINVAL;
+    }
+
+    q16_args q;
+    q.lhs = lhs;
+    q.rhs = rhs;
+    q.bias = bias;
+    q.dst = dst;
+    q.multiplier = dst_multiplier;
+    q.shift = dst_shift;
+    q.lhs_rows = lhs_rows;
+    q.rhs_rows = rhs_rows;
+    q.rhs_cols = rhs_cols;
+    q.activation_min = activation_min;
+    q.activation_max = activation_max;
+
+    return q_run(q16_task, &q, lhs_rows, rhs_rows, rhs_cols);
+}
+
+/**
+ * s16 vector times the transpose of a s8 matrix. Bit exact with
+ * arm_nn_vec_mat_mult_t_s16.
+ *
+ * @param lhs            [in]  Input vector (rhs_cols)
+ * @param rhs            [in]  Matrix (rhs_rows x rhs_cols)
+ * @param bias           [in]  One value per row of rhs, or OS_NULL
+ * @param dst            [out] Output vector (rhs_rows)
+ * @param dst_multiplier [in]  Reduced output multiplier, see
+ *                             reduce_multiplier()
+ * @param dst_shift      [in]  Output shift
+ * @param rhs_cols       [in]  Columns of rhs
+ * @param rhs_rows       [in]  Rows of rhs
+ * @param activation_min [in]  Lower clamp of the output
+ * @param activation_max [in]  Upper clamp of the output
+ *
+ * @returns 0 if OK
+ */
+int qgemm::vec_mat_mult_t_s16(const os_int16_t* lhs,
+                              const os_int8_t* rhs,
+                              const os_int64_t* bias,
+                              os_int16_t* dst,
+                              os_int32_t dst_multiplier,
+                              os_int32_t dst_shift,
+                              os_int32_t rhs_cols,
+                              os_int32_t rhs_rows,
+                              os_int32_t activation_min,
+                              os_int32_t activation_max)
+{
+    return mat_mult_nt_t_s16(lhs,
+                             rhs,
+                             bias,
+                             dst,
+                             dst_multiplier,
+                             dst_shift,
+                             1,
+                             rhs_rows,
+                             rhs_cols,
+                             activation_min,
+                             activation_max);
+}
+
+/**
+ * (val * multiplier) / 2^-shift with the rounding of arm_nn_requantize
+ *
+ * @param val        [in] Value to requantise
+ * @param multiplier [in] Q31 multiplier
+ * @param shift      [in] Left shift if positive, right shift if negative
+ *
+ * @returns Requantised value
+ */
+os_int32_t qgemm::requantize(os_int32_t val,
+                             os_int32_t multiplier,
+                             os_int32_t shift)
+{
+    return q_requantize(val, multiplier, shift);
+}
+
+/**
+ * 64 bit requantisation of arm_nn_requantize_s64, used by the s16 kernels
+ *
+ * @param val                [in] Value to requantise
+ * @param reduced_multiplier [in] Multiplier from reduce_multiplier()
+ * @param shift              [in] Left shift if positive, right if negative
+ *
+ * @returns Requantised value
+ */
+os_int32_t qgemm::requantize_s64(os_int64_t val,
+                                 os_int32_t reduced_multiplier,
+                                 os_int32_t shift)
+{
+    return q_requantize_s64(val, reduced_multiplier, shift);
+}
+
+/**
+ * Reduce a Q31 multiplier to the Q15 one the s16 kernels take, same as the
+ * REDUCE_MULTIPLIER macro of CMSIS-NN
+ *
+ * @param multiplier [in] Q31 multiplier
+ *
+ * @returns Reduced multiplier
+ */
+os_int32_t qgemm::reduce_multiplier(os_int32_t multiplier)
+{
+    return multiplier < 0x7FFF0000 ? (multiplier + (1 << 15)) >> 16 : 0x7FFF;
+}
+
+/**
+ * Split a real scale into a Q31 multiplier and a shift, as done by the
+ * converters that produce CMSIS-NN models
+ *
+ * @param scale      [in]  Real scale, >= 0
+ * @param multiplier [out] Q31 multiplier
+ * @param shift      [out] Left shift if positive, right shift if negative
+ */
+void qgemm::quantize_multiplier(double scale,
+                                os_int32_t* multiplier,
+                                os_int32_t* shift)
+{
+    NUMDL_ASSERT(multiplier != OS_NULL);
+    NUMDL_ASSERT(shift != OS_NULL);
+
+    if (scale <= 0.0) {
+        *multiplier = 0;
+        *shift = 0;
+        return;
+    }
+
+    int exponent;
+    double fraction = frexp(scale, &exponent);
+    os_int64_t q = (os_int64_t)round(fraction * 2147483648.0);
+
+    if (q == ((os_int64_t)1 << 31)) {
+        q /= 2;
+        exponent++;
+    }
+    if (exponent < -31) {
+        q = 0;
+        exponent = 0;
+    }
+
+    *multiplier = (os_int32_t)q;
+    *shift = exponent;
+}
+
+};  // namespace feature
+};  // namespace uai
@@ -0,0 +1,125 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_qgemm.h
+ *
+ * @brief       Quantised int8/int16 matrix multiply with the requantisation
+ *              semantics of CMSIS-NN, so host results are bit exact with the
+ *              MCU build.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#ifndef __UAI_QGEMM_H__
+#define __UAI_QGEMM_H__
+
+#include <os_stddef.h>
+
+/** Rows of the transposed right-hand side kept in L2 per block */
+#ifndef NUMDL_QGEMM_RHS_BLOCK
+#define NUMDL_QGEMM_RHS_BLOCK (64)
+#endif
+
+/** Rows of the left-hand side handed to one thread pool task */
+#define UAI_QGEMM_LHS_BLOCK (16)
+
+namespace uai {
+namespace feature {
+
+/**
+ * Every kernel computes, for each output,
+ *     acc = bias + sum((lhs + lhs_offset) * rhs)
+ *     out = clamp(requantize(acc, multiplier, shift) + dst_offset,
+ *                 activation_min, activation_max)
+ * with the rhs matrix stored transposed (one row per output channel), the
+ * same as arm_nn_mat_mult_nt_t_s8, arm_nn_vec_mat_mult_t_s8 and
+ * arm_nn_vec_mat_mult_t_s16. Integer sums are exact, so SIMD and scalar
+ * paths give identical outputs.
+ */
+class qgemm
+{
+public:
+    static int mat_mult_nt_t_s8(const os_int8_t* lhs,
+                                const os_int8_t* rhs,
+                                const os_int32_t* bias,
+                                os_int8_t* dst,
+                                const os_int32_t* dst_multipliers,
+                                const os_int32_t* dst_shifts,
+                                os_int32_t lhs_rows,
+                                os_int32_t rhs_rows,
+                                os_int32_t rhs_cols,
+                                os_int32_t lhs_offset,
+                                os_int32_t dst_offset,
+                                os_int32_t activation_min,
+                                os_int32_t activation_max);
+
+    static int vec_mat_mult_t_s8(const os_int8_t* lhs,
+                                 const os_int8_t* rhs,
+                                 const os_int32_t* bias,
+                                 os_int8_t* dst,
+                                 os_int32_t lhs_offset,
+                                 os_int32_t rhs_offset,
+                                 os_int32_t dst_offset,
+                                 os_int32_t dst_multiplier,
+                                 os_int32_t dst_shift,
+                                 os_int32_t rhs_cols,
+                                 os_int32_t rhs_rows,
+                                 os_int32_t activation_min,
+                                 os_int32_t activation_max);
+
+    static int mat_mult_nt_t_s16(const os_int16_t* lhs,
+                                 const os_int8_t* rhs,
+                                 const os_int64_t* bias,
+                                 os_int16_t* dst,
+                                 os_int32_t dst_multiplier,
+                                 os_int32_t dst_shift,
+                                 os_int32_t lhs_rows,
+                                 os_int32_t rhs_rows,
+                                 os_int32_t rhs_cols,
+                                 os_int32_t activation_min,
+                                 os_int32_t activation_max);
+
+    static int vec_mat_mult_t_s16(const os_int16_t* lhs,
+                                  const os_int8_t* rhs,
+                                  const os_int64_t* bias,
+                                  os_int16_t* dst,
+                                  os_int32_t dst_multiplier,
+                                  os_int32_t dst_shift,
+                                  os_int32_t rhs_cols,
+                                  os_int32_t rhs_rows,
+                                  os_int32_t activation_min,
+                                  os_int32_t activation_max);
+
+    static os_int32_t requantize(os_int32_t val,
+                                 os_int32_t multiplier,
+                                 os_int32_t shift);
+    static os_int32_t requantize_s64(os_int64_t val,
+                                     os_int32_t reduced_multiplier,
+                                     os_int32_t shift);
+    static os_int32_t reduce_multiplier(os_int32_t multiplier);
+    static void quantize_multiplier(double scale,
+                                    os_int32_t* multiplier,
+                                    os_int32_t* shift);
+};
+
+};  // namespace feature
+};  // namespace uai
+
+#endif /* __UAI_QGEMM_H__ */
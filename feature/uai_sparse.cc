@@ -0,0 +1,419 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_sparse.cc
+ *
+ * @brief       Sparse (CSR) and block sparse (BSR) matrix products for pruned
+ *              weights, the zero elements and blocks are never touched.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_sparse.h"
+#include "uai_gemm.h"
+#include "uai_thread_pool.h"
+#include "nd_errno.h"
+
+#define NUMDL_LOG_TAG "uai.sparse"
+#include "nd_log.h"
+
+#include <string.h>
+
+#include <nd_assert.h>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace uai {
+namespace feature {
+
+/**
+ * y[0 ... n - 1] += v[0] * x[0][...] + ... + v[R - 1] * x[R - 1][...]. R rows
+ * of the dense operand per pass keep the output row out of memory R times.
+ */
+template <os_size_t R>
+static void sparse_axpy_rows(os_size_t n,
+                             const float* v,
+                             const float* const* x,
+                             float* y)
+{
+    os_size_t j = 0;
+
+#if defined(__SSE__)
+    __m128 vv[R];
+    for (os_size_t r = 0; r < R; r++) {
+        vv[r] = _mm_set1_ps(v[r]);
+    }
+
+    for (; j + 8 <= n; j += 8) {
+        __m128 y0 = _mm_loadu_ps(y + j);
+        __m128 y1 = _mm_loadu_ps(y + j + 4);
+        for (os_size_t r = 0; r < R; r++) {
+            y0 = _mm_add_ps(y0, _mm_mul_ps(vv[r], _mm_loadu_ps(x[r] + j)));
+            y1 = _mm_add_ps(y1, _mm_mul_ps(vv[r], _mm_loadu_ps(x[r] + j + 4)));
+        }
+        _mm_storeu_ps(y + j, y0);
+        _mm_storeu_ps(y + j + 4, y1);
+    }
+#endif
+
+    for (; j < n; j++) {
+        float sum = y[j];
+        for (os_size_t r = 0; r < R; r++) {
+            sum += v[r] * x[r][j];
+        }
+        y[j] = sum;
+    }
+}
+
+/** y += sum of v[i] * x[i], the rows of x given by pointer */
+static void sparse_axpy(os_size_t n,
+                        os_size_t cnt,
+                        const float* v,
+                        const float* const* x,
+                        float* y)
+{
+    os_size_t p = 0;
+
+    for (; p + 4 <= cnt; p += 4) {
+        sparse_axpy_rows<4>(n, v + p, x + p, y);
+    }
+    for (; p < cnt; p++) {
+        sparse_axpy_rows<1>(n, v + p, x + p, y);
+    }
+}
+
+struct sparse_task
+{
+    const uai_mat_csr_t* csr;
+    const uai_mat_bsr_t* bsr;
+    os_size_t n;
+    const float* b;
+    os_size_t ldb;
+    float* c;
+    os_size_t ldc;
+    os_size_t rows; /* Rows, or block rows for BSR */
+};
+
+static void csr_mm_task(void* arg, os_size_t index)
+{
+    const sparse_task* t = (const sparse_task*)arg;
+    const uai_mat_csr_t* a = t->csr;
+    os_size_t i0 = index * UAI_SPARSE_ROWS;
+    os_size_t i1 = i0 + UAI_SPARSE_ROWS < t->rows ? i0 + UAI_SPARSE_ROWS
+                                                  : t->rows;
+    const float* rows[4];
+
+    for (os_size_t i = i0; i < i1; i++) {
+        float* c = t->c + i * t->ldc;
+        os_size_t p = a->row_ptr[i];
+        os_size_t end = a->row_ptr[i + 1];
+
+        memset(c, 0, t->n * sizeof(float));
+
+        for (; p + 4 <= end; p += 4) {
+            for (os_size_t r = 0; r < 4; r++) {
+                rows[r] = t->b + a->col_idx[p + r] * t->ldb;
+            }
+            sparse_axpy_rows<4>(t->n, a->val + p, rows, c);
+        }
+        for (; p < end; p++) {
+            rows[0] = t->b + a->col_idx[p] * t->ldb;
+            sparse_axpy_rows<1>(t->n, a->val + p, rows, c);
+        }
+    }
+}
+
+static void bsr_mm_task(void* arg, os_size_t index)
+{
+    const sparse_task* t = (const sparse_task*)arg;
+    const uai_mat_bsr_t* a = t->bsr;
+    os_size_t br = a->block_rows;
+    os_size_t bc = a->block_cols;
+    os_size_t i0 = index * UAI_SPARSE_ROWS;
+    os_size_t i1 = i0 + UAI_SPARSE_ROWS < t->rows ? i0 + UAI_SPARSE_ROWS
+                                                  : t->rows;
+    const float* rows[16];
+
+    for (os_size_t i = i0; i < i1; i++) {
+        os_size_t row = i * br;
+        os_size_t rcnt = row + br < a->rows ? br : a->rows - row;
+
+        for (os_size_t r = 0; r < rcnt; r++) {
+            memset(t->c + (row + r) * t->ldc, 0, t->n * sizeof(float));
+        }
+
+        for (os_size_t b = a->row_ptr[i]; b < a->row_ptr[i + 1]; b++) {
+            os_size_t col = a->col_idx[b] * bc;
+            os_size_t ccnt = col + bc < a->cols ? bc : a->cols - col;
+            const float* blk = a->val + b * br * bc;
+
+            /* Rows of B touched by the block, shared by its rows */
+            for (os_size_t c0 = 0; c0 < ccnt; c0 += 16) {
+                os_size_t cnt = ccnt - c0 < 16 ? ccnt - c0 : 16;
+                for (os_size_t q = 0; q < cnt; q++) {
+                    rows[q] = t->b + (col + c0 + q) * t->ldb;
+                }
+                for (os_size_t r = 0; r < rcnt; r++) {
+                    sparse_axpy(t->n,
+                                cnt,
+                                blk + r * bc + c0,
+                                rows,
+                                t->c + (row + r) * t->ldc);
+                }
+            }
+        }
+    }
+}
+
+static int sparse_run(thread_task_t task, sparse_task* t, os_size_t work)
+{
+    os_size_t count = (t->rows + UAI_SPARSE_ROWS - 1) / UAI_SPARSE_ROWS;
+
+    if (work < NUMDL_GEMM_PARALLEL_MIN) {
+        for (os_size_t i = 0; i < count; i++) {
+            task(t, i);
+        }
+        return NUMDL_EOK;
+    }
+
+    return thread_pool::run(task, t, count);
+}
+
+/**
+ * C = A * B with a CSR matrix A (m x k) and a dense B (k x n)
+ *
+ * @param a   [in]  Pointer to CSR matrix
+ * @param n   [in]  Columns of B and C
+ * @param b   [in]  Dense matrix B
+ * @param ldb [in]  Distance in elements between two rows of B
+ * @param c   [out] Dense matrix C (m x n)
+ * @param ldc [in]  Distance in elements between two rows of C
+ *
+ * @returns 0 if OK
+ */
+int sparse::csr_mm(const uai_mat_csr_t* a,
+                   os_size_t n,
+                   const float* b,
+                   os_size_t ldb,
+                   float* c,
+                   os_size_t ldc)
+{
+    NUMDL_ASSERT(a != OS_NULL);
+    NUMDL_ASSERT(b != OS_NULL);
+    NUMDL_ASSERT(c != OS_NULL);
+
+    if (ldb < n || ldc < n) {
+        ERROR("Invalid leading dimension(%d, %d) for %d cols.",
+              (int)ldb,
+              (int)ldc,
+              (int)n);
+        return NUMDL_EINVAL;
+    }
+
+    sparse_task t;
+    t.csr = a;
+    t.bsr = OS_NULL;
+    t.n = n;
+    t.b = b;
+    t.ldb = ldb;
+    t.c = c;
+    t.ldc = ldc;
+    t.rows = a->rows;
+
+    return sparse_run(csr_mm_task, &t, a->nnz * n);
+}
+
+/**
+ * y = A * x with a CSR matrix A (m x k)
+ *
+ * @param a [in]  Pointer to CSR matrix
+ * @param x [in]  Input vector (k)
+ * @param y [out] Output vector (m)
+ *
+ * @returns 0 if OK
+ */
+int sparse::csr_mv(const uai_mat_csr_t* a, const float* x, float* y)
+{
+    NUMDL_ASSERT(a != OS_NULL);
+    NUMDL_ASSERT(x != OS_NULL);
+    NUMDL_ASSERT(y != OS_NULL);
+
+    for (os_size_t i = 0; i < a->rows; i++) {
+        os_size_t p = a->row_ptr[i];
+        os_size_t end = a->row_ptr[i + 1];
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+
+        for (; p + 4 <= end; p += 4) {
+            s0 += a->val[p] * x[a->col_idx[p]];
+            s1 += a->val[p + 1] * x[a->col_idx[p + 1]];
+            s2 += a->val[p + 2] * x[a->col_idx[p + 2]];
+            s3 += a->val[p + 3] * x[a->col_idx[p + 3]];
+        }
+        for (; p < end; p++) {
+            s0 += a->val[p] * x[a->col_idx[p]];
+        }
+
+        y[i] = (s0 + s1) + (s2 + s3);
+    }
+
+    return NUMDL_EOK;
+}
+
+/**
+ * C = A * B with a BSR matrix A (m x k) and a dense B (k x n)
+ *
+ * @param a   [in]  Pointer to BSR matrix
+ * @param n   [in]  Columns of B and C
+ * @param b   [in]  Dense matrix B
+ * @param ldb [in]  Distance in elements between two rows of B
+ * @param c   [out] Dense matrix C (m x n)
+ * @param ldc [in]  Distance in elements between two rows of C
+ *
+ * @returns 0 if OK
+ */
+int sparse::bsr_mm(const uai_mat_bsr_t* a,
+                   os_size_t n,
+                   const float* b,
+                   os_size_t ldb,
+                   float* c,
+                   os_size_t ldc)
+{
+    NUMDL_ASSERT(a != OS_NULL);
+    NUMDL_ASSERT(b != OS_NULL);
+    NUMDL_ASSERT(c != OS_NULL);
+
+    if (ldb < n || ldc < n) {
+        ERROR("Invalid leading dimension(%d, %d) for %d cols.",
+              (int)ldb,
+              (int)ldc,
+              (int)n);
+        return NUMDL_EINVAL;
+    }
+
+    sparse_task t;
+    t.csr = OS_NULL;
+    t.bsr = a;
+    t.n = n;
+    t.b = b;
+    t.ldb = ldb;
+    t.c = c;
+    t.ldc = ldc;
+    t.rows = (a->rows + a->block_rows - 1) / a->block_rows;
+
+    return sparse_run(
+        bsr_mm_task, &t, a->nnzb * a->block_rows * a->block_cols * n);
+}
+
+/**
+ * y = A * x with a BSR matrix A (m x k)
+ *
+ * @param a [in]  Pointer to BSR matrix
+ * @param x [in]  Input vector (k)
+ * @param y [out] Output vector (m)
+ *
+ * @returns 0 if OK
+ */
+int sparse::bsr_mv(const uai_mat_bsr_t* a, const float* x, float* y)
+{
+    NUMDL_ASSERT(a != OS_NULL);
+    NUMDL_ASSERT(x != OS_NULL);
+    NUMDL_ASSERT(y != OS_NULL);
+
+    os_size_t br = a->block_rows;
+    os_size_t bc = a->block_cols;
+    os_size_t brows = (a->rows + br - 1) / br;
+
+    for (os_size_t i = 0; i < brows; i++) {
+        os_size_t row = i * br;
+        os_size_t rcnt = row + br < a->rows ? br : a->rows - row;
+
+        /* Rows of tall blocks are done UAI_SPARSE_BLOCK_ROWS at a time */
+        for (os_size_t r0 = 0; r0 < rcnt; r0 += UAI_SPARSE_BLOCK_ROWS) {
+            os_size_t r1 = rcnt - r0 < UAI_SPARSE_BLOCK_ROWS
+                               ? rcnt
+                               : r0 + UAI_SPARSE_BLOCK_ROWS;
+            float sum[UAI_SPARSE_BLOCK_ROWS];
+#if defined(__SSE__)
+            __m128 acc[UAI_SPARSE_BLOCK_ROWS];
+#endif
+
+            for (os_size_t r = r0; r < r1; r++) {
+                sum[r - r0] = 0.0f;
+#if defined(__SSE__)
+                acc[r - r0] = _mm_setzero_ps();
+#endif
+            }
+
+            for (os_size_t b = a->row_ptr[i]; b < a->row_ptr[i + 1]; b++) {
+                os_size_t col = a->col_idx[b] * bc;
+                os_size_t ccnt = col + bc < a->cols ? bc : a->cols - col;
+                const float* blk = a->val + b * br * bc;
+                const float* xb = x + col;
+
+#if defined(__SSE__)
+                /*
+                 * Four columns, 1x4 and 4x4 blocks or the edge block of a
+                 * wider one: one product per block row
+                 */
+                if (4 == ccnt) {
+                    __m128 xv = _mm_loadu_ps(xb);
+                    for (os_size_t r = r0; r < r1; r++) {
+                        __m128 prod =
+                            _mm_mul_ps(_mm_loadu_ps(blk + r * bc), xv);
+                        acc[r - r0] = _mm_add_ps(acc[r - r0], prod);
+                    }
+                    continue;
+                }
+#endif
+
+                for (os_size_t r = r0; r < r1; r++) {
+                    const float* v = blk + r * bc;
+                    os_size_t q = 0;
+#if defined(__SSE__)
+                    for (; q + 4 <= ccnt; q += 4) {
+                        __m128 prod = _mm_mul_ps(_mm_loadu_ps(v + q),
+                                                 _mm_loadu_ps(xb + q));
+                        acc[r - r0] = _mm_add_ps(acc[r - r0], prod);
+                    }
+#endif
+                    for (; q < ccnt; q++) {
+                        sum[r - r0] += v[q] * xb[q];
+                    }
+                }
+            }
+
+            for (os_size_t r = r0; r < r1; r++) {
+#if defined(__SSE__)
+                float tmp[4];
+                _mm_storeu_ps(tmp, acc[r - r0]);
+                sum[r - r0] += (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+#endif
+                y[row + r] = sum[r - r0];
+            }
+        }
+    }
+
+    return NUMDL_EOK;
+}
+
+};  // namespace feature
+};  // namespace uai
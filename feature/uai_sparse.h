@@ -0,0 +1,68 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_sparse.h
+ *
+ * @brief       Sparse (CSR) and block sparse (BSR) matrix products for pruned
+ *              weights, the zero elements and blocks are never touched.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#ifndef __UAI_SPARSE_H__
+#define __UAI_SPARSE_H__
+
+#include "uai_matrix.h"
+
+#include <os_stddef.h>
+
+/** Rows (block rows for BSR) of the sparse matrix per thread pool task */
+#define UAI_SPARSE_ROWS (32)
+
+/** Rows of a block whose sums a BSR matrix-vector product keeps in flight */
+#define UAI_SPARSE_BLOCK_ROWS (8)
+
+namespace uai {
+namespace feature {
+
+class sparse
+{
+public:
+    static int csr_mm(const uai_mat_csr_t* a,
+                      os_size_t n,
+                      const float* b,
+                      os_size_t ldb,
+                      float* c,
+                      os_size_t ldc);
+    static int csr_mv(const uai_mat_csr_t* a, const float* x, float* y);
+
+    static int bsr_mm(const uai_mat_bsr_t* a,
+                      os_size_t n,
+                      const float* b,
+                      os_size_t ldb,
+                      float* c,
+                      os_size_t ldc);
+    static int bsr_mv(const uai_mat_bsr_t* a, const float* x, float* y);
+};
+
+};  // namespace feature
+};  // namespace uai
+
+#endif /* __UAI_SPARSE_H__ */
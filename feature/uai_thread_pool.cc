@@ -0,0 +1,286 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ * @file        uai_thread_pool.cc
+ *
+ * @brief       Reusable worker pool shared by the parallel feature kernels.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_thread_pool.h"
+#include "nd_errno.h"
+
+#define NUMDL_LOG_TAG "uai.pool"
+#include "nd_log.h"
+
+#include <nd_assert.h>
+
+#ifdef NUMDL_USING_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace uai {
+namespace feature {
+
+#ifdef NUMDL_USING_THREADS
+
+/** One run() call, lives on the caller's stack until every worker left it */
+struct pool_job
+{
+    thread_task_t task;
+    void* arg;
+    os_size_t count;
+    std::atomic<os_size_t> next;
+    os_size_t pending;
+    os_size_t active;
+};
+
+struct pool_state
+{
+    std::mutex lock;
+    std::mutex run_lock;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+    std::vector<std::thread> workers;
+    pool_job* job = OS_NULL;
+    os_size_t generation = 0;
+    os_size_t num_threads = NUMDL_THREADS_DEFAULT;
+    bool stop = false;
+
+    ~pool_state();
+};
+
+static thread_local bool tls_in_pool = false;
+
+static pool_state& pool_get(void)
+{
+    static pool_state state;
+    return state;
+}
+
+static void pool_drain(pool_state& s, pool_job* job)
+{
+    os_size_t done = 0;
+    os_size_t index;
+
+    while ((index = job->next.fetch_add(1)) < job->count) {
+        job->task(job->arg, index);
+        done++;
+    }
+
+    std::lock_guard<std::mutex> guard(s.lock);
+    job->pending -= done;
+    if (0 == job->pending && 0 == job->active) {
+        s.done_cv.notify_all();
+    }
+}
+
+static void pool_worker(pool_state* s)
+{
+    tls_in_pool = true;
+
+    std::unique_lock<std::mutex> lk(s->lock);
+    os_size_t seen = s->generation;
+
+    for (;;) {
+        s->work_cv.wait(lk,
+                        [&] { return s->stop || s->generation != seen; });
+        if (s->stop) {
+            return;
+        }
+        seen = s->generation;
+
+        pool_job* job = s->job;
+        if (OS_NULL == job) {
+            continue;
+        }
+
+        job->active++;
+        lk.unlock();
+
+        pool_drain(*s, job);
+
+        lk.lock();
+        job->active--;
+        if (0 == job->pending && 0 == job->active) {
+            s->done_cv.notify_all();
+        }
+    }
+}
+
+static void pool_stop_workers(pool_state& s)
+{
+    {
+        std::lock_guard<std::mutex> guard(s.lock);
+        s.stop = true;
+    }
+    s.work_cv.notify_all();
+
+    for (os_size_t i = 0; i < s.workers.size(); i++) {
+        s.workers[i].join();
+    }
+    s.workers.clear();
+    s.stop = false;
+}
+
+static int pool_start_workers(pool_state& s)
+{
+    os_size_t count = s.num_threads - 1;
+
+    s.workers.reserve(count);
+    for (os_size_t i = 0; i < count; i++) {
+        try {
+            s.workers.push_back(std::thread(pool_worker, &s));
+        } catch (...) {
+            ERROR("Create worker thread %d failed.", (int)i);
+            pool_stop_workers(s);
+            return NUMDL_ENOMEM;
+        }
+    }
+
+    return NUMDL_EOK;
+}
+
+pool_state::~pool_state()
+{
+    pool_stop_workers(*this);
+}
+
+#endif /* NUMDL_USING_THREADS */
+
+/**
+ * Set the number of threads used by the parallel kernels, the caller thread
+ * included. 1 runs every kernel on the caller thread.
+ *
+ * @param num [in] Number of threads, 1 ~ NUMDL_THREADS_MAX
+ *
+ * @returns 0 if OK
+ */
+int thread_pool::set_num_threads(os_size_t num)
+{
+    if (num < 1 || num > NUMDL_THREADS_MAX) {
+        ERROR("Invalid number of threads(%d).", (int)num);
+        return NUMDL_EINVAL;
+    }
+
+#ifdef NUMDL_USING_THREADS
+    pool_state& s = pool_get();
+    std::lock_guard<std::mutex> guard(s.run_lock);
+
+    if (num == s.num_threads) {
+        return NUMDL_EOK;
+    }
+
+    pool_stop_workers(s);
+    s.num_threads = num;
+
+    /* Workers are started lazily by the next run() */
+    return NUMDL_EOK;
+#else
+    if (num != 1) {
+        WARN("numDL built without NUMDL_USING_THREADS, runs single threaded.");
+    }
+    return NUMDL_EOK;
+#endif
+}
+
+/**
+ * Get the number of threads used by the parallel kernels
+ *
+ * @returns Number of threads, the caller thread included
+ */
+os_size_t thread_pool::get_num_threads(void)
+{
+#ifdef NUMDL_USING_THREADS
+    return pool_get().num_threads;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * Run task(arg, 0) ... task(arg, count - 1) on the pool and wait for all of
+ * them. The caller thread takes tasks too. Calls made from inside a task run
+ * serially on the calling worker.
+ *
+ * @param task  [in] Task function
+ * @param arg   [in] Argument passed to every task
+ * @param count [in] Number of tasks
+ *
+ * @returns 0 if OK
+ */
+int thread_pool::run(thread_task_t task, void* arg, os_size_t count)
+{
+    NUMDL_ASSERT(task != OS_NULL);
+
+#ifdef NUMDL_USING_THREADS
+    pool_state& s = pool_get();
+
+    if (count > 1 && s.num_threads > 1 && !tls_in_pool) {
+        std::lock_guard<std::mutex> run_guard(s.run_lock);
+
+        if (s.workers.size() != s.num_threads - 1) {
+            int ret = pool_start_workers(s);
+            if (ret != NUMDL_EOK) {
+                return ret;
+            }
+        }
+
+        pool_job job;
+        job.task = task;
+        job.arg = arg;
+        job.count = count;
+        job.next = 0;
+        job.pending = count;
+        job.active = 0;
+
+        {
+            std::lock_guard<std::mutex> guard(s.lock);
+            s.job = &job;
+            s.generation++;
+        }
+        s.work_cv.notify_all();
+
+        tls_in_pool = true;
+        pool_drain(s, &job);
+        tls_in_pool = false;
+
+        std::unique_lock<std::mutex> lk(s.lock);
+        s.done_cv.wait(lk,
+                       [&] { return 0 == job.pending && 0 == job.active; });
+        s.job = OS_NULL;
+
+        return NUMDL_EOK;
+    }
+#endif
+
+    for (os_size_t i = 0; i < count; i++) {
+        task(arg, i);
+    }
+
+    return NUMDL_EOK;
+}
+
+};  // namespace feature
+};  // namespace uai
@@ -0,0 +1,58 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ * @file        uai_thread_pool.h
+ *
+ * @brief       Reusable worker pool shared by the parallel feature kernels.
+ *              Without NUMDL_USING_THREADS every task runs on the caller.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#ifndef __UAI_THREAD_POOL_H__
+#define __UAI_THREAD_POOL_H__
+
+#include <os_stddef.h>
+
+#ifndef NUMDL_THREADS_DEFAULT
+#define NUMDL_THREADS_DEFAULT (1)
+#endif
+
+#ifndef NUMDL_THREADS_MAX
+#define NUMDL_THREADS_MAX (64)
+#endif
+
+namespace uai {
+namespace feature {
+
+typedef void (*thread_task_t)(void* arg, os_size_t index);
+
+class thread_pool
+{
+public:
+    static int set_num_threads(os_size_t num);
+    static os_size_t get_num_threads(void);
+
+    static int run(thread_task_t task, void* arg, os_size_t count);
+};
+
+};  // namespace feature
+};  // namespace uai
+
+#endif /* __UAI_THREAD_POOL_H__ */
@@ -0,0 +1,370 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026 China Mobile Communications Group Co.,Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file        expression.h
+ *
+ * @brief       Lazy elementwise expressions, evaluated in one fused loop on assignment
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+#ifndef __NUMDL_EXPRESSION_H__
+#define __NUMDL_EXPRESSION_H__
+
+#include "nd_assert.h"
+#include "shape.h"
+
+#include <cmath>
+
+namespace nd
+{
+    template<typename dtype>
+    class NdArray;
+
+    //================================Expression===================================
+    /// Base of every lazy expression. A node provides
+    ///     value_type, isScalar, shape(), isContiguous(),
+    ///     overlaps(array)     reads memory of array laid out another way,
+    ///     operator[](flat index)  valid when isContiguous() is true,
+    ///     operator()(row, col)
+    /// Nothing is computed until the expression is assigned to an NdArray.
+    template<typename Derived>
+    class Expression
+    {
+    public:
+        //============================================================================
+        ///						The concrete node
+        ///
+        /// @return     Derived
+        ///
+        const Derived& derived() const noexcept
+        {
+            return static_cast<const Derived&>(*this);
+        }
+    };
+
+    namespace expr
+    {
+        //============================================================================
+        /// Arrays are held by reference, the small expression nodes by value so
+        /// temporaries such as (a * b) live as long as the outer node.
+        template<typename T>
+        struct Stored
+        {
+            typedef const T type;
+        };
+
+        template<typename dtype>
+        struct Stored<NdArray<dtype>>
+        {
+            typedef const NdArray<dtype>& type;
+        };
+
+        //================================Scalar=======================================
+        /// A scalar broadcast to the shape of the other operand
+        template<typename dtype>
+        class Scalar : public Expression<Scalar<dtype>>
+        {
+        public:
+            typedef dtype value_type;
+            static constexpr bool isScalar = true;
+
+            explicit Scalar(dtype inValue) noexcept :
+                value_(inValue)
+            {
+            }
+
+            Shape shape() const noexcept
+            {
+                return Shape();
+            }
+
+            bool isContiguous() const noexcept
+            {
+                return true;
+            }
+
+            template<typename T>
+            bool overlaps(const NdArray<T>&) const noexcept
+            {
+                return false;
+            }
+
+            dtype operator[](size_type) const noexcept
+            {
+                return value_;
+            }
+
+            dtype operator()(size_type, size_type) const noexcept
+            {
+                return value_;
+            }
+
+        private:
+            dtype value_;
+        };
+
+        //================================Unary========================================
+        /// Op applied to every element of E
+        template<typename Op, typename E>
+        class Unary : public Expression<Unary<Op, E>>
+        {
+        public:
+            typedef typename E::value_type value_type;
+            static constexpr bool isScalar = E::isScalar;
+
+            explicit Unary(const E& inExpr) noexcept :
+                expr_(inExpr)
+            {
+            }
+
+            Shape shape() const noexcept
+            {
+                return expr_.shape();
+            }
+
+            bool isContiguous() const noexcept
+            {
+                return expr_.isContiguous();
+            }
+
+            template<typename T>
+            bool overlaps(const NdArray<T>& inArray) const noexcept
+            {
+                return expr_.overlaps(inArray);
+            }
+
+            value_type operator[](size_type inIndex) const
+            {
+                return Op::apply(expr_[inIndex]);
+            }
+
+            value_type operator()(size_type inRow, size_type inCol) const
+            {
+                return Op::apply(expr_(inRow, inCol));
+            }
+
+        private:
+            typename Stored<E>::type expr_;
+        };
+
+        //================================Binary=======================================
+        /// Op applied to every pair of elements of L and R
+        template<typename Op, typename L, typename R>
+        class Binary : public Expression<Binary<Op, L, R>>
+        {
+        public:
+            typedef typename L::value_type value_type;
+            static constexpr bool isScalar = L::isScalar && R::isScalar;
+
+            Binary(const L& inLhs, const R& inRhs) noexcept :
+                lhs_(inLhs),
+                rhs_(inRhs)
+            {
+                NUMDL_ASSERT(L::isScalar || R::isScalar ||
+                             inLhs.shape() == inRhs.shape());
+            }
+
+            /// Empty when the operands do not match
+            Shape shape() const noexcept
+            {
+                if (L::isScalar)
+                {
+                    return rhs_.shape();
+                }
+                if (!R::isScalar && lhs_.shape() != rhs_.shape())
+                {
+                    return Shape();
+                }
+                return lhs_.shape();
+            }
+
+            bool isContiguous() const noexcept
+            {
+                return lhs_.isContiguous() && rhs_.isContiguous();
+            }
+
+            template<typename T>
+            bool overlaps(const NdArray<T>& inArray) const noexcept
+            {
+                return lhs_.overlaps(inArray) || rhs_.overlaps(inArray);
+            }
+
+            value_type operator[](size_type inIndex) const
+            {
+                return Op::apply(lhs_[inIndex], rhs_[inIndex]);
+            }
+
+            value_type operator()(size_type inRow, size_type inCol) const
+            {
+                return Op::apply(lhs_(inRow, inCol), rhs_(inRow, inCol));
+            }
+
+        private:
+            typename Stored<L>::type lhs_;
+            typename Stored<R>::type rhs_;
+        };
+    }  // namespace expr
+
+    //================================Operators====================================
+    /// Elementwise functors used by the expression nodes
+    namespace ops
+    {
+        struct Add
+        {
+            template<typename T>
+            static T apply(T a, T b) noexcept { return a + b; }
+        };
+
+        struct Subtract
+        {
+            template<typename T>
+            static T apply(T a, T b) noexcept { return a - b; }
+        };
+
+        struct Multiply
+        {
+            template<typename T>
+            static T apply(T a, T b) noexcept { return a * b; }
+        };
+
+        struct Divide
+        {
+            template<typename T>
+            static T apply(T a, T b) noexcept { return a / b; }
+        };
+
+        struct Maximum
+        {
+            template<typename T>
+            static T apply(T a, T b) noexcept { return a < b ? b : a; }
+        };
+
+        struct Minimum
+        {
+            template<typename T>
+            static T apply(T a, T b) noexcept { return b < a ? b : a; }
+        };
+
+        struct Negate
+        {
+            template<typename T>
+            static T apply(T a) noexcept { return -a; }
+        };
+
+        struct Square
+        {
+            template<typename T>
+            static T apply(T a) noexcept { return a * a; }
+        };
+
+        struct Abs
+        {
+            template<typename T>
+            static T apply(T a) noexcept { return std::abs(a); }
+        };
+
+        struct Sqrt
+        {
+            template<typename T>
+            static T apply(T a) noexcept { return std::sqrt(a); }
+        };
+
+        struct Exp
+        {
+            template<typename T>
+            static T apply(T a) noexcept { return std::exp(a); }
+        };
+
+        struct Log
+        {
+            template<typename T>
+            static T apply(T a) noexcept { return std::log(a); }
+        };
+
+        struct Log2
+        {
+            template<typename T>
+            static T apply(T a) noexcept { return std::log2(a); }
+        };
+
+        struct Log10
+        {
+            template<typename T>
+            static T apply(T a) noexcept { return std::log10(a); }
+        };
+    }  // namespace ops
+
+#define NUMDL_EXPR_BINARY(name, op)                                                \
+    template<typename L, typename R>                                               \
+    expr::Binary<op, L, R> name(const Expression<L>& inLhs,                        \
+                                const Expression<R>& inRhs)                        \
+    {                                                                              \
+        return expr::Binary<op, L, R>(inLhs.derived(), inRhs.derived());           \
+    }                                                                              \
+                                                                                   \
+    template<typename L>                                                           \
+    expr::Binary<op, L, expr::Scalar<typename L::value_type>> name(                \
+        const Expression<L>& inLhs, typename L::value_type inRhs)                  \
+    {                                                                              \
+        typedef expr::Scalar<typename L::value_type> S;                            \
+        return expr::Binary<op, L, S>(inLhs.derived(), S(inRhs));                  \
+    }                                                                              \
+                                                                                   \
+    template<typename R>                                                           \
+    expr::Binary<op, expr::Scalar<typename R::value_type>, R> name(                \
+        typename R::value_type inLhs, const Expression<R>& inRhs)                  \
+    {                                                                              \
+        typedef expr::Scalar<typename R::value_type> S;                            \
+        return expr::Binary<op, S, R>(S(inLhs), inRhs.derived());                  \
+    }
+
+#define NUMDL_EXPR_UNARY(name, op)                                                 \
+    template<typename E>                                                           \
+    expr::Unary<op, E> name(const Expression<E>& inExpr)                           \
+    {                                                                              \
+        return expr::Unary<op, E>(inExpr.derived());                               \
+    }
+
+    NUMDL_EXPR_BINARY(operator+, ops::Add)
+    NUMDL_EXPR_BINARY(operator-, ops::Subtract)
+    NUMDL_EXPR_BINARY(operator*, ops::Multiply)
+    NUMDL_EXPR_BINARY(operator/, ops::Divide)
+    NUMDL_EXPR_BINARY(maximum, ops::Maximum)
+    NUMDL_EXPR_BINARY(minimum, ops::Minimum)
+
+    NUMDL_EXPR_UNARY(operator-, ops::Negate)
+    NUMDL_EXPR_UNARY(square, ops::Square)
+    NUMDL_EXPR_UNARY(abs, ops::Abs)
+    NUMDL_EXPR_UNARY(sqrt, ops::Sqrt)
+    NUMDL_EXPR_UNARY(exp, ops::Exp)
+    NUMDL_EXPR_UNARY(log, ops::Log)
+    NUMDL_EXPR_UNARY(log2, ops::Log2)
+    NUMDL_EXPR_UNARY(log10, ops::Log10)
+
+#undef NUMDL_EXPR_BINARY
+#undef NUMDL_EXPR_UNARY
+}  // namespace nd
+
+#endif
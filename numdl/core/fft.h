@@ -0,0 +1,371 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2022 China Mobile Communications Group Co.,Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file        fft.h
+ *
+ * @brief       Real FFT specialised at compile time for power of two sizes
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+#ifndef __NUMDL_FFT_H__
+#define __NUMDL_FFT_H__
+
+#include "constants.h"
+#include "shape.h"
+
+#include <cstdint>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace nd
+{
+    namespace fft
+    {
+        namespace detail
+        {
+            //============================================================================
+            /// sin(x) by its Taylor series, usable in constant expressions
+            constexpr double constexprSin(double x) noexcept
+            {
+                const double twoPi = 2.0 * constants::pi;
+                while (x > constants::pi)
+                {
+                    x -= twoPi;
+                }
+                while (x < -constants::pi)
+                {
+                    x += twoPi;
+                }
+
+                double term = x;
+                double sum = x;
+                for (int n = 1; n < 20; ++n)
+                {
+                    term *= -x * x / ((2 * n) * (2 * n + 1));
+                    sum += term;
+                }
+                return sum;
+            }
+
+            //============================================================================
+            /// cos(x), usable in constant expressions
+            constexpr double constexprCos(double x) noexcept
+            {
+                return constexprSin(x + constants::pi / 2.0);
+            }
+
+            constexpr size_type log2(size_type n) noexcept
+            {
+                size_type bits = 0;
+                while ((size_type(1) << bits) < n)
+                {
+                    ++bits;
+                }
+                return bits;
+            }
+
+            //================================RfftTables===================================
+            /// Everything an N point real FFT reads, an N / 2 point complex FFT of the
+            /// packed even/odd samples followed by a split like kiss_fftr:
+            ///     bitRev      bit reversed order of the complex input
+            ///     twiddles    per radix-4 stage of length L, W_L^(r * k) for r = 1..3,
+            ///                 k < L / 4, as 6 rows of L / 4: re1 im1 re2 im2 re3 im3
+            ///     superRe/Im  exp(-i * pi * ((k + 1) / (N / 2) + 0.5)) of the split
+            template<size_type N>
+            struct RfftTables
+            {
+                static constexpr size_type M = N / 2;
+
+                std::uint32_t bitRev[M];
+                float twiddles[2 * M];
+                float superRe[M / 2];
+                float superIm[M / 2];
+            };
+
+            template<size_type N>
+            constexpr RfftTables<N> makeRfftTables() noexcept
+            {
+                constexpr size_type M = N / 2;
+                constexpr size_type bits = log2(M);
+
+                RfftTables<N> tables{};
+
+                for (size_type j = 0; j < M; ++j)
+                {
+                    size_type rev = 0;
+                    for (size_type b = 0; b < bits; ++b)
+                    {
+                        rev |= ((j >> b) & 1) << (bits - 1 - b);
+                    }
+                    tables.bitRev[j] = static_cast<std::uint32_t>(rev);
+                }
+
+                // An odd number of bits starts with one radix-2 stage
+                size_type offset = 0;
+                for (size_type L = (bits % 2) ? 8 : 4; L <= M; L *= 4)
+                {
+                    const size_type Q = L / 4;
+                    for (size_type k = 0; k < Q; ++k)
+                    {
+                        for (size_type r = 1; r <= 3; ++r)
+                        {
+                            const double phase = -2.0 * constants::pi * double(r * k) / double(L);
+                            tables.twiddles[offset + (2 * r - 2) * Q + k] =
+                                static_cast<float>(constexprCos(phase));
+                            tables.twiddles[offset + (2 * r - 1) * Q + k] =
+                                static_cast<float>(constexprSin(phase));
+                        }
+                    }
+                    offset += 6 * Q;
+                }
+
+                for (size_type k = 0; k < M / 2; ++k)
+                {
+                    const double phase = -constants::pi * (double(k + 1) / double(M) + 0.5);
+                    tables.superRe[k] = static_cast<float>(constexprCos(phase));
+                    tables.superIm[k] = static_cast<float>(constexprSin(phase));
+                }
+
+                return tables;
+            }
+
+            //============================================================================
+            /// One copy of the tables per size, built by the compiler
+            template<size_type N>
+            struct Rfft
+            {
+                static constexpr RfftTables<N> tables = makeRfftTables<N>();
+            };
+
+            template<size_type N>
+            constexpr RfftTables<N> Rfft<N>::tables;
+
+            //============================================================================
+            /// Radix-4 butterflies of length L on bit reversed data. The quarters of a
+            /// block hold the sub-transforms of the residues 0, 2, 1, 3 (mod 4).
+            template<size_type M, size_type L>
+            inline void radix4(float* re, float* im, const float* tw) noexcept
+            {
+                constexpr size_type Q = L / 4;
+
+                for (size_type b = 0; b < M; b += L)
+                {
+                    float* r0 = re + b;
+                    float* i0 = im + b;
+                    size_type k = 0;
+
+#if defined(__SSE__)
+                    for (; Q % 4 == 0 && k < Q; k += 4)
+                    {
+                        __m128 w1r = _mm_loadu_ps(tw + k);
+                        __m128 w1i = _mm_loadu_ps(tw + Q + k);
+                        __m128 w2r = _mm_loadu_ps(tw + 2 * Q + k);
+                        __m128 w2i = _mm_loadu_ps(tw + 3 * Q + k);
+                        __m128 w3r = _mm_loadu_ps(tw + 4 * Q + k);
+                        __m128 w3i = _mm_loadu_ps(tw + 5 * Q + k);
+
+                        __m128 f0r = _mm_loadu_ps(r0 + k);
+                        __m128 f0i = _mm_loadu_ps(i0 + k);
+                        __m128 f2r = _mm_loadu_ps(r0 + Q + k);
+                        __m128 f2i = _mm_loadu_ps(i0 + Q + k);
+                        __m128 f1r = _mm_loadu_ps(r0 + 2 * Q + k);
+                        __m128 f1i = _mm_loadu_ps(i0 + 2 * Q + k);
+                        __m128 f3r = _mm_loadu_ps(r0 + 3 * Q + k);
+                        __m128 f3i = _mm_loadu_ps(i0 + 3 * Q + k);
+
+                        __m128 t1r = _mm_sub_ps(_mm_mul_ps(f1r, w1r), _mm_mul_ps(f1i, w1i));
+                        __m128 t1i = _mm_add_ps(_mm_mul_ps(f1r, w1i), _mm_mul_ps(f1i, w1r));
+                        __m128 t2r = _mm_sub_ps(_mm_mul_ps(f2r, w2r), _mm_mul_ps(f2i, w2i));
+                        __m128 t2i = _mm_add_ps(_mm_mul_ps(f2r, w2i), _mm_mul_ps(f2i, w2r));
+                        __m128 t3r = _mm_sub_ps(_mm_mul_ps(f3r, w3r), _mm_mul_ps(f3i, w3i));
+                        __m128 t3i = _mm_add_ps(_mm_mul_ps(f3r, w3i), _mm_mul_ps(f3i, w3r));
+
+                        __m128 s0r = _mm_add_ps(f0r, t2r);
+                        __m128 s0i = _mm_add_ps(f0i, t2i);
+                        __m128 s1r = _mm_sub_ps(f0r, t2r);
+                        __m128 s1i = _mm_sub_ps(f0i, t2i);
+                        __m128 s2r = _mm_add_ps(t1r, t3r);
+                        __m128 s2i = _mm_add_ps(t1i, t3i);
+                        __m128 s3r = _mm_sub_ps(t1r, t3r);
+                        __m128 s3i = _mm_sub_ps(t1i, t3i);
+
+                        _mm_storeu_ps(r0 + k, _mm_add_ps(s0r, s2r));
+                        _mm_storeu_ps(i0 + k, _mm_add_ps(s0i, s2i));
+                        _mm_storeu_ps(r0 + Q + k, _mm_add_ps(s1r, s3i));
+                        _mm_storeu_ps(i0 + Q + k, _mm_sub_ps(s1i, s3r));
+                        _mm_storeu_ps(r0 + 2 * Q + k, _mm_sub_ps(s0r, s2r));
+                        _mm_storeu_ps(i0 + 2 * Q + k, _mm_sub_ps(s0i, s2i));
+                        _mm_storeu_ps(r0 + 3 * Q + k, _mm_sub_ps(s1r, s3i));
+                        _mm_storeu_ps(i0 + 3 * Q + k, _mm_add_ps(s1i, s3r));
+                    }
+#endif
+
+                    for (; k < Q; ++k)
+                    {
+                        const float w1r = tw[k];
+                        const float w1i = tw[Q + k];
+                        const float w2r = tw[2 * Q + k];
+                        const float w2i = tw[3 * Q + k];
+                        const float w3r = tw[4 * Q + k];
+                        const float w3i = tw[5 * Q + k];
+
+                        const float f0r = r0[k];
+                        const float f0i = i0[k];
+                        const float f2r = r0[Q + k];
+                        const float f2i = i0[Q + k];
+                        const float f1r = r0[2 * Q + k];
+                        const float f1i = i0[2 * Q + k];
+                        const float f3r = r0[3 * Q + k];
+                        const float f3i = i0[3 * Q + k];
+
+                        const float t1r = f1r * w1r - f1i * w1i;
+                        const float t1i = f1r * w1i + f1i * w1r;
+                        const float t2r = f2r * w2r - f2i * w2i;
+                        const float t2i = f2r * w2i + f2i * w2r;
+                        const float t3r = f3r * w3r - f3i * w3i;
+                        const float t3i = f3r * w3i + f3i * w3r;
+
+                        const float s0r = f0r + t2r;
+                        const float s0i = f0i + t2i;
+                        const float s1r = f0r - t2r;
+                        const float s1i = f0i - t2i;
+                        const float s2r = t1r + t3r;
+                        const float s2i = t1i + t3i;
+                        const float s3r = t1r - t3r;
+                        const float s3i = t1i - t3i;
+
+                        r0[k] = s0r + s2r;
+                        i0[k] = s0i + s2i;
+                        r0[Q + k] = s1r + s3i;
+                        i0[Q + k] = s1i - s3r;
+                        r0[2 * Q + k] = s0r - s2r;
+                        i0[2 * Q + k] = s0i - s2i;
+                        r0[3 * Q + k] = s1r - s3i;
+                        i0[3 * Q + k] = s1i + s3r;
+                    }
+                }
+            }
+
+            //============================================================================
+            /// The radix-4 stages L, 4L, ... M, unrolled by the compiler
+            template<size_type M, size_type L, bool Done = (L > M)>
+            struct Stages
+            {
+                static void run(float* re, float* im, const float* tw) noexcept
+                {
+                    radix4<M, L>(re, im, tw);
+                    Stages<M, L * 4>::run(re, im, tw + 6 * (L / 4));
+                }
+            };
+
+            template<size_type M, size_type L>
+            struct Stages<M, L, true>
+            {
+                static void run(float*, float*, const float*) noexcept
+                {
+                }
+            };
+        }  // namespace detail
+
+        //============================================================================
+        ///						Real FFT of a size known at compile time
+        ///
+        /// Same bins as np.fft.rfft, the twiddle and bit reversal tables are constant
+        /// data built by the compiler. N is a power of two, at least 8. Needs N floats
+        /// of stack.
+        ///
+        /// @param      inData: N real samples
+        /// @param      outData: N / 2 + 1 bins as (re, im) pairs, N + 2 floats
+        ///
+        template<size_type N>
+        void rfft(const float* inData, float* outData) noexcept
+        {
+            static_assert(N >= 8 && (N & (N - 1)) == 0, "N must be a power of two, at least 8");
+
+            constexpr size_type M = N / 2;
+            const detail::RfftTables<N>& tables = detail::Rfft<N>::tables;
+
+            alignas(16) float re[M];
+            alignas(16) float im[M];
+
+            for (size_type j = 0; j < M; ++j)
+            {
+                const size_type src = 2 * tables.bitRev[j];
+                re[j] = inData[src];
+                im[j] = inData[src + 1];
+            }
+
+            if (detail::log2(M) % 2)
+            {
+                for (size_type j = 0; j < M; j += 2)
+                {
+                    const float ar = re[j];
+                    const float ai = im[j];
+                    re[j] = ar + re[j + 1];
+                    im[j] = ai + im[j + 1];
+                    re[j + 1] = ar - re[j + 1];
+                    im[j + 1] = ai - im[j + 1];
+                }
+                detail::Stages<M, 8>::run(re, im, tables.twiddles);
+            }
+            else
+            {
+                detail::Stages<M, 4>::run(re, im, tables.twiddles);
+            }
+
+            outData[0] = re[0] + im[0];
+            outData[1] = 0.0f;
+            outData[2 * M] = re[0] - im[0];
+            outData[2 * M + 1] = 0.0f;
+
+            for (size_type k = 1; k <= M / 2; ++k)
+            {
+                const float fpkr = re[k];
+                const float fpki = im[k];
+                const float fpnkr = re[M - k];
+                const float fpnki = -im[M - k];
+
+                const float f1kr = fpkr + fpnkr;
+                const float f1ki = fpki + fpnki;
+                const float f2kr = fpkr - fpnkr;
+                const float f2ki = fpki - fpnki;
+
+                const float wr = tables.superRe[k - 1];
+                const float wi = tables.superIm[k - 1];
+                const float twr = f2kr * wr - f2ki * wi;
+                const float twi = f2kr * wi + f2ki * wr;
+
+                outData[2 * k] = 0.5f * (f1kr + twr);
+                outData[2 * k + 1] = 0.5f * (f1ki + twi);
+                outData[2 * (M - k)] = 0.5f * (f1kr - twr);
+                outData[2 * (M - k) + 1] = 0.5f * (twi - f1ki);
+            }
+        }
+    }  // namespace fft
+}  // namespace nd
+
+#endif
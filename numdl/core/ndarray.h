@@ -0,0 +1,557 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026 China Mobile Communications Group Co.,Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file        ndarray.h
+ *
+ * @brief       Two dimensional array with shape and stride metadata
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+#ifndef __NUMDL_NDARRAY_H__
+#define __NUMDL_NDARRAY_H__
+
+#include "nd_assert.h"
+#include "expression.h"
+#include "shape.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+
+namespace nd
+{
+    //================================NdArray======================================
+    /// Two dimensional array addressed through row and column strides. It either
+    /// owns its buffer or borrows one (views, external memory). Elementwise
+    /// expressions assigned to it are evaluated in one fused loop:
+    ///
+    ///     out = nd::log(a * b + c);    // one pass, no temporary arrays
+    ///
+    /// Expressions hold arrays by reference, evaluate them before the operands
+    /// go out of scope.
+    template<typename dtype>
+    class NdArray : public Expression<NdArray<dtype>>
+    {
+    public:
+        typedef dtype value_type;
+        static constexpr bool isScalar = false;
+
+        //============================================================================
+        ///						Constructor
+        ///
+        NdArray() noexcept = default;
+
+        //============================================================================
+        ///						Constructor, elements are zero initialised
+        ///
+        /// @param      inRows
+        /// @param      inCols
+        ///
+        NdArray(size_type inRows, size_type inCols) :
+            shape_(inRows, inCols),
+            rowStride_(inCols),
+            colStride_(1),
+            data_(new dtype[inRows * inCols]()),
+            owned_(true)
+        {
+        }
+
+        //============================================================================
+        ///						Constructor, elements are zero initialised
+        ///
+        /// @param      inShape
+        ///
+        explicit NdArray(const Shape& inShape) :
+            NdArray(inShape.rows, inShape.cols)
+        {
+        }
+
+        //============================================================================
+        ///						Constructor, a single row
+        ///
+        /// @param      inList
+        ///
+        NdArray(std::initializer_list<dtype> inList) :
+            NdArray(1, inList.size())
+        {
+            size_type i = 0;
+            for (const dtype& value : inList)
+            {
+                data_[i++] = value;
+            }
+        }
+
+        //============================================================================
+        ///						Constructor, one list per row
+        ///
+        /// @param      inList
+        ///
+        NdArray(std::initializer_list<std::initializer_list<dtype>> inList) :
+            NdArray(inList.size(), inList.size() ? inList.begin()->size() : 0)
+        {
+            size_type i = 0;
+            for (const auto& row : inList)
+            {
+                NUMDL_ASSERT(row.size() == shape_.cols);
+                for (const dtype& value : row)
+                {
+                    data_[i++] = value;
+                }
+            }
+        }
+
+        //============================================================================
+        ///						Constructor, borrows an external buffer
+        ///
+        /// @param      inData
+        /// @param      inRows
+        /// @param      inCols
+        /// @param      inRowStride: elements between two rows
+        /// @param      inColStride: elements between two columns
+        ///
+        NdArray(dtype* inData,
+                size_type inRows,
+                size_type inCols,
+                size_type inRowStride,
+                size_type inColStride = 1) noexcept :
+            shape_(inRows, inCols),
+            rowStride_(inRowStride),
+            colStride_(inColStride),
+            data_(inData),
+            owned_(false)
+        {
+            NUMDL_ASSERT(inData != nullptr || 0 == inRows * inCols);
+        }
+
+        //============================================================================
+        ///						Constructor, evaluates an expression
+        ///
+        /// @param      inExpr
+        ///
+        template<typename E>
+        NdArray(const Expression<E>& inExpr) :
+            NdArray(inExpr.derived().shape())
+        {
+            assign(inExpr.derived());
+        }
+
+        //============================================================================
+        ///						Copy Constructor, the copy is compact and owned
+        ///
+        /// @param      inOther
+        ///
+        NdArray(const NdArray& inOther) :
+            NdArray(inOther.shape_)
+        {
+            assign(inOther);
+        }
+
+        //============================================================================
+        ///						Move Constructor
+        ///
+        /// @param      inOther
+        ///
+        NdArray(NdArray&& inOther) noexcept
+        {
+            swap(inOther);
+        }
+
+        //============================================================================
+        ///						Destructor
+        ///
+        ~NdArray() noexcept
+        {
+            if (owned_)
+            {
+                delete[] data_;
+            }
+        }
+
+        //============================================================================
+        ///						Assignment operator, writes through borrowed views
+        ///
+        /// @param      inOther
+        ///
+        /// @return     NdArray
+        ///
+        NdArray& operator=(const NdArray& inOther)
+        {
+            if (this != &inOther)
+            {
+                evaluate(inOther);
+            }
+            return *this;
+        }
+
+        //============================================================================
+        ///						Move operator, borrowed views are written through
+        ///                     instead of rebound. Only an owned buffer is taken
+        ///                     over, a borrowing source (a.transpose()) is copied.
+        ///
+        /// @param      inOther
+        ///
+        /// @return     NdArray
+        ///
+        NdArray& operator=(NdArray&& inOther)
+        {
+            if (this == &inOther)
+            {
+                return *this;
+            }
+
+            if ((!owned_ && data_ != nullptr) || !inOther.owned_)
+            {
+                evaluate(inOther);
+                return *this;
+            }
+
+            NdArray tmp(std::move(inOther));
+            swap(tmp);
+            return *this;
+        }
+
+        //============================================================================
+        ///						Assignment operator, evaluates an expression
+        ///
+        /// @param      inExpr
+        ///
+        /// @return     NdArray
+        ///
+        template<typename E>
+        NdArray& operator=(const Expression<E>& inExpr)
+        {
+            evaluate(inExpr.derived());
+            return *this;
+        }
+
+        //============================================================================
+        ///						Fills every element with a value
+        ///
+        /// @param      inValue
+        ///
+        /// @return     NdArray
+        ///
+        NdArray& operator=(dtype inValue) noexcept
+        {
+            fill(inValue);
+            return *this;
+        }
+
+        template<typename E>
+        NdArray& operator+=(const Expression<E>& inExpr)
+        {
+            evaluate(*this + inExpr);
+            return *this;
+        }
+
+        template<typename E>
+        NdArray& operator-=(const Expression<E>& inExpr)
+        {
+            evaluate(*this - inExpr);
+            return *this;
+        }
+
+        template<typename E>
+        NdArray& operator*=(const Expression<E>& inExpr)
+        {
+            evaluate(*this * inExpr);
+            return *this;
+        }
+
+        template<typename E>
+        NdArray& operator/=(const Expression<E>& inExpr)
+        {
+            evaluate(*this / inExpr);
+            return *this;
+        }
+
+        NdArray& operator+=(dtype inValue)
+        {
+            assign(*this + inValue);
+            return *this;
+        }
+
+        NdArray& operator-=(dtype inValue)
+        {
+            assign(*this - inValue);
+            return *this;
+        }
+
+        NdArray& operator*=(dtype inValue)
+        {
+            assign(*this * inValue);
+            return *this;
+        }
+
+        NdArray& operator/=(dtype inValue)
+        {
+            assign(*this / inValue);
+            return *this;
+        }
+
+        //============================================================================
+        ///						Flat access, only valid for contiguous arrays
+        ///
+        /// @param      inIndex
+        ///
+        /// @return     value
+        ///
+        dtype& operator[](size_type inIndex) noexcept
+        {
+            return data_[inIndex];
+        }
+
+        const dtype& operator[](size_type inIndex) const noexcept
+        {
+            return data_[inIndex];
+        }
+
+        //============================================================================
+        ///						2D access
+        ///
+        /// @param      inRow
+        /// @param      inCol
+        ///
+        /// @return     value
+        ///
+        dtype& operator()(size_type inRow, size_type inCol) noexcept
+        {
+            return data_[inRow * rowStride_ + inCol * colStride_];
+        }
+
+        const dtype& operator()(size_type inRow, size_type inCol) const noexcept
+        {
+            return data_[inRow * rowStride_ + inCol * colStride_];
+        }
+
+        //============================================================================
+        ///						Transposed view sharing this array's buffer
+        ///
+        /// @return     NdArray
+        ///
+        NdArray transpose() const noexcept
+        {
+            return NdArray(data_, shape_.cols, shape_.rows, colStride_, rowStride_);
+        }
+
+        //============================================================================
+        ///						Fills every element with a value
+        ///
+        /// @param      inValue
+        ///
+        void fill(dtype inValue) noexcept
+        {
+            assign(expr::Scalar<dtype>(inValue));
+        }
+
+        Shape shape() const noexcept
+        {
+            return shape_;
+        }
+
+        size_type rows() const noexcept
+        {
+            return shape_.rows;
+        }
+
+        size_type cols() const noexcept
+        {
+            return shape_.cols;
+        }
+
+        size_type size() const noexcept
+        {
+            return shape_.size();
+        }
+
+        size_type rowStride() const noexcept
+        {
+            return rowStride_;
+        }
+
+        size_type colStride() const noexcept
+        {
+            return colStride_;
+        }
+
+        dtype* data() noexcept
+        {
+            return data_;
+        }
+
+        const dtype* data() const noexcept
+        {
+            return data_;
+        }
+
+        bool ownsData() const noexcept
+        {
+            return owned_;
+        }
+
+        //============================================================================
+        ///						Elements are packed row after row
+        ///
+        /// @return     bool
+        ///
+        bool isContiguous() const noexcept
+        {
+            if (shape_.cols > 1 && colStride_ != 1)
+            {
+                return false;
+            }
+
+            return shape_.rows <= 1 ||
+                   rowStride_ == (shape_.cols > 1 ? shape_.cols : 1);
+        }
+
+        //============================================================================
+        ///						Whether this array reads memory of inArray laid
+        ///                     out differently, so an elementwise write to
+        ///                     inArray could change values still to be read.
+        ///                     The same buffer with the same strides is safe.
+        ///
+        /// @param      inArray
+        ///
+        /// @return     bool
+        ///
+        template<typename T>
+        bool overlaps(const NdArray<T>& inArray) const noexcept
+        {
+            if (0 == size() || 0 == inArray.size())
+            {
+                return false;
+            }
+
+            const void* other = inArray.data();
+            if (other == static_cast<const void*>(data_) &&
+                rowStride_ == inArray.rowStride() &&
+                colStride_ == inArray.colStride())
+            {
+                return false;
+            }
+
+            const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(data_);
+            const std::uintptr_t last = reinterpret_cast<std::uintptr_t>(
+                data_ + (shape_.rows - 1) * rowStride_ +
+                (shape_.cols - 1) * colStride_ + 1);
+            const std::uintptr_t otherFirst = reinterpret_cast<std::uintptr_t>(other);
+            const std::uintptr_t otherLast = reinterpret_cast<std::uintptr_t>(
+                inArray.data() + (inArray.rows() - 1) * inArray.rowStride() +
+                (inArray.cols() - 1) * inArray.colStride() + 1);
+
+            return first < otherLast && otherFirst < last;
+        }
+
+        void swap(NdArray& inOther) noexcept
+        {
+            std::swap(shape_, inOther.shape_);
+            std::swap(rowStride_, inOther.rowStride_);
+            std::swap(colStride_, inOther.colStride_);
+            std::swap(data_, inOther.data_);
+            std::swap(owned_, inOther.owned_);
+        }
+
+    private:
+        //============================================================================
+        ///						Assigns an expression, reallocating owned arrays
+        ///                     whose shape differs. An expression reading this
+        ///                     buffer through another layout goes through a
+        ///                     temporary. Borrowed arrays never change shape, a
+        ///                     mismatch leaves them untouched.
+        ///
+        /// @param      inExpr
+        ///
+        template<typename E>
+        void evaluate(const E& inExpr)
+        {
+            const bool sameShape = E::isScalar || inExpr.shape() == shape_;
+            if (sameShape && !inExpr.overlaps(*this))
+            {
+                assign(inExpr);
+                return;
+            }
+
+            NUMDL_ASSERT(sameShape || owned_ || nullptr == data_);
+            if (!sameShape && !owned_ && data_ != nullptr)
+            {
+                return;
+            }
+
+            /* The expression may still read this array, evaluate before writing */
+            NdArray tmp(inExpr.shape());
+            tmp.assign(inExpr);
+            if (sameShape)
+            {
+                assign(tmp);
+                return;
+            }
+            swap(tmp);
+        }
+
+        //============================================================================
+        ///						The fused loop, one pass over the output
+        ///
+        /// @param      inExpr
+        ///
+        template<typename E>
+        void assign(const E& inExpr)
+        {
+            NUMDL_ASSERT(E::isScalar || inExpr.shape() == shape_);
+            if (!E::isScalar && inExpr.shape() != shape_)
+            {
+                return;
+            }
+
+            if (isContiguous() && inExpr.isContiguous())
+            {
+                dtype* out = data_;
+                const size_type count = shape_.size();
+                for (size_type i = 0; i < count; ++i)
+                {
+                    out[i] = inExpr[i];
+                }
+                return;
+            }
+
+            for (size_type row = 0; row < shape_.rows; ++row)
+            {
+                dtype* out = data_ + row * rowStride_;
+                for (size_type col = 0; col < shape_.cols; ++col)
+                {
+                    out[col * colStride_] = inExpr(row, col);
+                }
+            }
+        }
+
+        Shape shape_{};
+        size_type rowStride_{ 0 };
+        size_type colStride_{ 1 };
+        dtype* data_{ nullptr };
+        bool owned_{ false };
+    };
+}  // namespace nd
+
+#endif
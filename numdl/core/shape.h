@@ -0,0 +1,102 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026 China Mobile Communications Group Co.,Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file        shape.h
+ *
+ * @brief       Shape of a two dimensional array
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+#ifndef __NUMDL_SHAPE_H__
+#define __NUMDL_SHAPE_H__
+
+#include <cstddef>
+
+namespace nd
+{
+    typedef std::size_t size_type;
+
+    //================================Shape========================================
+    /// Number of rows and columns of an array
+    class Shape
+    {
+    public:
+        size_type rows{ 0 };
+        size_type cols{ 0 };
+
+        //============================================================================
+        ///						Constructor
+        ///
+        constexpr Shape() noexcept = default;
+
+        //============================================================================
+        ///						Constructor
+        ///
+        /// @param      inRows
+        /// @param      inCols
+        ///
+        constexpr Shape(size_type inRows, size_type inCols) noexcept :
+            rows(inRows),
+            cols(inCols)
+        {
+        }
+
+        //============================================================================
+        ///						Number of elements
+        ///
+        /// @return     rows * cols
+        ///
+        constexpr size_type size() const noexcept
+        {
+            return rows * cols;
+        }
+
+        //============================================================================
+        ///						Equality operator
+        ///
+        /// @param      inOther
+        ///
+        /// @return     bool
+        ///
+        constexpr bool operator==(const Shape& inOther) const noexcept
+        {
+            return rows == inOther.rows && cols == inOther.cols;
+        }
+
+        //============================================================================
+        ///						Not equality operator
+        ///
+        /// @param      inOther
+        ///
+        /// @return     bool
+        ///
+        constexpr bool operator!=(const Shape& inOther) const noexcept
+        {
+            return !(*this == inOther);
+        }
+    };
+}  // namespace nd
+
+#endif
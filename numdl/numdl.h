@@ -33,6 +33,8 @@
 #define __NUMDL_H__
 
 #include "core/constants.h"
+#include "core/fft.h"
+#include "core/ndarray.h"
 #include "utils/cube.h"
 
 
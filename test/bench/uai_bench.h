@@ -0,0 +1,68 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ * @file        uai_bench.h
+ *
+ * @brief       Helpers shared by the feature benchmarks.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#ifndef __UAI_BENCH_H__
+#define __UAI_BENCH_H__
+
+#include <os_clock.h>
+#include <os_stddef.h>
+
+/** Every measurement runs for at least this many ticks */
+#ifndef NUMDL_BENCH_MIN_TICKS
+#define NUMDL_BENCH_MIN_TICKS (OS_TICK_PER_SECOND / 5)
+#endif
+
+/**
+ * Run `func(arg)` repeatedly until NUMDL_BENCH_MIN_TICKS elapsed.
+ *
+ * @returns Average time of one call in microseconds
+ */
+template <typename F>
+static double bench_run(F func)
+{
+    os_size_t loops = 0;
+    os_tick_t start = os_tick_get();
+    os_tick_t elapsed = 0;
+
+    do {
+        func();
+        loops++;
+        elapsed = os_tick_get() - start;
+    } while (elapsed < NUMDL_BENCH_MIN_TICKS);
+
+    return (double)elapsed * 1000000.0 / OS_TICK_PER_SECOND / loops;
+}
+
+/** Deterministic pseudo random fill in [-1, 1) */
+static void bench_fill(float* data, os_size_t size, os_uint32_t seed)
+{
+    for (os_size_t i = 0; i < size; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        data[i] = (float)(seed >> 8) / (float)(1u << 23) - 1.0f;
+    }
+}
+
+#endif /* __UAI_BENCH_H__ */
@@ -0,0 +1,353 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_dct_bench.cc
+ *
+ * @brief       Time the FFT and cosine basis paths of a truncated DCT-II to
+ *              show where the auto method should switch.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_bench.h"
+
+#include <uai_dct.h>
+#include <uai_dct_block.h>
+#include <uai_dsp.h>
+#include <nd_errno.h>
+#include <uai_matrix.h>
+
+#include <stdio.h>
+
+#include <atest.h>
+#include <os_errno.h>
+
+/** Rows of each run, about a second of MFCC frames */
+#ifndef NUMDL_BENCH_DCT_ROWS
+#define NUMDL_BENCH_DCT_ROWS (100)
+#endif
+
+/** Rows of the whole matrix run, an offline feature job */
+#ifndef NUMDL_BENCH_DCT_MATRIX_ROWS
+#define NUMDL_BENCH_DCT_MATRIX_ROWS (10000)
+#endif
+
+/** Edge of the image cut into blocks */
+#ifndef NUMDL_BENCH_DCT_IMAGE
+#define NUMDL_BENCH_DCT_IMAGE (512)
+#endif
+
+#ifndef NUMDL_BENCH_DCT_THREADS
+#define NUMDL_BENCH_DCT_THREADS (4)
+#endif
+
+namespace uai {
+namespace feature {
+
+static double bench_dct2_method(os_size_t n,
+                                os_size_t k,
+                                dct_method_t method,
+                                const float* src,
+                                float* out)
+{
+    dct_plan_t* plan = dct::plan_create(n, k, DCT_NORMAL_ORTHO, method);
+    void* scratch = OS_NULL;
+    if (plan != OS_NULL) {
+        scratch = uai_mat_aligned_alloc(dct::dct2_rows_scratch_size(plan));
+    }
+    if (OS_NULL == scratch) {
+        dct::plan_destroy(plan);
+        return 0.0;
+    }
+
+    double us = bench_run([&] {
+        dct::dct2_rows(
+            plan, NUMDL_BENCH_DCT_ROWS, src, n, 1, out, k, 1, scratch);
+    });
+
+    uai_mat_aligned_free(scratch);
+    dct::plan_destroy(plan);
+    return us;
+}
+
+static void bench_dct2_truncated(void)
+{
+    const os_size_t sizes[] = {16, 32, 40, 64, 128, 256, 512};
+    const os_size_t outputs[] = {4, 8, 13, 16, 24, 32, 64, 128, 512};
+    os_size_t rows = NUMDL_BENCH_DCT_ROWS;
+    os_size_t max_n = 512;
+
+    float* src = (float*)uai_mat_aligned_alloc(rows * max_n * sizeof(float));
+    float* out = (float*)uai_mat_aligned_alloc(rows * max_n * sizeof(float));
+    if (OS_NULL == src || OS_NULL == out) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(src, rows * max_n, 11);
+
+    printf("truncated dct2 of %d rows, time per row\r\n", (int)rows);
+    for (os_size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        os_size_t n = sizes[s];
+
+        for (os_size_t o = 0; o < sizeof(outputs) / sizeof(outputs[0]); o++) {
+            os_size_t k = outputs[o] < n ? outputs[o] : n;
+            if (o > 0 && outputs[o - 1] >= n) {
+                break;
+            }
+
+            double fft = bench_dct2_method(n, k, DCT_METHOD_FFT, src, out);
+            double direct =
+                bench_dct2_method(n, k, DCT_METHOD_DIRECT, src, out);
+
+            dct_plan_t* plan =
+                dct::plan_create(n, k, DCT_NORMAL_ORTHO, DCT_METHOD_AUTO);
+            dct_method_t pick = DCT_METHOD_AUTO;
+            if (plan != OS_NULL) {
+                pick = dct::plan_method(plan);
+                dct::plan_destroy(plan);
+            }
+
+            printf("n %4d k %4d | fft %8.3f us | direct %8.3f us | "
+                   "faster %-6s | auto %s\r\n",
+                   (int)n,
+                   (int)k,
+                   fft / rows,
+                   direct / rows,
+                   fft < direct ? "fft" : "direct",
+                   DCT_METHOD_DIRECT == pick ? "direct" : "fft");
+        }
+    }
+
+cleanup:
+    if (out != OS_NULL) {
+        uai_mat_aligned_free(out);
+    }
+    if (src != OS_NULL) {
+        uai_mat_aligned_free(src);
+    }
+}
+
+static void bench_dct2_matrix_size(os_size_t rows, os_size_t n)
+{
+    uai_mat_t* mat = uai_mat_create(rows, n);
+    dct_plan_t* plan = dct::plan_create(n, DCT_NORMAL_ORTHO);
+    void* scratch = OS_NULL;
+    if (plan != OS_NULL) {
+        scratch = uai_mat_aligned_alloc(dct::dct2_scratch_size(plan));
+    }
+    if (OS_NULL == mat || OS_NULL == scratch) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(mat->data, rows * n, 17);
+
+    {
+        /* One row at a time on one thread, the former dsp::dct2 */
+        double serial = bench_run([&] {
+            for (os_size_t r = 0; r < rows; r++) {
+                float* row = mat->data + r * n;
+                dct::dct2(plan, row, row, scratch);
+            }
+        });
+        double batched =
+            bench_run([&] { dsp::dct2(mat, DCT_NORMAL_ORTHO); });
+        dsp::set_num_threads(NUMDL_BENCH_DCT_THREADS);
+        double threads =
+            bench_run([&] { dsp::dct2(mat, DCT_NORMAL_ORTHO); });
+        dsp::set_num_threads(1);
+
+        printf("%6d x %4d | row loop %10.1f us | dsp::dct2 %10.1f us | "
+               "%d threads %10.1f us\r\n",
+               (int)rows,
+               (int)n,
+               serial,
+               batched,
+               NUMDL_BENCH_DCT_THREADS,
+               threads);
+    }
+
+cleanup:
+    if (scratch != OS_NULL) {
+        uai_mat_aligned_free(scratch);
+    }
+    dct::plan_destroy(plan);
+    if (mat != OS_NULL) {
+        uai_mat_destroy(mat);
+    }
+}
+
+static void bench_dct2_matrix(void)
+{
+    bench_dct2_matrix_size(NUMDL_BENCH_DCT_MATRIX_ROWS, 40);
+    bench_dct2_matrix_size(NUMDL_BENCH_DCT_MATRIX_ROWS, 64);
+    bench_dct2_matrix_size(NUMDL_BENCH_DCT_MATRIX_ROWS / 4, 256);
+}
+
+static void bench_dct_types(void)
+{
+    const os_size_t sizes[] = {32, 128, 512};
+    const dct_type_t types[] = {DCT_TYPE_II, DCT_TYPE_III, DCT_TYPE_IV};
+    float src[512];
+    float out[512];
+
+    bench_fill(src, 512, 23);
+
+    printf("one row, fft method against the cosine basis\r\n");
+    for (os_size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        os_size_t n = sizes[s];
+
+        for (os_size_t t = 0; t < 3; t++) {
+            double us[2] = {0.0, 0.0};
+
+            for (int m = 0; m < 2; m++) {
+                dct_method_t method =
+                    (0 == m) ? DCT_METHOD_FFT : DCT_METHOD_DIRECT;
+                dct_plan_t* plan = dct::plan_create(
+                    types[t], n, n, DCT_NORMAL_ORTHO, method);
+                void* scratch = OS_NULL;
+                if (plan != OS_NULL) {
+                    scratch = uai_mat_aligned_alloc(dct::scratch_size(plan));
+                }
+                if (scratch != OS_NULL) {
+                    us[m] = bench_run([&] {
+                        dct::transform(plan, src, 1, out, 1, scratch);
+                    });
+                    uai_mat_aligned_free(scratch);
+                }
+                dct::plan_destroy(plan);
+            }
+
+            printf("type %d n %4d | fft %8.3f us | direct %8.3f us\r\n",
+                   (int)types[t],
+                   (int)n,
+                   us[0],
+                   us[1]);
+        }
+    }
+}
+
+static void bench_dct_block_size(os_size_t size)
+{
+    const os_size_t edge = NUMDL_BENCH_DCT_IMAGE;
+
+    uai_mat_t* img = uai_mat_create(edge, edge);
+    uai_mat_t* out = uai_mat_create(edge, edge);
+    dct_plan_t* plan = dct::plan_create(size, DCT_NORMAL_ORTHO);
+    void* scratch = OS_NULL;
+    if (plan != OS_NULL) {
+        scratch = uai_mat_aligned_alloc(dct::rows_scratch_size(plan));
+    }
+    if (OS_NULL == img || OS_NULL == out || OS_NULL == scratch) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(img->data, edge * edge, 29);
+
+    {
+        /* Each block through a 1D plan, along the rows then the columns */
+        float tmp[UAI_DCT_BLOCK_MAX * UAI_DCT_BLOCK_MAX];
+        double rows_cols = bench_run([&] {
+            for (os_size_t r = 0; r < edge; r += size) {
+                for (os_size_t c = 0; c < edge; c += size) {
+                    float* dst = out->data + r * edge + c;
+                    dct::transform_rows(plan,
+                                        size,
+                                        img->data + r * edge + c,
+                                        edge,
+                                        1,
+                                        tmp,
+                                        size,
+                                        1,
+                                        scratch);
+                    dct::transform_rows(
+                        plan, size, tmp, 1, size, dst, 1, edge, scratch);
+                }
+            }
+        });
+        double block = bench_run([&] {
+            dct_block::forward_image(img, out, size, DCT_NORMAL_ORTHO);
+        });
+        dsp::set_num_threads(NUMDL_BENCH_DCT_THREADS);
+        double threads = bench_run([&] {
+            dct_block::forward_image(img, out, size, DCT_NORMAL_ORTHO);
+        });
+        dsp::set_num_threads(1);
+
+        printf("%4d x %4d in %2dx%-2d | 1D plans %10.1f us | "
+               "dct_block %10.1f us | %d threads %10.1f us\r\n",
+               (int)edge,
+               (int)edge,
+               (int)size,
+               (int)size,
+               rows_cols,
+               block,
+               NUMDL_BENCH_DCT_THREADS,
+               threads);
+    }
+
+cleanup:
+    if (scratch != OS_NULL) {
+        uai_mat_aligned_free(scratch);
+    }
+    dct::plan_destroy(plan);
+    if (out != OS_NULL) {
+        uai_mat_destroy(out);
+    }
+    if (img != OS_NULL) {
+        uai_mat_destroy(img);
+    }
+}
+
+static void bench_dct_block(void)
+{
+    bench_dct_block_size(4);
+    bench_dct_block_size(8);
+    bench_dct_block_size(16);
+}
+
+static void bench_case(void)
+{
+    ATEST_UNIT_RUN(bench_dct2_truncated);
+    ATEST_UNIT_RUN(bench_dct2_matrix);
+    ATEST_UNIT_RUN(bench_dct_types);
+    ATEST_UNIT_RUN(bench_dct_block);
+}
+
+static os_err_t bench_init(void)
+{
+    return OS_EOK;
+}
+
+static os_err_t bench_cleanup(void)
+{
+    return OS_EOK;
+}
+
+ATEST_TC_EXPORT(uai_sdk.feature.dct.bench,
+                bench_case,
+                bench_init,
+                bench_cleanup,
+                TC_PRIORITY_MIDDLE);
+
+}  // namespace feature
+}  // namespace uai
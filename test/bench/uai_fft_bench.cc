@@ -0,0 +1,552 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_fft_bench.cc
+ *
+ * @brief       Time the real FFT paths over spectrogram sized workloads.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_bench.h"
+
+#include <uai_dsp.h>
+#include <uai_fft.h>
+#include <nd_errno.h>
+#include <uai_matrix.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atest.h>
+#include <kiss_fftr.h>
+#include <os_errno.h>
+#include "numdl.h"
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+#include <arm_math.h>
+#endif
+
+
+#ifndef NUMDL_BENCH_FFT_FRAMES
+#define NUMDL_BENCH_FFT_FRAMES (64)
+#endif
+
+/** Frames of the spectrogram run, 10 s of audio at a 10 ms hop */
+#ifndef NUMDL_BENCH_FFT_ROWS
+#define NUMDL_BENCH_FFT_ROWS (1000)
+#endif
+
+#ifndef NUMDL_BENCH_FFT_THREADS
+#define NUMDL_BENCH_FFT_THREADS (4)
+#endif
+
+/** Largest real size of the large transform run */
+#ifndef NUMDL_BENCH_FFT_LARGE_MAX
+#define NUMDL_BENCH_FFT_LARGE_MAX (1 << 22)
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846264338327950288
+#endif  // M_PI
+
+namespace uai {
+namespace feature {
+
+static void bench_rfft_size(os_size_t nfft)
+{
+    os_size_t frames = NUMDL_BENCH_FFT_FRAMES;
+    os_size_t bins = nfft / 2 + 1;
+
+    fft_plan_t* plan = fft::plan_create(nfft);
+    float* src = (float*)uai_mat_aligned_alloc(frames * nfft * sizeof(float));
+    kiss_fft_cpx* out = (kiss_fft_cpx*)uai_mat_aligned_alloc(
+        frames * bins * sizeof(kiss_fft_cpx));
+    void* scratch = OS_NULL;
+    if (plan != OS_NULL) {
+        scratch = uai_mat_aligned_alloc(fft::rfft_batch_scratch_size(plan));
+    }
+    if (OS_NULL == plan || OS_NULL == src || OS_NULL == out ||
+        OS_NULL == scratch) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(src, frames * nfft, 1);
+
+    {
+        double single = bench_run([&] {
+            for (os_size_t f = 0; f < frames; f++) {
+                fft::rfft(plan, src + f * nfft, out + f * bins, scratch);
+            }
+        });
+        double batch = bench_run([&] {
+            fft::rfft_batch(plan, src, nfft, frames, out, bins, scratch);
+        });
+
+        printf("%5d points | one by one %9.1f us | batch %9.1f us | "
+               "x%.2f\r\n",
+               (int)nfft,
+               single,
+               batch,
+               single / batch);
+    }
+
+cleanup:
+    if (scratch != OS_NULL) {
+        uai_mat_aligned_free(scratch);
+    }
+    if (src != OS_NULL) {
+        uai_mat_aligned_free(src);
+    }
+    if (out != OS_NULL) {
+        uai_mat_aligned_free(out);
+    }
+    fft::plan_destroy(plan);
+}
+
+static void bench_rfft_batch(void)
+{
+    static const os_size_t sizes[] = {256, 400, 512, 1024, 2048};
+
+    printf("rfft of %d frames\r\n", NUMDL_BENCH_FFT_FRAMES);
+    for (os_size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_rfft_size(sizes[i]);
+    }
+}
+
+static void bench_rfft_rows(void)
+{
+    os_size_t rows = NUMDL_BENCH_FFT_ROWS;
+    os_size_t frame_len = 400;
+    os_size_t fft_len = 512;
+    os_size_t bins = fft_len / 2 + 1;
+
+    uai_mat_t* src = uai_mat_create(rows, frame_len);
+    uai_mat_t* out = uai_mat_create(rows, bins);
+    if (OS_NULL == src || OS_NULL == out) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(src->data, rows * frame_len, 2);
+
+    {
+        double single = bench_run([&] {
+            for (os_size_t r = 0; r < rows; r++) {
+                dsp::rfft(src->data + r * frame_len,
+                          frame_len,
+                          out->data + r * bins,
+                          bins,
+                          fft_len);
+            }
+        });
+        double mat = bench_run([&] { dsp::rfft(src, out, fft_len); });
+        double power = bench_run([&] {
+            dsp::rfft(src, out, fft_len, RFFT_OUT_POWER, 0.0f);
+        });
+        double log_power = bench_run([&] {
+            dsp::rfft(src, out, fft_len, RFFT_OUT_LOG_POWER, 1.0e-10f);
+        });
+
+        dsp::set_num_threads(NUMDL_BENCH_FFT_THREADS);
+        double threads = bench_run([&] { dsp::rfft(src, out, fft_len); });
+        dsp::set_num_threads(1);
+
+        printf("spectrogram %d x %d -> %d | per frame %9.1f us | matrix "
+               "%9.1f us | %d threads %9.1f us\r\n",
+               (int)rows,
+               (int)frame_len,
+               (int)fft_len,
+               single,
+               mat,
+               NUMDL_BENCH_FFT_THREADS,
+               threads);
+        printf("spectrogram output | magnitude %9.1f us | power %9.1f us | "
+               "log power %9.1f us\r\n",
+               mat,
+               power,
+               log_power);
+    }
+
+cleanup:
+    if (src != OS_NULL) {
+        uai_mat_destroy(src);
+    }
+    if (out != OS_NULL) {
+        uai_mat_destroy(out);
+    }
+}
+
+template <os_size_t N>
+static void bench_rfft_fixed_size(void)
+{
+    os_size_t bins = N / 2 + 1;
+
+    fft_plan_t* plan = fft::plan_create(N);
+    float* src = (float*)uai_mat_aligned_alloc((2 * N + 2) * sizeof(float));
+    float* out = (float*)uai_mat_aligned_alloc((N + 2) * sizeof(float));
+    if (OS_NULL == plan || OS_NULL == src || OS_NULL == out) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(src, N, 3);
+
+    {
+        double fixed = bench_run([&] { nd::fft::rfft<N>(src, out); });
+        double kiss = bench_run([&] {
+            fft::rfft(plan, src, (kiss_fft_cpx*)out, OS_NULL);
+        });
+
+        /* Largest difference to the kissfft bins */
+        float* kiss_out = src + N;
+        fft::rfft(plan, src, (kiss_fft_cpx*)kiss_out, OS_NULL);
+        nd::fft::rfft<N>(src, out);
+        float err = 0.0f;
+        for (os_size_t i = 0; i < 2 * bins - 2; i++) {
+            float d = fabsf(out[i] - kiss_out[i]);
+            err = d > err ? d : err;
+        }
+
+        printf("%5d points | nd::fft::rfft<N> %7.2f us | kissfft %7.2f us",
+               (int)N,
+               fixed,
+               kiss);
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+        /* arm_rfft_fast_f32 uses its input as scratch, copy it every run */
+        arm_rfft_fast_instance_f32 inst;
+        if (ARM_MATH_SUCCESS == arm_rfft_fast_init_f32(&inst, N)) {
+            double cmsis = bench_run([&] {
+                memcpy(kiss_out, src, N * sizeof(float));
+                arm_rfft_fast_f32(&inst, kiss_out, out, 0);
+            });
+            printf(" | arm_rfft_fast_f32 %7.2f us", cmsis);
+        }
+#endif
+
+        printf(" | max diff %.2e\r\n", err);
+    }
+
+cleanup:
+    if (src != OS_NULL) {
+        uai_mat_aligned_free(src);
+    }
+    if (out != OS_NULL) {
+        uai_mat_aligned_free(out);
+    }
+    fft::plan_destroy(plan);
+}
+
+static void bench_rfft_fixed(void)
+{
+    printf("rfft of one frame, size fixed at compile time\r\n");
+    bench_rfft_fixed_size<256>();
+    bench_rfft_fixed_size<512>();
+    bench_rfft_fixed_size<1024>();
+}
+
+/* Largest error of the bins against a double precision DFT, relative to the
+ * largest bin */
+static double bench_rfft_error(const float* src,
+                               os_size_t nfft,
+                               const kiss_fft_cpx* out)
+{
+    double err = 0.0;
+    double peak = 0.0;
+
+    for (os_size_t k = 0; k <= nfft / 2; k++) {
+        double re = 0.0;
+        double im = 0.0;
+        for (os_size_t i = 0; i < nfft; i++) {
+            double phase = -2.0 * M_PI * (double)((k * i) % nfft) / nfft;
+            re += src[i] * cos(phase);
+            im += src[i] * sin(phase);
+        }
+        double d = hypot(out[k].r - re, out[k].i - im);
+        double m = hypot(re, im);
+        err = d > err ? d : err;
+        peak = m > peak ? m : peak;
+    }
+
+    return peak > 0.0 ? err / peak : err;
+}
+
+/* Time and check one backend, returns the time or 0 if it has no size */
+static double bench_rfft_backend_run(fft_backend_t backend,
+                                     const float* src,
+                                     os_size_t nfft,
+                                     kiss_fft_cpx* out,
+                                     void* scratch,
+                                     double* err)
+{
+    if (!fft::backend_supports(backend, nfft)) {
+        return 0.0;
+    }
+
+    fft_plan_t* plan = fft::plan_create(nfft, backend);
+    if (OS_NULL == plan) {
+        return 0.0;
+    }
+
+    double t = bench_run([&] { fft::rfft(plan, src, out, scratch); });
+    *err = bench_rfft_error(src, nfft, out);
+
+    fft::plan_destroy(plan);
+    return t;
+}
+
+static void bench_rfft_backend(void)
+{
+    os_size_t max = 4096;
+
+    float* src = (float*)uai_mat_aligned_alloc(max * sizeof(float));
+    kiss_fft_cpx* out = (kiss_fft_cpx*)uai_mat_aligned_alloc(
+        (max / 2 + 1) * sizeof(kiss_fft_cpx));
+    void* scratch = uai_mat_aligned_alloc(2 * max * sizeof(kiss_fft_cpx));
+    if (OS_NULL == src || OS_NULL == out || OS_NULL == scratch) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(src, max, 4);
+
+    printf("rfft backends, error relative to the largest bin of a double "
+           "DFT\r\n");
+    for (os_size_t nfft = 32; nfft <= max; nfft *= 2) {
+        double kiss_err = 0.0;
+        double cmsis_err = 0.0;
+        double kiss = bench_rfft_backend_run(
+            FFT_BACKEND_KISSFFT, src, nfft, out, scratch, &kiss_err);
+        double cmsis = bench_rfft_backend_run(
+            FFT_BACKEND_CMSIS, src, nfft, out, scratch, &cmsis_err);
+
+        /* What plan_get() picks with the default auto backend */
+        const char* pick = "kissfft";
+        fft_plan_t* plan = fft::plan_create(nfft, FFT_BACKEND_AUTO);
+        if (plan != OS_NULL && FFT_BACKEND_CMSIS == fft::plan_backend(plan)) {
+            pick = "CMSIS";
+        }
+        fft::plan_destroy(plan);
+
+        printf("%5d points | kissfft %8.2f us err %.1e",
+               (int)nfft,
+               kiss,
+               kiss_err);
+        if (cmsis > 0.0) {
+            printf(" | CMSIS %8.2f us err %.1e | faster %-7s",
+                   cmsis,
+                   cmsis_err,
+                   cmsis < kiss ? "CMSIS" : "kissfft");
+        } else {
+            printf(" | CMSIS n/a | faster kissfft");
+        }
+        printf(" | auto %s\r\n", pick);
+    }
+
+cleanup:
+    if (scratch != OS_NULL) {
+        uai_mat_aligned_free(scratch);
+    }
+    if (src != OS_NULL) {
+        uai_mat_aligned_free(src);
+    }
+    if (out != OS_NULL) {
+        uai_mat_aligned_free(out);
+    }
+}
+
+static void bench_rfft_q31(void)
+{
+    os_size_t frame_len = 400;
+    os_size_t nfft = 512;
+    os_size_t bins = nfft / 2 + 1;
+
+    fft_q31_plan_t* qplan = fft::q31_plan_create(nfft);
+    fft_plan_t* plan = fft::plan_create(nfft, FFT_BACKEND_KISSFFT);
+    os_int16_t* pcm =
+        (os_int16_t*)uai_mat_aligned_alloc(frame_len * sizeof(os_int16_t));
+    float* samples = (float*)uai_mat_aligned_alloc(frame_len * sizeof(float));
+    float* power = (float*)uai_mat_aligned_alloc(bins * sizeof(float));
+    os_int32_t* qpower =
+        (os_int32_t*)uai_mat_aligned_alloc(bins * sizeof(os_int32_t));
+    void* scratch = OS_NULL;
+    void* qscratch = OS_NULL;
+    if (plan != OS_NULL && qplan != OS_NULL) {
+        scratch = uai_mat_aligned_alloc(dsp::rfft_scratch_size(plan));
+        qscratch = uai_mat_aligned_alloc(fft::rfft_q31_scratch_size(qplan));
+    }
+    if (OS_NULL == pcm || OS_NULL == samples || OS_NULL == power ||
+        OS_NULL == qpower || OS_NULL == scratch || OS_NULL == qscratch) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(samples, frame_len, 5);
+    for (os_size_t i = 0; i < frame_len; i++) {
+        pcm[i] = (os_int16_t)(samples[i] * 8000.0f);
+    }
+
+    {
+        double fl = bench_run([&] {
+            dsp::int16_to_float(pcm, samples, frame_len);
+            dsp::rfft(plan,
+                      samples,
+                      frame_len,
+                      power,
+                      bins,
+                      scratch,
+                      RFFT_OUT_POWER,
+                      0.0f);
+        });
+        int shift = 0;
+        double q31 = bench_run([&] {
+            fft::power_q31(qplan, pcm, frame_len, qpower, &shift, qscratch);
+        });
+
+        printf("int16 power spectrum %d -> %d | float %7.2f us | q31 %7.2f "
+               "us | shift %d\r\n",
+               (int)frame_len,
+               (int)nfft,
+               fl,
+               q31,
+               shift);
+    }
+
+cleanup:
+    if (qscratch != OS_NULL) {
+        uai_mat_aligned_free(qscratch);
+    }
+    if (scratch != OS_NULL) {
+        uai_mat_aligned_free(scratch);
+    }
+    if (qpower != OS_NULL) {
+        uai_mat_aligned_free(qpower);
+    }
+    if (power != OS_NULL) {
+        uai_mat_aligned_free(power);
+    }
+    if (samples != OS_NULL) {
+        uai_mat_aligned_free(samples);
+    }
+    if (pcm != OS_NULL) {
+        uai_mat_aligned_free(pcm);
+    }
+    fft::plan_destroy(plan);
+    fft::q31_plan_destroy(qplan);
+}
+
+static void bench_rfft_large(void)
+{
+    os_size_t max = NUMDL_BENCH_FFT_LARGE_MAX;
+
+    float* src = (float*)uai_mat_aligned_alloc(max * sizeof(float));
+    kiss_fft_cpx* out = (kiss_fft_cpx*)uai_mat_aligned_alloc(
+        (max / 2 + 1) * sizeof(kiss_fft_cpx));
+    if (OS_NULL == src || OS_NULL == out) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(src, max, 6);
+
+    printf("large rfft, four-step from %d points\r\n",
+           NUMDL_FFT_FOUR_STEP_MIN);
+    for (os_size_t nfft = 1 << 16; nfft <= max; nfft *= 4) {
+        fft_plan_t* plan = fft::plan_create(nfft, FFT_BACKEND_KISSFFT);
+        kiss_fftr_cfg cfg = kiss_fftr_alloc(nfft, 0, OS_NULL, OS_NULL);
+        /* four-step plans need more than nfft points of scratch */
+        os_size_t size = OS_NULL == plan ? 0 : fft::rfft_scratch_size(plan);
+        void* scratch = size > 0 ? uai_mat_aligned_alloc(size) : OS_NULL;
+        if (OS_NULL == plan || OS_NULL == cfg ||
+            (size > 0 && OS_NULL == scratch)) {
+            printf("no enough memory, skipped\r\n");
+            if (scratch != OS_NULL) {
+                uai_mat_aligned_free(scratch);
+            }
+            fft::plan_destroy(plan);
+            kiss_fftr_free(cfg);
+            break;
+        }
+
+        double kiss = bench_run([&] { kiss_fftr(cfg, src, out); });
+        double single = bench_run([&] {
+            fft::rfft(plan, src, out, scratch);
+        });
+        dsp::set_num_threads(NUMDL_BENCH_FFT_THREADS);
+        double threads = bench_run([&] {
+            fft::rfft(plan, src, out, scratch);
+        });
+        dsp::set_num_threads(1);
+
+        printf("%8d points | kiss_fftr %10.1f us | fft::rfft %10.1f us | "
+               "%d threads %10.1f us\r\n",
+               (int)nfft,
+               kiss,
+               single,
+               NUMDL_BENCH_FFT_THREADS,
+               threads);
+
+        if (scratch != OS_NULL) {
+            uai_mat_aligned_free(scratch);
+        }
+        kiss_fftr_free(cfg);
+        fft::plan_destroy(plan);
+    }
+
+cleanup:
+    if (src != OS_NULL) {
+        uai_mat_aligned_free(src);
+    }
+    if (out != OS_NULL) {
+        uai_mat_aligned_free(out);
+    }
+}
+
+static void bench_case(void)
+{
+    ATEST_UNIT_RUN(bench_rfft_batch);
+    ATEST_UNIT_RUN(bench_rfft_rows);
+    ATEST_UNIT_RUN(bench_rfft_fixed);
+    ATEST_UNIT_RUN(bench_rfft_backend);
+    ATEST_UNIT_RUN(bench_rfft_q31);
+    ATEST_UNIT_RUN(bench_rfft_large);
+}
+
+static os_err_t bench_init(void)
+{
+    return OS_EOK;
+}
+
+static os_err_t bench_cleanup(void)
+{
+    return OS_EOK;
+}
+
+ATEST_TC_EXPORT(uai_sdk.feature.fft.bench,
+                bench_case,
+                bench_init,
+                bench_cleanup,
+                TC_PRIORITY_MIDDLE);
+
+}  // namespace feature
+}  // namespace uai
@@ -0,0 +1,541 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ * @file        uai_gemm_bench.cc
+ *
+ * @brief       Compare dsp::dot against the naive dsp::dot_by_row loop.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_bench.h"
+
+#include <uai_dsp.h>
+#include <uai_qgemm.h>
+#include <nd_errno.h>
+#include <uai_matrix.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <atest.h>
+#include <os_errno.h>
+#include <os_memory.h>
+
+#ifndef NUMDL_BENCH_GEMM_MIN_SIZE
+#define NUMDL_BENCH_GEMM_MIN_SIZE (16)
+#endif
+
+#ifndef NUMDL_BENCH_GEMM_MAX_SIZE
+#define NUMDL_BENCH_GEMM_MAX_SIZE (2048)
+#endif
+
+#ifndef NUMDL_BENCH_GEMM_THREADS_SIZE
+#define NUMDL_BENCH_GEMM_THREADS_SIZE (1024)
+#endif
+
+#ifndef NUMDL_BENCH_GEMM_THREADS_MAX
+#define NUMDL_BENCH_GEMM_THREADS_MAX (16)
+#endif
+
+#ifndef NUMDL_BENCH_GEMV_MAX_SIZE
+#define NUMDL_BENCH_GEMV_MAX_SIZE (2048)
+#endif
+
+#ifndef NUMDL_BENCH_GEMV_BATCH
+#define NUMDL_BENCH_GEMV_BATCH (4)
+#endif
+
+#ifndef NUMDL_BENCH_QGEMM_MAX_SIZE
+#define NUMDL_BENCH_QGEMM_MAX_SIZE (1024)
+#endif
+
+#ifndef NUMDL_BENCH_MEL_FRAMES
+#define NUMDL_BENCH_MEL_FRAMES (100)
+#endif
+
+#ifndef NUMDL_BENCH_MEL_BINS
+#define NUMDL_BENCH_MEL_BINS (257)
+#endif
+
+#ifndef NUMDL_BENCH_MEL_FILTERS
+#define NUMDL_BENCH_MEL_FILTERS (40)
+#endif
+
+namespace uai {
+namespace feature {
+
+static void naive_dot(uai_mat_t* mat1, uai_mat_t* mat2, uai_mat_t* output)
+{
+    for (os_size_t i = 0; i < mat1->rows; i++) {
+        dsp::dot_by_row(
+            i, mat1->data + (i * mat1->cols), mat1->cols, mat2, output);
+    }
+}
+
+static void bench_gemm_square(os_size_t size)
+{
+    uai_mat_t* a = uai_mat_create(size, size);
+    uai_mat_t* b = uai_mat_create(size, size);
+    uai_mat_t* c_naive = uai_mat_create(size, size);
+    uai_mat_t* c_gemm = uai_mat_create(size, size);
+    if (OS_NULL == a || OS_NULL == b || OS_NULL == c_naive ||
+        OS_NULL == c_gemm) {
+        printf("%6d: no enough memory, skipped\r\n", (int)size);
+        goto cleanup;
+    }
+
+    bench_fill(a->data, size * size, 1);
+    bench_fill(b->data, size * size, 2);
+
+    {
+        double naive_us = bench_run([&] { naive_dot(a, b, c_naive); });
+        double gemm_us = bench_run([&] { dsp::dot(a, b, c_gemm); });
+
+        float max_err = 0.0f;
+        for (os_size_t i = 0; i < size * size; i++) {
+            float err = fabsf(c_naive->data[i] - c_gemm->data[i]);
+            max_err = err > max_err ? err : max_err;
+        }
+
+        double flops = 2.0 * size * size * size;
+        printf("%6d: naive %12.1f us %8.3f GFLOPS | dot %12.1f us %8.3f "
+               "GFLOPS | x%6.2f | max err %g\r\n",
+               (int)size,
+               naive_us,
+               flops / naive_us / 1000.0,
+               gemm_us,
+               flops / gemm_us / 1000.0,
+               naive_us / gemm_us,
+               max_err);
+    }
+
+cleanup:
+    if (a != OS_NULL) {
+        uai_mat_destroy(a);
+    }
+    if (b != OS_NULL) {
+        uai_mat_destroy(b);
+    }
+    if (c_naive != OS_NULL) {
+        uai_mat_destroy(c_naive);
+    }
+    if (c_gemm != OS_NULL) {
+        uai_mat_destroy(c_gemm);
+    }
+}
+
+static void bench_gemm(void)
+{
+    printf("gemm square NxN * NxN\r\n");
+    for (os_size_t size = NUMDL_BENCH_GEMM_MIN_SIZE;
+         size <= NUMDL_BENCH_GEMM_MAX_SIZE;
+         size *= 2) {
+        bench_gemm_square(size);
+    }
+}
+
+static void bench_gemm_threads(void)
+{
+    os_size_t size = NUMDL_BENCH_GEMM_THREADS_SIZE;
+
+    uai_mat_t* a = uai_mat_create(size, size);
+    uai_mat_t* b = uai_mat_create(size, size);
+    uai_mat_t* c = uai_mat_create(size, size);
+    if (OS_NULL == a || OS_NULL == b || OS_NULL == c) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(a->data, size * size, 1);
+    bench_fill(b->data, size * size, 2);
+
+    printf("gemm %dx%d threads scaling\r\n", (int)size, (int)size);
+    for (os_size_t threads = 1; threads <= NUMDL_BENCH_GEMM_THREADS_MAX;
+         threads *= 2) {
+        if (dsp::set_num_threads(threads) != NUMDL_EOK) {
+            break;
+        }
+
+        double us = bench_run([&] { dsp::dot(a, b, c); });
+        printf("%3d threads: %12.1f us %8.3f GFLOPS\r\n",
+               (int)threads,
+               us,
+               2.0 * size * size * size / us / 1000.0);
+    }
+    dsp::set_num_threads(1);
+
+cleanup:
+    if (a != OS_NULL) {
+        uai_mat_destroy(a);
+    }
+    if (b != OS_NULL) {
+        uai_mat_destroy(b);
+    }
+    if (c != OS_NULL) {
+        uai_mat_destroy(c);
+    }
+}
+
+static void bench_gemv_size(os_size_t size)
+{
+    os_size_t batch = NUMDL_BENCH_GEMV_BATCH;
+
+    uai_mat_t* w = uai_mat_create(size, size);
+    uai_mat_t* x = uai_mat_create(batch, size);
+    uai_mat_t* y = uai_mat_create(batch, size);
+    if (OS_NULL == w || OS_NULL == x || OS_NULL == y) {
+        printf("%6d: no enough memory, skipped\r\n", (int)size);
+        goto cleanup;
+    }
+
+    bench_fill(w->data, size * size, 1);
+    bench_fill(x->data, batch * size, 2);
+
+    {
+        double naive_us = bench_run(
+            [&] { dsp::dot_by_row(0, x->data, size, w, y); });
+        double gemv_us = bench_run([&] {
+            dsp::gemv(w, GEMM_TRANS, x->data, y->data, OS_NULL);
+        });
+        double gemv_t_us = bench_run([&] {
+            dsp::gemv(w, GEMM_TRANS_NONE, x->data, y->data, OS_NULL);
+        });
+        double loop_us = bench_run([&] {
+            for (os_size_t f = 0; f < batch; f++) {
+                dsp::gemv(w,
+                          GEMM_TRANS,
+                          x->data + f * size,
+                          y->data + f * size,
+                          OS_NULL);
+            }
+        });
+        double batch_us = bench_run(
+            [&] { dsp::gemv_batch(w, GEMM_TRANS, x, y, OS_NULL); });
+        double gemm_us = bench_run([&] { dsp::dot(x, w, y); });
+
+        printf("%6d: x*W naive %10.1f us | x*W %10.1f us | Wt*x %10.1f us "
+               "| %d frames: loop %10.1f us, batch %10.1f us, gemm %10.1f "
+               "us\r\n",
+               (int)size,
+               naive_us,
+               gemv_us,
+               gemv_t_us,
+               (int)batch,
+               loop_us,
+               batch_us,
+               gemm_us);
+    }
+
+cleanup:
+    if (w != OS_NULL) {
+        uai_mat_destroy(w);
+    }
+    if (x != OS_NULL) {
+        uai_mat_destroy(x);
+    }
+    if (y != OS_NULL) {
+        uai_mat_destroy(y);
+    }
+}
+
+static void bench_gemv(void)
+{
+    printf("gemv 1xN * NxN and batched frames\r\n");
+    for (os_size_t size = NUMDL_BENCH_GEMM_MIN_SIZE * 4;
+         size <= NUMDL_BENCH_GEMV_MAX_SIZE;
+         size *= 2) {
+        bench_gemv_size(size);
+    }
+}
+
+static void bench_gemm_epilogue(void)
+{
+    os_size_t frames = NUMDL_BENCH_MEL_FRAMES;
+    os_size_t bins = NUMDL_BENCH_MEL_BINS;
+    os_size_t filters = NUMDL_BENCH_MEL_FILTERS;
+
+    uai_mat_t* power = uai_mat_create(frames, bins);
+    uai_mat_t* mel = uai_mat_create(bins, filters);
+    uai_mat_t* c_split = uai_mat_create(frames, filters);
+    uai_mat_t* c_fused = uai_mat_create(frames, filters);
+    if (OS_NULL == power || OS_NULL == mel || OS_NULL == c_split ||
+        OS_NULL == c_fused) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(power->data, frames * bins, 3);
+    bench_fill(mel->data, bins * filters, 4);
+    for (os_size_t i = 0; i < frames * bins; i++) {
+        power->data[i] = power->data[i] * power->data[i];
+    }
+    for (os_size_t i = 0; i < bins * filters; i++) {
+        mel->data[i] = fabsf(mel->data[i]);
+    }
+
+    {
+        gemm_epilogue_t ep;
+        gemm::epilogue_init(&ep);
+        ep.log = GEMM_LOG_E;
+
+        double split_us = bench_run([&] {
+            dsp::dot(power, mel, c_split);
+            dsp::log(c_split);
+        });
+        double fused_us =
+            bench_run([&] { dsp::dot(power, mel, c_fused, &ep); });
+
+        float max_err = 0.0f;
+        for (os_size_t i = 0; i < frames * filters; i++) {
+            float err = fabsf(c_split->data[i] - c_fused->data[i]);
+            max_err = err > max_err ? err : max_err;
+        }
+
+        printf("mel %dx%d * %dx%d + log: dot, log %10.1f us | fused "
+               "%10.1f us | x%6.2f | max err %g\r\n",
+               (int)frames,
+               (int)bins,
+               (int)bins,
+               (int)filters,
+               split_us,
+               fused_us,
+               split_us / fused_us,
+               max_err);
+    }
+
+cleanup:
+    if (power != OS_NULL) {
+        uai_mat_destroy(power);
+    }
+    if (mel != OS_NULL) {
+        uai_mat_destroy(mel);
+    }
+    if (c_split != OS_NULL) {
+        uai_mat_destroy(c_split);
+    }
+    if (c_fused != OS_NULL) {
+        uai_mat_destroy(c_fused);
+    }
+}
+
+static void bench_transpose_size(os_size_t size)
+{
+    uai_mat_t* a = uai_mat_create(size, size);
+    uai_mat_t* t = uai_mat_create(size, size);
+    if (OS_NULL == a || OS_NULL == t) {
+        printf("%6d: no enough memory, skipped\r\n", (int)size);
+        goto cleanup;
+    }
+
+    bench_fill(a->data, size * size, 1);
+
+    {
+        double naive_us = bench_run([&] {
+            for (os_size_t i = 0; i < size; i++) {
+                for (os_size_t j = 0; j < size; j++) {
+                    t->data[j * size + i] = a->data[i * size + j];
+                }
+            }
+        });
+        double blocked_us = bench_run([&] { uai_mat_transpose(t, a); });
+
+        printf("%6d: naive %10.1f us | blocked %10.1f us | x%6.2f\r\n",
+               (int)size,
+               naive_us,
+               blocked_us,
+               naive_us / blocked_us);
+    }
+
+cleanup:
+    if (a != OS_NULL) {
+        uai_mat_destroy(a);
+    }
+    if (t != OS_NULL) {
+        uai_mat_destroy(t);
+    }
+}
+
+static void bench_transpose(void)
+{
+    printf("transpose NxN\r\n");
+    for (os_size_t size = NUMDL_BENCH_GEMM_MIN_SIZE * 4;
+         size <= NUMDL_BENCH_GEMM_MAX_SIZE;
+         size *= 2) {
+        bench_transpose_size(size);
+    }
+}
+
+/** Scalar loop in the order of the CMSIS-NN C fallback */
+static void naive_qgemm(const os_int8_t* lhs,
+                        const os_int8_t* rhs,
+                        os_int8_t* dst,
+                        os_int32_t size,
+                        os_int32_t multiplier,
+                        os_int32_t shift)
+{
+    for (os_int32_t r = 0; r < size; r++) {
+        for (os_int32_t c = 0; c < size; c++) {
+            os_int32_t acc = 0;
+            for (os_int32_t i = 0; i < size; i++) {
+                acc += (lhs[r * size + i] + 3) * rhs[c * size + i];
+            }
+            acc = qgemm::requantize(acc, multiplier, shift);
+            dst[r * size + c] =
+                (os_int8_t)(acc < -128 ? -128 : (acc > 127 ? 127 : acc));
+        }
+    }
+}
+
+static void bench_qgemm_size(os_int32_t size)
+{
+    os_int8_t* lhs = (os_int8_t*)os_malloc(size * size);
+    os_int8_t* rhs = (os_int8_t*)os_malloc(size * size);
+    os_int8_t* d_naive = (os_int8_t*)os_malloc(size * size);
+    os_int8_t* d_q = (os_int8_t*)os_malloc(size * size);
+    os_int32_t* mults = (os_int32_t*)os_malloc(size * sizeof(os_int32_t));
+    os_int32_t* shifts = (os_int32_t*)os_malloc(size * sizeof(os_int32_t));
+    uai_mat_t* a = uai_mat_create(size, size);
+    uai_mat_t* b = uai_mat_create(size, size);
+    uai_mat_t* c = uai_mat_create(size, size);
+    if (OS_NULL == lhs || OS_NULL == rhs || OS_NULL == d_naive ||
+        OS_NULL == d_q || OS_NULL == mults || OS_NULL == shifts ||
+        OS_NULL == a || OS_NULL == b || OS_NULL == c) {
+        printf("%6d: no enough memory, skipped\r\n", (int)size);
+        goto cleanup;
+    }
+
+    bench_fill(a->data, size * size, 1);
+    bench_fill(b->data, size * size, 2);
+    for (os_int32_t i = 0; i < size * size; i++) {
+        lhs[i] = (os_int8_t)(a->data[i] * 127.0f);
+        rhs[i] = (os_int8_t)(b->data[i] * 127.0f);
+    }
+    qgemm::quantize_multiplier(1.0 / (64.0 * size), &mults[0], &shifts[0]);
+    for (os_int32_t i = 1; i < size; i++) {
+        mults[i] = mults[0];
+        shifts[i] = shifts[0];
+    }
+
+    {
+        double naive_us = bench_run([&] {
+            naive_qgemm(lhs, rhs, d_naive, size, mults[0], shifts[0]);
+        });
+        double q_us = bench_run([&] {
+            qgemm::mat_mult_nt_t_s8(lhs,
+                                    rhs,
+                                    OS_NULL,
+                                    d_q,
+                                    mults,
+                                    shifts,
+                                    size,
+                                    size,
+                                    size,
+                                    3,
+                                    0,
+                                    -128,
+                                    127);
+        });
+        double f_us = bench_run([&] { dsp::dot(a, b, c); });
+
+        os_int32_t diff = 0;
+        for (os_int32_t i = 0; i < size * size; i++) {
+            diff += d_naive[i] != d_q[i];
+        }
+
+        double ops = 2.0 * size * size * size;
+        printf("%6d: naive %12.1f us | qgemm %12.1f us %8.3f GOPS | x%6.2f "
+               "| float dot %12.1f us | mismatches %d\r\n",
+               (int)size,
+               naive_us,
+               q_us,
+               ops / q_us / 1000.0,
+               naive_us / q_us,
+               f_us,
+               (int)diff);
+    }
+
+cleanup:
+    if (lhs != OS_NULL) {
+        os_free(lhs);
+    }
+    if (rhs != OS_NULL) {
+        os_free(rhs);
+    }
+    if (d_naive != OS_NULL) {
+        os_free(d_naive);
+    }
+    if (d_q != OS_NULL) {
+        os_free(d_q);
+    }
+    if (mults != OS_NULL) {
+        os_free(mults);
+    }
+    if (shifts != OS_NULL) {
+        os_free(shifts);
+    }
+    if (a != OS_NULL) {
+        uai_mat_destroy(a);
+    }
+    if (b != OS_NULL) {
+        uai_mat_destroy(b);
+    }
+    if (c != OS_NULL) {
+        uai_mat_destroy(c);
+    }
+}
+
+static void bench_qgemm(void)
+{
+    printf("qgemm s8 NxN * (NxN)^T\r\n");
+    for (os_int32_t size = NUMDL_BENCH_GEMM_MIN_SIZE * 4;
+         size <= NUMDL_BENCH_QGEMM_MAX_SIZE;
+         size *= 2) {
+        bench_qgemm_size(size);
+    }
+}
+
+static void bench_case(void)
+{
+    ATEST_UNIT_RUN(bench_gemm);
+    ATEST_UNIT_RUN(bench_gemm_threads);
+    ATEST_UNIT_RUN(bench_gemv);
+    ATEST_UNIT_RUN(bench_gemm_epilogue);
+    ATEST_UNIT_RUN(bench_qgemm);
+    ATEST_UNIT_RUN(bench_transpose);
+}
+
+static os_err_t bench_init(void)
+{
+    return OS_EOK;
+}
+
+static os_err_t bench_cleanup(void)
+{
+    return OS_EOK;
+}
+
+ATEST_TC_EXPORT(uai_sdk.feature.gemm.bench,
+                bench_case,
+                bench_init,
+                bench_cleanup,
+                TC_PRIORITY_MIDDLE);
+
+}  // namespace feature
+}  // namespace uai
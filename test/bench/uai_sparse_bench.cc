@@ -0,0 +1,195 @@
+/**
+ *******************************************************************************
+ * Copyright (c) 2026, China Mobile Communications Group Co.,Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ *use this file except in compliance with the License. You may obtain a copy of
+ *the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ *distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *License for the specific language governing permissions and limitations under
+ *the License.
+ *
+ *
+ * @file        uai_sparse_bench.cc
+ *
+ * @brief       Find the density where CSR / BSR products overtake dense dot.
+ *
+ * @revision
+ * Date         Author          Notes
+ * 2026-10-17   OneOS AI Team   First Version
+ *******************************************************************************
+ */
+
+#include "uai_bench.h"
+
+#include <uai_dsp.h>
+#include <nd_errno.h>
+#include <uai_matrix.h>
+
+#include <stdio.h>
+
+#include <atest.h>
+#include <os_errno.h>
+
+
+#ifndef NUMDL_BENCH_SPARSE_SIZE
+#define NUMDL_BENCH_SPARSE_SIZE (512)
+#endif
+
+#ifndef NUMDL_BENCH_SPARSE_FRAMES
+#define NUMDL_BENCH_SPARSE_FRAMES (32)
+#endif
+
+namespace uai {
+namespace feature {
+
+/**
+ * Keep about `density` of the 1x4 groups of w, like a structured pruning of
+ * fully connected weights
+ */
+static void bench_prune(uai_mat_t* w, float density)
+{
+    os_uint32_t seed = 7;
+
+    for (os_size_t i = 0; i < w->rows * w->cols; i += 4) {
+        seed = seed * 1664525u + 1013904223u;
+        if ((float)(seed >> 8) / (float)(1u << 24) < density) {
+            continue;
+        }
+        for (os_size_t j = i; j < i + 4 && j < w->rows * w->cols; j++) {
+            w->data[j] = 0.0f;
+        }
+    }
+}
+
+static void bench_sparse_density(float density)
+{
+    os_size_t size = NUMDL_BENCH_SPARSE_SIZE;
+    os_size_t frames = NUMDL_BENCH_SPARSE_FRAMES;
+
+    uai_mat_csr_t* csr = OS_NULL;
+    uai_mat_bsr_t* bsr14 = OS_NULL;
+    uai_mat_bsr_t* bsr44 = OS_NULL;
+    uai_mat_t* w = uai_mat_create(size, size);
+    uai_mat_t* x = uai_mat_create(size, frames);
+    uai_mat_t* y = uai_mat_create(size, frames);
+    uai_mat_t* xv = uai_mat_create(1, size);
+    uai_mat_t* yv = uai_mat_create(1, size);
+    if (OS_NULL == w || OS_NULL == x || OS_NULL == y || OS_NULL == xv ||
+        OS_NULL == yv) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    bench_fill(w->data, size * size, 1);
+    bench_fill(x->data, size * frames, 2);
+    bench_fill(xv->data, size, 3);
+    bench_prune(w, density);
+
+    csr = uai_mat_csr_from_dense(w, 0.0f);
+    bsr14 = uai_mat_bsr_from_dense(w, 1, 4, 0.0f);
+    bsr44 = uai_mat_bsr_from_dense(w, 4, 4, 0.0f);
+    if (OS_NULL == csr || OS_NULL == bsr14 || OS_NULL == bsr44) {
+        printf("no enough memory, skipped\r\n");
+        goto cleanup;
+    }
+
+    {
+        double dense_mm = bench_run([&] { dsp::dot(w, x, y); });
+        double csr_mm = bench_run([&] { dsp::dot(csr, x, y); });
+        double bsr14_mm = bench_run([&] { dsp::dot(bsr14, x, y); });
+        double bsr44_mm = bench_run([&] { dsp::dot(bsr44, x, y); });
+
+        double dense_mv = bench_run([&] {
+            dsp::gemv(w, GEMM_TRANS_NONE, xv->data, yv->data, OS_NULL);
+        });
+        double csr_mv = bench_run([&] { dsp::gemv(csr, xv->data, yv->data); });
+        double bsr14_mv =
+            bench_run([&] { dsp::gemv(bsr14, xv->data, yv->data); });
+        double bsr44_mv =
+            bench_run([&] { dsp::gemv(bsr44, xv->data, yv->data); });
+
+        printf("%5.1f%% (4x4 fill %5.1f%%) | mm dense %9.1f csr %9.1f "
+               "bsr1x4 %9.1f bsr4x4 %9.1f us | mv dense %7.1f csr %7.1f "
+               "bsr1x4 %7.1f bsr4x4 %7.1f us\r\n",
+               100.0 * csr->nnz / (size * size),
+               100.0 * bsr44->nnzb * 16 / (size * size),
+               dense_mm,
+               csr_mm,
+               bsr14_mm,
+               bsr44_mm,
+               dense_mv,
+               csr_mv,
+               bsr14_mv,
+               bsr44_mv);
+    }
+
+cleanup:
+    if (csr != OS_NULL) {
+        uai_mat_csr_destroy(csr);
+    }
+    if (bsr14 != OS_NULL) {
+        uai_mat_bsr_destroy(bsr14);
+    }
+    if (bsr44 != OS_NULL) {
+        uai_mat_bsr_destroy(bsr44);
+    }
+    if (w != OS_NULL) {
+        uai_mat_destroy(w);
+    }
+    if (x != OS_NULL) {
+        uai_mat_destroy(x);
+    }
+    if (y != OS_NULL) {
+        uai_mat_destroy(y);
+    }
+    if (xv != OS_NULL) {
+        uai_mat_destroy(xv);
+    }
+    if (yv != OS_NULL) {
+        uai_mat_destroy(yv);
+    }
+}
+
+static void bench_sparse(void)
+{
+    static const float densities[] = {
+        0.02f, 0.05f, 0.1f, 0.2f, 0.3f, 0.5f, 0.7f, 1.0f};
+
+    printf("sparse %dx%d weights, mm with %d frames, mv with one\r\n",
+           NUMDL_BENCH_SPARSE_SIZE,
+           NUMDL_BENCH_SPARSE_SIZE,
+           NUMDL_BENCH_SPARSE_FRAMES);
+    for (os_size_t i = 0; i < sizeof(densities) / sizeof(densities[0]); i++) {
+        bench_sparse_density(densities[i]);
+    }
+}
+
+static void bench_case(void)
+{
+    ATEST_UNIT_RUN(bench_sparse);
+}
+
+static os_err_t bench_init(void)
+{
+    return OS_EOK;
+}
+
+static os_err_t bench_cleanup(void)
+{
+    return OS_EOK;
+}
+
+ATEST_TC_EXPORT(uai_sdk.feature.sparse.bench,
+                bench_case,
+                bench_init,
+                bench_cleanup,
+                TC_PRIORITY_MIDDLE);
+
+}  // namespace feature
+}  // namespace uai
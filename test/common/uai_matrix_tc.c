@@ -51,9 +51,94 @@ static void test_mat_create_and_destory(void)
     }
 }
 
+static void test_mat_view(void)
+{
+    uai_mat_t* mat = uai_mat_create(4, 6);
+    tp_assert_not_null(mat);
+
+    for (os_size_t i = 0; i < 4 * 6; i++) {
+        mat->data[i] = (float)i;
+    }
+
+    uai_mat_view_t view;
+    tp_assert_integer_equal(uai_mat_view_init(&view, mat), NUMDL_EOK);
+    tp_assert_true(uai_mat_view_ptr(&view, 2, 3) == &mat->data[2 * 6 + 3]);
+
+    uai_mat_view_t block;
+    tp_assert_integer_equal(uai_mat_view_block(&block, &view, 1, 2, 3, 4),
+                            NUMDL_EOK);
+    tp_assert_integer_equal(block.rows, 3);
+    tp_assert_integer_equal(block.cols, 4);
+    tp_assert_true(*uai_mat_view_ptr(&block, 0, 0) == 8.0f);
+    tp_assert_true(*uai_mat_view_ptr(&block, 2, 3) == 23.0f);
+
+    uai_mat_view_t trans;
+    tp_assert_integer_equal(uai_mat_view_transpose(&trans, &block), NUMDL_EOK);
+    tp_assert_integer_equal(trans.rows, 4);
+    tp_assert_integer_equal(trans.cols, 3);
+    tp_assert_true(*uai_mat_view_ptr(&trans, 3, 2) == 23.0f);
+    tp_assert_true(*uai_mat_view_ptr(&trans, 1, 0) == 9.0f);
+
+    tp_assert_integer_equal(uai_mat_view_block(&block, &trans, 1, 1, 3, 2),
+                            NUMDL_EOK);
+    tp_assert_true(*uai_mat_view_ptr(&block, 0, 0) == 15.0f);
+    tp_assert_integer_equal(uai_mat_view_block(&block, &trans, 1, 1, 4, 2),
+                            NUMDL_EINVAL);
+
+    uai_mat_destroy(mat);
+}
+
+static void test_mat_aligned(void)
+{
+    for (os_size_t cols = 1; cols <= MAT_MAX_COLS; cols++) {
+        uai_mat_t* mat = uai_mat_create(3, cols);
+        tp_assert_not_null(mat);
+        tp_assert_integer_equal((os_size_t)mat->data % UAI_MAT_ALIGN, 0);
+        uai_mat_destroy(mat);
+    }
+}
+
+static void test_mat_arena(void)
+{
+    static os_uint8_t buff[1024 + 3];
+    uai_mat_arena_t arena;
+
+    /* Deliberately misaligned backing buffer */
+    tp_assert_integer_equal(uai_mat_arena_init(&arena, buff + 3, 1024),
+                            NUMDL_EOK);
+
+    uai_mat_t* mat1 = uai_mat_create_in(&arena, 2, 3);
+    tp_assert_not_null(mat1);
+    tp_assert_integer_equal((os_size_t)mat1->data % UAI_MAT_ALIGN, 0);
+    tp_assert_true(mat1->data[5] == 0.0f);
+
+    uai_mat_arena_mark_t mark = uai_mat_arena_mark(&arena);
+
+    float* tmp = uai_mat_buffer_in(&arena, 16);
+    tp_assert_not_null(tmp);
+    tp_assert_integer_equal((os_size_t)tmp % UAI_MAT_ALIGN, 0);
+
+    uai_mat_arena_reset_to(&arena, mark);
+    tp_assert_true(uai_mat_buffer_in(&arena, 16) == tmp);
+
+    tp_assert_null(uai_mat_create_in(&arena, 32, 32));
+    tp_assert_true(uai_mat_arena_mark(&arena) >= mark);
+
+    uai_mat_arena_reset(&arena);
+    tp_assert_integer_equal(uai_mat_arena_mark(&arena), 0);
+
+    uai_mat_arena_t* heap = uai_mat_arena_create(4096);
+    tp_assert_not_null(heap);
+    tp_assert_not_null(uai_mat_create_in(heap, 8, 8));
+    uai_mat_arena_destroy(heap);
+}
+
 static void test_case(void)
 {
     //ATEST_UNIT_RUN(test_mat_create_and_destory);
+    ATEST_UNIT_RUN(test_mat_view);
+    ATEST_UNIT_RUN(test_mat_aligned);
+    ATEST_UNIT_RUN(test_mat_arena);
     return;
 }
 
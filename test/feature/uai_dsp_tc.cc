@@ -24,13 +24,20 @@
 
 #include "testdata/yes_30ms_testdata.h"
 
+#include <uai_dct.h>
+#include <uai_dct_block.h>
 #include <uai_dsp.h>
+#include <uai_fft.h>
+#include <uai_qgemm.h>
 #include <nd_errno.h>
 #include <uai_matrix.h>
 
+#include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <atest.h>
+#include <kiss_fftr.h>
 #include <os_errno.h>
 #include <os_clock.h>
 #include <os_stddef.h>
@@ -44,6 +51,10 @@
 #define CONSTANT_E_3 (20.0855369231876677418)
 #define CONSTANT_E_4 (54.5981500331442390813)
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846264338327950288
+#endif  // M_PI
+
 
 namespace uai {
 namespace feature {
@@ -105,6 +116,1681 @@ static void test_mat_dot(void)
     uai_mat_destroy(output);
 }
 
+static void test_mat_dot_blocked(void)
+{
+    /* Odd sizes exercise the partial register tiles and several K panels */
+    os_size_t m = 37, k = 301, n = 29;
+
+    uai_mat_t* mat1 = uai_mat_create(m, k);
+    uai_mat_t* mat2 = uai_mat_create(k, n);
+    uai_mat_t* output = uai_mat_create(m, n);
+    uai_mat_t* expect = uai_mat_create(m, n);
+
+    for (os_size_t i = 0; i < m * k; i++) {
+        mat1->data[i] = (float)((i * 7) % 13) / 13.0f - 0.5f;
+    }
+    for (os_size_t i = 0; i < k * n; i++) {
+        mat2->data[i] = (float)((i * 5) % 11) / 11.0f - 0.5f;
+    }
+
+    for (os_size_t i = 0; i < m; i++) {
+        dsp::dot_by_row(i, mat1->data + i * k, k, mat2, expect);
+    }
+
+    int ret = dsp::dot(mat1, mat2, output);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+
+    os_bool_t dot_check = OS_TRUE;
+    for (os_size_t i = 0; i < m * n; i++) {
+        if ((output->data[i] < expect->data[i] - REL_ERROR) ||
+            (output->data[i] > expect->data[i] + REL_ERROR)) {
+            dot_check = OS_FALSE;
+            break;
+        }
+    }
+    tp_assert_true(dot_check);
+
+    uai_mat_destroy(mat1);
+    uai_mat_destroy(mat2);
+    uai_mat_destroy(output);
+    uai_mat_destroy(expect);
+}
+
+static void test_mat_dot_threads(void)
+{
+    os_size_t m = 131, k = 97, n = 75;
+
+    uai_mat_t* mat1 = uai_mat_create(m, k);
+    uai_mat_t* mat2 = uai_mat_create(k, n);
+    uai_mat_t* single = uai_mat_create(m, n);
+    uai_mat_t* multi = uai_mat_create(m, n);
+
+    for (os_size_t i = 0; i < m * k; i++) {
+        mat1->data[i] = (float)((i * 7) % 13) / 13.0f - 0.5f;
+    }
+    for (os_size_t i = 0; i < k * n; i++) {
+        mat2->data[i] = (float)((i * 5) % 11) / 11.0f - 0.5f;
+    }
+
+    dsp::set_num_threads(1);
+    int ret = dsp::dot(mat1, mat2, single);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+
+    for (os_size_t threads = 2; threads <= 5; threads++) {
+        dsp::set_num_threads(threads);
+        ret = dsp::dot(mat1, mat2, multi);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(
+            0 == memcmp(single->data, multi->data, m * n * sizeof(float)));
+    }
+    dsp::set_num_threads(1);
+
+    uai_mat_destroy(mat1);
+    uai_mat_destroy(mat2);
+    uai_mat_destroy(single);
+    uai_mat_destroy(multi);
+}
+
+static void test_mat_dot_epilogue(void)
+{
+    /* Several K panels, the epilogue must only see the final sums */
+    os_size_t m = 37, k = 301, n = 29;
+
+    uai_mat_t* mat1 = uai_mat_create(m, k);
+    uai_mat_t* mat2 = uai_mat_create(k, n);
+    uai_mat_t* output = uai_mat_create(m, n);
+    uai_mat_t* expect = uai_mat_create(m, n);
+    float bias[29];
+
+    for (os_size_t i = 0; i < m * k; i++) {
+        mat1->data[i] = (float)((i * 7) % 13) / 13.0f - 0.5f;
+    }
+    for (os_size_t i = 0; i < k * n; i++) {
+        mat2->data[i] = (float)((i * 5) % 11) / 11.0f - 0.5f;
+    }
+    for (os_size_t j = 0; j < n; j++) {
+        bias[j] = (float)j * 0.1f - 1.0f;
+    }
+
+    gemm_epilogue_t ep;
+    gemm::epilogue_init(&ep);
+    ep.bias = bias;
+    ep.scale = 0.5f;
+    ep.act = GEMM_ACT_RELU;
+    ep.log = GEMM_LOG_10;
+    ep.log_floor = 1.0e-3f;
+
+    dsp::dot(mat1, mat2, expect);
+    for (os_size_t i = 0; i < m; i++) {
+        for (os_size_t j = 0; j < n; j++) {
+            float v = expect->data[i * n + j] * 0.5f + bias[j];
+            v = v < 0.0f ? 0.0f : v;
+            expect->data[i * n + j] = log10f(v < 1.0e-3f ? 1.0e-3f : v);
+        }
+    }
+
+    for (os_size_t threads = 1; threads <= 3; threads++) {
+        dsp::set_num_threads(threads);
+        int ret = dsp::dot(mat1, mat2, output, &ep);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+
+        os_bool_t dot_check = OS_TRUE;
+        for (os_size_t i = 0; i < m * n; i++) {
+            if ((output->data[i] < expect->data[i] - REL_ERROR) ||
+                (output->data[i] > expect->data[i] + REL_ERROR)) {
+                dot_check = OS_FALSE;
+                break;
+            }
+        }
+        tp_assert_true(dot_check);
+    }
+    dsp::set_num_threads(1);
+
+    uai_mat_destroy(mat1);
+    uai_mat_destroy(mat2);
+    uai_mat_destroy(output);
+    uai_mat_destroy(expect);
+}
+
+static os_bool_t test_close(const float* a, const float* b, os_size_t size)
+{
+    for (os_size_t i = 0; i < size; i++) {
+        if ((a[i] < b[i] - REL_ERROR) || (a[i] > b[i] + REL_ERROR)) {
+            return OS_FALSE;
+        }
+    }
+    return OS_TRUE;
+}
+
+/* As test_close(), the tolerance multiplied by scale */
+static os_bool_t test_close_scaled(const float* a,
+                                   const float* b,
+                                   os_size_t size,
+                                   float scale)
+{
+    float tol = (float)REL_ERROR * scale;
+    for (os_size_t i = 0; i < size; i++) {
+        if ((a[i] < b[i] - tol) || (a[i] > b[i] + tol)) {
+            return OS_FALSE;
+        }
+    }
+    return OS_TRUE;
+}
+
+static void test_mat_gemv(void)
+{
+    /* 6 frames = one full group of 4 plus 2, odd sizes hit every tail */
+    os_size_t rows = 37, cols = 301, batch = 6;
+
+    uai_mat_t* weight = uai_mat_create(rows, cols);
+    uai_mat_t* frames_r = uai_mat_create(batch, rows);
+    uai_mat_t* frames_c = uai_mat_create(batch, cols);
+    uai_mat_t* out_c = uai_mat_create(batch, cols);
+    uai_mat_t* out_r = uai_mat_create(batch, rows);
+    uai_mat_t* expect_c = uai_mat_create(batch, cols);
+    uai_mat_t* expect_r = uai_mat_create(batch, rows);
+    uai_mat_t* weight_t = uai_mat_create(cols, rows);
+
+    for (os_size_t i = 0; i < rows * cols; i++) {
+        weight->data[i] = (float)((i * 7) % 13) / 13.0f - 0.5f;
+    }
+    for (os_size_t i = 0; i < rows; i++) {
+        for (os_size_t j = 0; j < cols; j++) {
+            weight_t->data[j * rows + i] = weight->data[i * cols + j];
+        }
+    }
+    for (os_size_t i = 0; i < batch * rows; i++) {
+        frames_r->data[i] = (float)((i * 5) % 11) / 11.0f - 0.5f;
+    }
+    for (os_size_t i = 0; i < batch * cols; i++) {
+        frames_c->data[i] = (float)((i * 3) % 7) / 7.0f - 0.5f;
+    }
+
+    /* frame * W and frame * W^T, W^T stored explicitly for the reference */
+    for (os_size_t f = 0; f < batch; f++) {
+        dsp::dot_by_row(f, frames_r->data + f * rows, rows, weight, expect_c);
+        dsp::dot_by_row(
+            f, frames_c->data + f * cols, cols, weight_t, expect_r);
+    }
+
+    int ret = dsp::gemv(
+        weight, GEMM_TRANS, frames_r->data, out_c->data, OS_NULL);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(out_c->data, expect_c->data, cols));
+
+    ret = dsp::gemv(
+        weight, GEMM_TRANS_NONE, frames_c->data, out_r->data, OS_NULL);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(out_r->data, expect_r->data, rows));
+
+    ret = dsp::gemv_batch(weight, GEMM_TRANS, frames_r, out_c, OS_NULL);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(out_c->data, expect_c->data, batch * cols));
+
+    ret = dsp::gemv_batch(weight, GEMM_TRANS_NONE, frames_c, out_r, OS_NULL);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(out_r->data, expect_r->data, batch * rows));
+
+    /* A one row dot goes through the same kernels */
+    uai_mat_t frame = {
+        .rows = 1,
+        .cols = rows,
+        .data = frames_r->data,
+    };
+    uai_mat_t out = {
+        .rows = 1,
+        .cols = cols,
+        .data = out_c->data,
+    };
+    ret = dsp::dot(&frame, weight, &out);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(out_c->data, expect_c->data, cols));
+
+    uai_mat_destroy(weight);
+    uai_mat_destroy(weight_t);
+    uai_mat_destroy(frames_r);
+    uai_mat_destroy(frames_c);
+    uai_mat_destroy(out_c);
+    uai_mat_destroy(out_r);
+    uai_mat_destroy(expect_c);
+    uai_mat_destroy(expect_r);
+}
+
+static void test_mat_dot_trans(void)
+{
+    /* Odd sizes reach the edges of the 4x4 and the blocked transposes */
+    os_size_t m = 45, n = 67, k = 38;
+
+    uai_mat_t* a = uai_mat_create(m, n);
+    uai_mat_t* b = uai_mat_create(n, k);
+    uai_mat_t* a_t = uai_mat_create(n, m);
+    uai_mat_t* b_t = uai_mat_create(k, n);
+    uai_mat_t* out = uai_mat_create(m, k);
+    uai_mat_t* expect = uai_mat_create(m, k);
+
+    for (os_size_t i = 0; i < m * n; i++) {
+        a->data[i] = (float)((i * 7) % 13) / 13.0f - 0.5f;
+    }
+    for (os_size_t i = 0; i < n * k; i++) {
+        b->data[i] = (float)((i * 5) % 11) / 11.0f - 0.5f;
+    }
+
+    tp_assert_integer_equal(uai_mat_transpose(a_t, a), NUMDL_EOK);
+    tp_assert_integer_equal(uai_mat_transpose(b_t, b), NUMDL_EOK);
+
+    bool exact = true;
+    for (os_size_t i = 0; i < m; i++) {
+        for (os_size_t j = 0; j < n; j++) {
+            exact = exact && a_t->data[j * m + i] == a->data[i * n + j];
+        }
+    }
+    tp_assert_true(exact);
+    tp_assert_integer_equal(uai_mat_transpose(a, b), NUMDL_EINVAL);
+
+    for (os_size_t i = 0; i < m; i++) {
+        dsp::dot_by_row(i, a->data + i * n, n, b, expect);
+    }
+
+    int ret = dsp::dot(a, GEMM_TRANS_NONE, b, GEMM_TRANS_NONE, out);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(out->data, expect->data, m * k));
+
+    ret = dsp::dot(a_t, GEMM_TRANS, b, GEMM_TRANS_NONE, out);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(out->data, expect->data, m * k));
+
+    ret = dsp::dot(a, GEMM_TRANS_NONE, b_t, GEMM_TRANS, out);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(out->data, expect->data, m * k));
+
+    ret = dsp::dot(a_t, GEMM_TRANS, b_t, GEMM_TRANS, out);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(out->data, expect->data, m * k));
+
+    uai_mat_destroy(a);
+    uai_mat_destroy(b);
+    uai_mat_destroy(a_t);
+    uai_mat_destroy(b_t);
+    uai_mat_destroy(out);
+    uai_mat_destroy(expect);
+}
+
+static void test_mat_sparse(void)
+{
+    /* Sizes not divisible by the blocks leave padded edge blocks */
+    os_size_t rows = 37, cols = 53, n = 19;
+
+    uai_mat_t* a = uai_mat_create(rows, cols);
+    uai_mat_t* b = uai_mat_create(cols, n);
+    uai_mat_t* out = uai_mat_create(rows, n);
+    uai_mat_t* expect = uai_mat_create(rows, n);
+    float* x = b->data;
+    float y[37];
+    float expect_y[37];
+
+    /* About 80% zeros */
+    os_size_t nnz = 0;
+    for (os_size_t i = 0; i < rows * cols; i++) {
+        a->data[i] = (i * 7) % 5 ? 0.0f : (float)((i * 3) % 11) - 5.0f;
+        nnz += a->data[i] != 0.0f;
+    }
+    for (os_size_t i = 0; i < cols * n; i++) {
+        b->data[i] = (float)((i * 5) % 13) / 13.0f - 0.5f;
+    }
+
+    dsp::dot(a, b, expect);
+    for (os_size_t i = 0; i < rows; i++) {
+        expect_y[i] = 0.0f;
+        for (os_size_t j = 0; j < cols; j++) {
+            expect_y[i] += a->data[i * cols + j] * x[j];
+        }
+    }
+
+    uai_mat_csr_t* csr = uai_mat_csr_from_dense(a, 0.0f);
+    tp_assert_not_null(csr);
+    tp_assert_integer_equal(csr->nnz, nnz);
+
+    int ret = dsp::dot(csr, b, out);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(out->data, expect->data, rows * n));
+
+    ret = dsp::gemv(csr, x, y);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_true(test_close(y, expect_y, rows));
+    uai_mat_csr_destroy(csr);
+
+    /* 2x7 leaves a 4 column edge block, 53 = 7 * 7 + 4 */
+    os_size_t blocks[4][2] = {{1, 4}, {4, 4}, {4, 1}, {2, 7}};
+    for (os_size_t t = 0; t < 4; t++) {
+        uai_mat_bsr_t* bsr =
+            uai_mat_bsr_from_dense(a, blocks[t][0], blocks[t][1], 0.0f);
+        tp_assert_not_null(bsr);
+
+        ret = dsp::dot(bsr, b, out);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(test_close(out->data, expect->data, rows * n));
+
+        ret = dsp::gemv(bsr, x, y);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(test_close(y, expect_y, rows));
+        uai_mat_bsr_destroy(bsr);
+    }
+
+    /* A dense matrix keeps every block */
+    uai_mat_bsr_t* bsr = uai_mat_bsr_from_dense(b, 4, 4, -1.0f);
+    tp_assert_not_null(bsr);
+    tp_assert_integer_equal(bsr->nnzb, ((cols + 3) / 4) * ((n + 3) / 4));
+    uai_mat_bsr_destroy(bsr);
+
+    uai_mat_destroy(a);
+    uai_mat_destroy(b);
+    uai_mat_destroy(out);
+    uai_mat_destroy(expect);
+}
+
+static void test_qgemm(void)
+{
+    /* Odd sizes reach the 4 row groups, the SIMD body and the scalar tail */
+    const os_int32_t lhs_rows = 19, rhs_rows = 70, rhs_cols = 4133;
+    const os_int32_t lhs_offset = 37, dst_offset = -11;
+
+    os_int8_t* lhs = (os_int8_t*)os_malloc(lhs_rows * rhs_cols);
+    os_int8_t* rhs = (os_int8_t*)os_malloc(rhs_rows * rhs_cols);
+    os_int16_t* lhs16 = (os_int16_t*)os_malloc(lhs_rows * rhs_cols * 2);
+    os_int32_t* bias = (os_int32_t*)os_malloc(rhs_rows * 4);
+    os_int64_t* bias64 = (os_int64_t*)os_malloc(rhs_rows * 8);
+    os_int32_t* mults = (os_int32_t*)os_malloc(rhs_rows * 4);
+    os_int32_t* shifts = (os_int32_t*)os_malloc(rhs_rows * 4);
+    os_int8_t* dst = (os_int8_t*)os_malloc(lhs_rows * rhs_rows);
+    os_int16_t* dst16 = (os_int16_t*)os_malloc(lhs_rows * rhs_rows * 2);
+
+    for (os_int32_t i = 0; i < lhs_rows * rhs_cols; i++) {
+        lhs[i] = (os_int8_t)((i * 37) % 256 - 128);
+        lhs16[i] = (os_int16_t)((i * 7919) % 65536 - 32768);
+    }
+    for (os_int32_t i = 0; i < rhs_rows * rhs_cols; i++) {
+        rhs[i] = (os_int8_t)((i * 101) % 256 - 128);
+    }
+    for (os_int32_t i = 0; i < rhs_rows; i++) {
+        bias[i] = (i * 4099) % 20000 - 10000;
+        bias64[i] = (os_int64_t)bias[i] * 1000;
+        qgemm::quantize_multiplier(
+            0.00001 * (1 + i % 5), &mults[i], &shifts[i]);
+    }
+
+    /* Rounding corner cases of the CMSIS-NN requantisation */
+    tp_assert_integer_equal(qgemm::requantize(100, 1 << 30, 0), 50);
+    tp_assert_integer_equal(qgemm::requantize(3, 1 << 30, -1), 1);
+    tp_assert_integer_equal(qgemm::requantize(-3, 1 << 30, 0), -1);
+    tp_assert_integer_equal(qgemm::reduce_multiplier(1 << 30), 16384);
+    os_int32_t mult, shift;
+    qgemm::quantize_multiplier(0.25, &mult, &shift);
+    tp_assert_integer_equal(mult, 1 << 30);
+    tp_assert_integer_equal(shift, -1);
+
+    int ret = qgemm::mat_mult_nt_t_s8(lhs,
+                                      rhs,
+                                      bias,
+                                      dst,
+                                      mults,
+                                      shifts,
+                                      lhs_rows,
+                                      rhs_rows,
+                                      rhs_cols,
+                                      lhs_offset,
+                                      dst_offset,
+                                      -100,
+                                      120);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+
+    bool exact = true;
+    for (os_int32_t r = 0; r < lhs_rows; r++) {
+        for (os_int32_t c = 0; c < rhs_rows; c++) {
+            os_int32_t acc = bias[c];
+            for (os_int32_t i = 0; i < rhs_cols; i++) {
+                acc += (lhs[r * rhs_cols + i] + lhs_offset) *
+                       rhs[c * rhs_cols + i];
+            }
+            acc = qgemm::requantize(acc, mults[c], shifts[c]) + dst_offset;
+            acc = acc < -100 ? -100 : (acc > 120 ? 120 : acc);
+            exact = exact && dst[r * rhs_rows + c] == acc;
+        }
+    }
+    tp_assert_true(exact);
+
+    ret = qgemm::vec_mat_mult_t_s8(lhs,
+                                   rhs,
+                                   bias,
+                                   dst,
+                                   lhs_offset,
+                                   0,
+                                   dst_offset,
+                                   mults[1],
+                                   shifts[1],
+                                   rhs_cols,
+                                   rhs_rows,
+                                   -128,
+                                   127);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+
+    exact = true;
+    for (os_int32_t c = 0; c < rhs_rows; c++) {
+        os_int32_t acc = bias[c];
+        for (os_int32_t i = 0; i < rhs_cols; i++) {
+            acc += (lhs[i] + lhs_offset) * rhs[c * rhs_cols + i];
+        }
+        acc = qgemm::requantize(acc, mults[1], shifts[1]) + dst_offset;
+        acc = acc < -128 ? -128 : (acc > 127 ? 127 : acc);
+        exact = exact && dst[c] == acc;
+    }
+    tp_assert_true(exact);
+
+    qgemm::quantize_multiplier(0.0005, &mult, &shift);
+    mult = qgemm::reduce_multiplier(mult);
+    ret = qgemm::mat_mult_nt_t_s16(lhs16,
+                                   rhs,
+                                   bias64,
+                                   dst16,
+                                   mult,
+                                   shift,
+                                   lhs_rows,
+                                   rhs_rows,
+                                   rhs_cols,
+                                   -32768,
+                                   32767);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+
+    exact = true;
+    for (os_int32_t r = 0; r < lhs_rows; r++) {
+        for (os_int32_t c = 0; c < rhs_rows; c++) {
+            os_int64_t acc = bias64[c];
+            for (os_int32_t i = 0; i < rhs_cols; i++) {
+                acc += (os_int64_t)lhs16[r * rhs_cols + i] *
+                       rhs[c * rhs_cols + i];
+            }
+            os_int32_t out = qgemm::requantize_s64(acc, mult, shift);
+            out = out < -32768 ? -32768 : (out > 32767 ? 32767 : out);
+            exact = exact && dst16[r * rhs_rows + c] == out;
+        }
+    }
+    tp_assert_true(exact);
+
+    os_free(lhs);
+    os_free(rhs);
+    os_free(lhs16);
+    os_free(bias);
+    os_free(bias64);
+    os_free(mults);
+    os_free(shifts);
+    os_free(dst);
+    os_free(dst16);
+}
+
+static void test_fft_plan(void)
+{
+    /* 400 has a radix 5 stage, 45 is odd and runs as a complex FFT */
+    const os_size_t sizes[] = {64, 400, 45};
+    float src[400];
+    kiss_fft_cpx out[201];
+    kiss_fft_cpx expect[201];
+
+    for (os_size_t i = 0; i < 400; i++) {
+        src[i] = (float)((i * 7) % 19) / 19.0f - 0.5f;
+    }
+
+    for (os_size_t s = 0; s < 3; s++) {
+        os_size_t nfft = sizes[s];
+        os_size_t bins = nfft / 2 + 1;
+
+        fft_plan_t* plan = fft::plan_get(nfft);
+        tp_assert_true(plan != OS_NULL);
+        tp_assert_integer_equal(fft::plan_nfft(plan), nfft);
+        tp_assert_integer_equal(fft::rfft(plan, src, out), NUMDL_EOK);
+        fft::plan_put(plan);
+
+        if (nfft % 2 == 0) {
+            /* Same steps as kiss_fftr, FMA contraction may round apart */
+            kiss_fftr_cfg cfg = kiss_fftr_alloc(nfft, 0, OS_NULL, OS_NULL);
+            kiss_fftr(cfg, src, expect);
+            kiss_fftr_free(cfg);
+            tp_assert_true(
+                test_close((float*)out, (float*)expect, 2 * bins));
+        } else {
+            for (os_size_t k = 0; k < bins; k++) {
+                double re = 0, im = 0;
+                for (os_size_t i = 0; i < nfft; i++) {
+                    double phase = -2 * M_PI * (double)(i * k) / nfft;
+                    re += src[i] * cos(phase);
+                    im += src[i] * sin(phase);
+                }
+                expect[k].r = (float)re;
+                expect[k].i = (float)im;
+            }
+            tp_assert_true(test_close(
+                (const float*)out, (const float*)expect, 2 * bins));
+        }
+    }
+
+    /* Idle plans are reused */
+    fft_plan_t* a = fft::plan_get(64);
+    fft::plan_put(a);
+    fft_plan_t* b = fft::plan_get(64);
+    tp_assert_true(a == b);
+
+    /* With room for one plan a second size in use is private */
+    tp_assert_integer_equal(fft::cache_limit(1, NUMDL_FFT_CACHE_BYTES),
+                            NUMDL_EOK);
+    fft_plan_t* c = fft::plan_get(128);
+    tp_assert_true(c != OS_NULL);
+    fft::plan_put(c);
+    fft::plan_put(b);
+
+    /* Once idle, 64 is evicted to make room for 128 */
+    c = fft::plan_get(128);
+    b = fft::plan_get(128);
+    tp_assert_true(c == b);
+    fft::plan_put(b);
+    fft::plan_put(c);
+
+    fft::cache_clear();
+    fft::cache_limit(NUMDL_FFT_CACHE_PLANS, NUMDL_FFT_CACHE_BYTES);
+}
+
+static void test_rfft_scratch(void)
+{
+    /* Padded, cropped and odd lengths */
+    const os_size_t fft_lens[] = {512, 256, 405};
+    float src[480];
+    float out[257];
+    float expect[257];
+
+    for (os_size_t i = 0; i < 480; i++) {
+        src[i] = (float)((i * 11) % 23) / 23.0f - 0.5f;
+    }
+
+    for (os_size_t s = 0; s < 3; s++) {
+        os_size_t fft_len = fft_lens[s];
+        os_size_t out_len = fft_len / 2 + 1;
+
+        int ret = dsp::rfft(src, 480, expect, out_len, fft_len);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+
+        fft_plan_t* plan = fft::plan_create(fft_len);
+        void* scratch = uai_mat_aligned_alloc(dsp::rfft_scratch_size(plan));
+        ret = dsp::rfft(plan, src, 480, out, out_len, scratch);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(0 == memcmp(out, expect, out_len * sizeof(float)));
+
+        ret = dsp::rfft(plan, src, 480, out, out_len + 1, scratch);
+        tp_assert_integer_equal(ret, NUMDL_EINVAL);
+
+        uai_mat_aligned_free(scratch);
+        fft::plan_destroy(plan);
+    }
+}
+
+static void test_rfft_batch(void)
+{
+    /* 9 frames = two groups of 4 plus one, 400 has a radix 5 stage */
+    const os_size_t sizes[] = {256, 400, 45};
+    os_size_t frames = 9, lds = 411, ldo = 203;
+
+    float* src = (float*)os_calloc(1, frames * lds * sizeof(float));
+    kiss_fft_cpx* out =
+        (kiss_fft_cpx*)os_calloc(1, frames * ldo * sizeof(kiss_fft_cpx));
+    kiss_fft_cpx expect[201];
+
+    for (os_size_t i = 0; i < frames * lds; i++) {
+        src[i] = (float)((i * 13) % 29) / 29.0f - 0.5f;
+    }
+
+    for (os_size_t s = 0; s < 3; s++) {
+        os_size_t nfft = sizes[s];
+        os_size_t bins = nfft / 2 + 1;
+
+        fft_plan_t* plan = fft::plan_create(nfft);
+        void* scratch =
+            uai_mat_aligned_alloc(fft::rfft_batch_scratch_size(plan));
+
+        int ret = fft::rfft_batch(plan, src, lds, frames, out, ldo, scratch);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+
+        bool close = true;
+        for (os_size_t f = 0; f < frames; f++) {
+            fft::rfft(plan, src + f * lds, expect);
+            close = close && test_close((const float*)(out + f * ldo),
+                                        (const float*)expect,
+                                        2 * bins);
+        }
+        tp_assert_true(close);
+
+        uai_mat_aligned_free(scratch);
+        fft::plan_destroy(plan);
+    }
+
+    os_free(src);
+    os_free(out);
+}
+
+static void test_rfft_rows(void)
+{
+    /* 133 rows are enough to go parallel and leave a partial group */
+    const os_size_t fft_lens[] = {512, 256, 405};
+    os_size_t rows = 133, cols = 300;
+
+    uai_mat_t* src = uai_mat_create(rows, cols);
+    uai_mat_t* out = uai_mat_create(rows, 257);
+    float expect[257];
+
+    for (os_size_t i = 0; i < rows * cols; i++) {
+        src->data[i] = (float)((i * 17) % 31) / 31.0f - 0.5f;
+    }
+
+    for (os_size_t threads = 1; threads <= 4; threads += 3) {
+        dsp::set_num_threads(threads);
+
+        for (os_size_t s = 0; s < 3; s++) {
+            os_size_t fft_len = fft_lens[s];
+            os_size_t bins = fft_len / 2 + 1;
+
+            out->cols = bins;
+            int ret = dsp::rfft(src, out, fft_len);
+            tp_assert_integer_equal(ret, NUMDL_EOK);
+
+            bool close = true;
+            for (os_size_t r = 0; r < rows; r++) {
+                dsp::rfft(src->data + r * cols, cols, expect, bins, fft_len);
+                close = close && test_close(out->data + r * bins, expect, bins);
+            }
+            tp_assert_true(close);
+        }
+    }
+    dsp::set_num_threads(1);
+
+    out->cols = 100;
+    tp_assert_integer_equal(dsp::rfft(src, out, 512), NUMDL_EINVAL);
+
+    uai_mat_destroy(src);
+    uai_mat_destroy(out);
+}
+
+static void test_rfft_modes(void)
+{
+    /* 201 bins leave a tail after the 4 wide loop, the last frame is zero */
+    os_size_t rows = 3, fft_len = 400, bins = 201;
+    float floor = 1.0e-6f;
+
+    uai_mat_t* src = uai_mat_create(rows, fft_len);
+    uai_mat_t* cpx = uai_mat_create(rows, 2 * bins);
+    uai_mat_t* out = uai_mat_create(rows, bins);
+    float expect[3 * 201];
+
+    for (os_size_t i = 0; i < (rows - 1) * fft_len; i++) {
+        src->data[i] = (float)((i * 19) % 37) / 37.0f - 0.5f;
+    }
+    for (os_size_t i = (rows - 1) * fft_len; i < rows * fft_len; i++) {
+        src->data[i] = 0.0f;
+    }
+
+    int ret = dsp::rfft(src, cpx, fft_len, RFFT_OUT_COMPLEX, 0.0f);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+
+    kiss_fft_cpx ref[201];
+    fft_plan_t* plan = fft::plan_create(fft_len);
+    fft::rfft(plan, src->data, ref);
+    fft::plan_destroy(plan);
+    tp_assert_true(test_close(cpx->data, (const float*)ref, 2 * bins));
+
+    const rfft_out_t modes[] = {
+        RFFT_OUT_MAGNITUDE, RFFT_OUT_POWER, RFFT_OUT_LOG_POWER};
+    for (os_size_t m = 0; m < 3; m++) {
+        for (os_size_t i = 0; i < rows * bins; i++) {
+            double re = cpx->data[2 * i];
+            double im = cpx->data[2 * i + 1];
+            double p = re * re + im * im;
+            if (RFFT_OUT_MAGNITUDE == modes[m]) {
+                expect[i] = (float)sqrt(p);
+            } else if (RFFT_OUT_POWER == modes[m]) {
+                expect[i] = (float)p;
+            } else {
+                expect[i] = (float)log(p < floor ? floor : p);
+            }
+        }
+
+        ret = dsp::rfft(src, out, fft_len, modes[m], floor);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(test_close(out->data, expect, rows * bins));
+
+        ret = dsp::rfft(src->data,
+                        fft_len,
+                        out->data,
+                        bins,
+                        fft_len,
+                        modes[m],
+                        floor);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(test_close(out->data, expect, bins));
+    }
+
+    /* Complex output needs twice the columns */
+    ret = dsp::rfft(src, out, fft_len, RFFT_OUT_COMPLEX, 0.0f);
+    tp_assert_integer_equal(ret, NUMDL_EINVAL);
+
+    uai_mat_destroy(src);
+    uai_mat_destroy(cpx);
+    uai_mat_destroy(out);
+}
+
+static void test_irfft_ola(void)
+{
+    const os_size_t sizes[] = {64, 400, 45};
+    float src[400];
+    float back[400];
+    float expect[400];
+    kiss_fft_cpx bins[201];
+    kiss_fft_cpx scratch[2 * 400];
+
+    for (os_size_t i = 0; i < 400; i++) {
+        src[i] = (float)((i * 23) % 41) / 41.0f - 0.5f;
+    }
+
+    for (os_size_t s = 0; s < 3; s++) {
+        os_size_t nfft = sizes[s];
+        fft_plan_t* plan = fft::plan_create(nfft);
+        tp_assert_true(fft::irfft_scratch_size(plan) <= sizeof(scratch));
+
+        fft::rfft(plan, src, bins);
+        int ret = fft::irfft(plan, bins, back, scratch);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(test_close(back, src, nfft));
+
+        if (nfft % 2 == 0) {
+            kiss_fftr_cfg cfg = kiss_fftr_alloc(nfft, 1, OS_NULL, OS_NULL);
+            kiss_fftri(cfg, bins, expect);
+            kiss_fftr_free(cfg);
+            for (os_size_t i = 0; i < nfft; i++) {
+                expect[i] /= nfft;
+            }
+            tp_assert_true(test_close(back, expect, nfft));
+        }
+
+        fft::plan_destroy(plan);
+    }
+
+    /* sqrt periodic Hann at both ends with 50% overlap adds up to one */
+    os_size_t nfft = 64, hop = 32, frames = 12;
+    float window[64];
+    float signal[12 * 32 + 64];
+    float synth[12 * 32];
+    float frame[64];
+
+    for (os_size_t i = 0; i < nfft; i++) {
+        window[i] = sqrtf(0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / nfft));
+    }
+    for (os_size_t i = 0; i < frames * hop + nfft; i++) {
+        signal[i] = (float)((i * 7) % 17) / 17.0f - 0.5f;
+    }
+
+    fft_ola_t* ola = fft::ola_create(nfft, hop, window);
+    tp_assert_true(ola != OS_NULL);
+    fft_plan_t* plan = fft::plan_get(nfft);
+
+    for (os_size_t m = 0; m < frames; m++) {
+        for (os_size_t i = 0; i < nfft; i++) {
+            frame[i] = signal[m * hop + i] * window[i];
+        }
+        fft::rfft(plan, frame, bins);
+        int ret = fft::ola_synth(ola, bins, synth + m * hop);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+    }
+
+    /* Only the first hop misses the overlap of an earlier frame */
+    tp_assert_true(
+        test_close(synth + hop, signal + hop, (frames - 1) * hop));
+
+    fft::plan_put(plan);
+    fft::ola_destroy(ola);
+    tp_assert_true(OS_NULL == fft::ola_create(64, 65, OS_NULL));
+}
+
+template <os_size_t N>
+static os_bool_t test_nd_rfft_size(void)
+{
+    float src[N];
+    float out[N + 2];
+    kiss_fft_cpx expect[N / 2 + 1];
+
+    for (os_size_t i = 0; i < N; i++) {
+        src[i] = (float)((i * 29) % 43) / 43.0f - 0.5f;
+    }
+
+    nd::fft::rfft<N>(src, out);
+
+    fft_plan_t* plan = fft::plan_create(N);
+    fft::rfft(plan, src, expect);
+    fft::plan_destroy(plan);
+
+    return test_close(out, (const float*)expect, N + 2);
+}
+
+static void test_fft_backend(void)
+{
+    fft_backend_t saved = fft::get_backend();
+    tp_assert_integer_equal(fft::set_backend((fft_backend_t)7), NUMDL_EINVAL);
+    tp_assert_integer_equal(fft::set_backend(FFT_BACKEND_KISSFFT), NUMDL_EOK);
+    tp_assert_integer_equal(fft::get_backend(), FFT_BACKEND_KISSFFT);
+
+    fft_plan_t* plan = fft::plan_get(512);
+    tp_assert_integer_equal(fft::plan_backend(plan), FFT_BACKEND_KISSFFT);
+    fft::plan_put(plan);
+
+    /* kissfft takes every size, CMSIS only powers of two up to 4096 */
+    tp_assert_true(fft::backend_supports(FFT_BACKEND_KISSFFT, 400));
+    tp_assert_true(!fft::backend_supports(FFT_BACKEND_CMSIS, 400));
+    tp_assert_true(!fft::backend_supports(FFT_BACKEND_CMSIS, 8192));
+    tp_assert_true(OS_NULL == fft::plan_create(400, FFT_BACKEND_CMSIS));
+
+    plan = fft::plan_create(400, FFT_BACKEND_AUTO);
+    tp_assert_integer_equal(fft::plan_backend(plan), FFT_BACKEND_KISSFFT);
+    fft::plan_destroy(plan);
+
+#ifdef UAI_CMSIS_DSP_USING_TRANSFORM
+    const os_size_t sizes[] = {64, 512};
+    float src[512];
+    float back[512];
+    kiss_fft_cpx expect[257];
+    kiss_fft_cpx bins[257];
+    float scratch[2 * 512];
+
+    for (os_size_t i = 0; i < 512; i++) {
+        src[i] = (float)((i * 29) % 43) / 43.0f - 0.5f;
+    }
+
+    tp_assert_integer_equal(fft::set_backend(FFT_BACKEND_CMSIS), NUMDL_EOK);
+
+    for (os_size_t s = 0; s < 2; s++) {
+        os_size_t nfft = sizes[s];
+        fft_plan_t* kiss = fft::plan_create(nfft, FFT_BACKEND_KISSFFT);
+        fft_plan_t* cmsis = fft::plan_get(nfft);
+        tp_assert_integer_equal(fft::plan_backend(cmsis), FFT_BACKEND_CMSIS);
+        tp_assert_true(fft::rfft_scratch_size(cmsis) <= sizeof(scratch));
+
+        fft::rfft(kiss, src, expect);
+        int ret = fft::rfft(cmsis, src, bins, scratch);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(test_close((const float*)bins,
+                                  (const float*)expect,
+                                  nfft + 2));
+
+        ret = fft::irfft(cmsis, bins, back, scratch);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(test_close(back, src, nfft));
+
+        fft::plan_put(cmsis);
+        fft::plan_destroy(kiss);
+    }
+#else
+    tp_assert_integer_equal(fft::set_backend(FFT_BACKEND_CMSIS), NUMDL_EINVAL);
+#endif
+
+    fft::set_backend(saved);
+}
+
+static void test_rfft_q31(void)
+{
+    os_size_t nfft = 512;
+    os_int16_t src[400];
+    float fsrc[512] = {0};
+    kiss_fft_cpx expect[257];
+    float expect_power[257];
+    float got[2 * 257];
+    float got_power[257];
+    os_int32_t bins[2 * 257];
+    os_int32_t power[257];
+    os_int32_t scratch[2 * 512 + 2];
+    int shift = -1;
+
+    /* Peak of 1000 leaves 5 bits of headroom, 400 samples get padded */
+    for (os_size_t i = 0; i < 400; i++) {
+        float v = 700.0f * sinf(0.3f * i) + (float)((i * 37) % 601) - 300.0f;
+        src[i] = (os_int16_t)v;
+        fsrc[i] = src[i];
+    }
+    src[17] = -1000;
+    fsrc[17] = -1000.0f;
+
+    fft_q31_plan_t* plan = fft::q31_plan_create(nfft);
+    tp_assert_true(plan != OS_NULL);
+    tp_assert_true(fft::rfft_q31_scratch_size(plan) <= sizeof(scratch));
+    tp_assert_true(OS_NULL == fft::q31_plan_create(45));
+
+    fft_plan_t* fplan = fft::plan_create(nfft, FFT_BACKEND_KISSFFT);
+    fft::rfft(fplan, fsrc, expect);
+    fft::plan_destroy(fplan);
+
+    int ret = fft::rfft_q31(plan, src, 400, bins, &shift, scratch);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_integer_equal(shift, 5);
+
+    /* Both sides as X[k] / (nfft * 32768) * 2^shift */
+    float scale = (float)(1 << shift) / (nfft * 32768.0f);
+    for (os_size_t k = 0; k <= nfft / 2; k++) {
+        got[2 * k] = bins[2 * k] / 1073741824.0f;
+        got[2 * k + 1] = bins[2 * k + 1] / 1073741824.0f;
+        expect[k].r *= scale;
+        expect[k].i *= scale;
+        expect_power[k] = expect[k].r * expect[k].r + expect[k].i * expect[k].i;
+    }
+    tp_assert_true(test_close(got, (const float*)expect, nfft + 2));
+
+    ret = fft::power_q31(plan, src, 400, power, &shift, scratch);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+    tp_assert_integer_equal(shift, 5);
+    for (os_size_t k = 0; k <= nfft / 2; k++) {
+        got_power[k] = power[k] / 2147483648.0f;
+    }
+    tp_assert_true(test_close(got_power, expect_power, nfft / 2 + 1));
+
+    fft::q31_plan_destroy(plan);
+}
+
+static void test_rfft_four_step(void)
+{
+    /* At the default threshold 2^20 splits 512 x 1024, 3 * 2^19 splits
+     * 768 x 1024 */
+    const os_size_t sizes[] = {NUMDL_FFT_FOUR_STEP_MIN,
+                               NUMDL_FFT_FOUR_STEP_MIN / 2 * 3};
+    os_size_t max = sizes[1];
+
+    float* src = (float*)uai_mat_aligned_alloc(max * sizeof(float));
+    float* back = (float*)uai_mat_aligned_alloc(max * sizeof(float));
+    kiss_fft_cpx* out = (kiss_fft_cpx*)uai_mat_aligned_alloc(
+        (max / 2 + 1) * sizeof(kiss_fft_cpx));
+    kiss_fft_cpx* expect = (kiss_fft_cpx*)uai_mat_aligned_alloc(
+        (max / 2 + 1) * sizeof(kiss_fft_cpx));
+    void* scratch = uai_mat_aligned_alloc(3 * max * sizeof(kiss_fft_cpx));
+    tp_assert_true(src != OS_NULL && back != OS_NULL && out != OS_NULL &&
+                   expect != OS_NULL && scratch != OS_NULL);
+
+    for (os_size_t i = 0; i < max; i++) {
+        src[i] = (float)((i * 31) % 97) / 97.0f - 0.5f;
+    }
+
+    dsp::set_num_threads(4);
+
+    for (os_size_t s = 0; s < 2; s++) {
+        os_size_t nfft = sizes[s];
+        fft_plan_t* plan = fft::plan_create(nfft, FFT_BACKEND_KISSFFT);
+        tp_assert_true(plan != OS_NULL);
+        tp_assert_true(fft::rfft_scratch_size(plan) > 0);
+        tp_assert_true(fft::irfft_scratch_size(plan) <=
+                       3 * max * sizeof(kiss_fft_cpx));
+
+        int ret = fft::rfft(plan, src, out, scratch);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+
+        kiss_fftr_cfg cfg = kiss_fftr_alloc(nfft, 0, OS_NULL, OS_NULL);
+        kiss_fftr(cfg, src, expect);
+        kiss_fftr_free(cfg);
+
+        /* Bins reach a few thousand, compare relative to the largest */
+        float err = 0.0f;
+        float peak = 0.0f;
+        for (os_size_t k = 0; k <= nfft / 2; k++) {
+            float d = fabsf(out[k].r - expect[k].r) +
+                      fabsf(out[k].i - expect[k].i);
+            float m = fabsf(expect[k].r) + fabsf(expect[k].i);
+            err = d > err ? d : err;
+            peak = m > peak ? m : peak;
+        }
+        tp_assert_true(err < 1.0e-5f * peak);
+
+        ret = fft::irfft(plan, out, back, scratch);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(test_close(back, src, nfft));
+
+        fft::plan_destroy(plan);
+    }
+
+    dsp::set_num_threads(1);
+
+    uai_mat_aligned_free(scratch);
+    uai_mat_aligned_free(expect);
+    uai_mat_aligned_free(out);
+    uai_mat_aligned_free(back);
+    uai_mat_aligned_free(src);
+}
+
+static void test_nd_rfft(void)
+{
+    /* Odd and even numbers of radix-4 stages, with and without SSE loops */
+    tp_assert_true(test_nd_rfft_size<8>());
+    tp_assert_true(test_nd_rfft_size<16>());
+    tp_assert_true(test_nd_rfft_size<64>());
+    tp_assert_true(test_nd_rfft_size<512>());
+    tp_assert_true(test_nd_rfft_size<1024>());
+}
+
+static void test_mat_dot_view(void)
+{
+    /* Columns 1..3 of the transposed 4x5 matrix times a sub block */
+    float mat1_data[4 * 5];
+    float mat2_data[6 * 6];
+    for (os_size_t i = 0; i < OS_ARRAY_SIZE(mat1_data); i++) {
+        mat1_data[i] = (float)i * 0.5f - 3.0f;
+    }
+    for (os_size_t i = 0; i < OS_ARRAY_SIZE(mat2_data); i++) {
+        mat2_data[i] = (float)((i * 7) % 11) - 5.0f;
+    }
+
+    uai_mat_view_t mat1;
+    uai_mat_view_t mat2;
+    uai_mat_view_strided(&mat1, mat1_data, 4, 5, 5, 1);
+    uai_mat_view_transpose(&mat1, &mat1);
+    uai_mat_view_block(&mat1, &mat1, 1, 0, 3, 4);
+    uai_mat_view_strided(&mat2, mat2_data, 6, 6, 6, 1);
+    uai_mat_view_block(&mat2, &mat2, 2, 1, 4, 3);
+
+    float out_data[3 * 3];
+    uai_mat_view_t output;
+    uai_mat_view_strided(&output, out_data, 3, 3, 3, 1);
+
+    int ret = dsp::dot(&mat1, &mat2, &output);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+
+    os_bool_t dot_check = OS_TRUE;
+    for (os_size_t i = 0; i < 3; i++) {
+        for (os_size_t j = 0; j < 3; j++) {
+            float expect = 0.0f;
+            for (os_size_t p = 0; p < 4; p++) {
+                expect += mat1_data[p * 5 + (i + 1)] *
+                          mat2_data[(p + 2) * 6 + (j + 1)];
+            }
+            if ((out_data[i * 3 + j] < expect - REL_ERROR) ||
+                (out_data[i * 3 + j] > expect + REL_ERROR)) {
+                dot_check = OS_FALSE;
+            }
+        }
+    }
+    tp_assert_true(dot_check);
+}
+
+static void test_log_view_function(void)
+{
+    /* Log of every other element in a 2x3 window of a 3x6 buffer */
+    float data[3 * 6];
+    for (os_size_t i = 0; i < OS_ARRAY_SIZE(data); i++) {
+        data[i] = (float)(i + 1);
+    }
+
+    uai_mat_view_t view;
+    uai_mat_view_strided(&view, data + 6, 2, 3, 6, 2);
+
+    int ret = dsp::log(&view);
+    tp_assert_integer_equal(ret, NUMDL_EOK);
+
+    os_bool_t log_check = OS_TRUE;
+    for (os_size_t i = 0; i < OS_ARRAY_SIZE(data); i++) {
+        float expect = (float)(i + 1);
+        if (i >= 6 && i % 2 == 0) {
+            expect = logf(expect);
+        }
+        if ((data[i] < expect - REL_ERROR) || (data[i] > expect + REL_ERROR)) {
+            log_check = OS_FALSE;
+        }
+    }
+    tp_assert_true(log_check);
+}
+
+static void test_dct2_plan(void)
+{
+    const os_size_t sizes[] = {8, 13, 40};
+    float src[40];
+    float out[40];
+    float expect[40];
+    float strided[2 * 40];
+    float scratch[256];
+
+    for (os_size_t i = 0; i < 40; i++) {
+        src[i] = (float)((i * 11) % 23) / 23.0f - 0.5f;
+    }
+
+    for (os_size_t s = 0; s < 3; s++) {
+        os_size_t n = sizes[s];
+
+        for (int norm = DCT_NORMAL_NONE; norm <= DCT_NORMAL_ORTHO; norm++) {
+            /* Every coefficient, the upper half included, as scipy */
+            for (os_size_t k = 0; k < n; k++) {
+                double sum = 0.0;
+                for (os_size_t i = 0; i < n; i++) {
+                    sum += src[i] * cos(M_PI * k * (2 * i + 1) / (2.0 * n));
+                }
+                sum *= 2.0;
+                if (DCT_NORMAL_ORTHO == norm) {
+                    sum *= sqrt(1.0 / ((0 == k ? 4.0 : 2.0) * n));
+                }
+                expect[k] = (float)sum;
+            }
+
+            dct_plan_t* plan = dct::plan_create(n, (dct_norm_t)norm);
+            tp_assert_true(plan != OS_NULL);
+            tp_assert_integer_equal(dct::plan_size(plan), n);
+            tp_assert_true(dct::dct2_scratch_size(plan) <= sizeof(scratch));
+
+            int ret = dct::dct2(plan, src, out, scratch);
+            tp_assert_integer_equal(ret, NUMDL_EOK);
+            tp_assert_true(test_close(out, expect, n));
+
+            /* In place on every other float */
+            for (os_size_t i = 0; i < n; i++) {
+                strided[2 * i] = src[i];
+                strided[2 * i + 1] = 7.0f;
+            }
+            ret = dct::dct2(plan, strided, 2, strided, 2, scratch);
+            tp_assert_integer_equal(ret, NUMDL_EOK);
+            for (os_size_t i = 0; i < n; i++) {
+                out[i] = strided[2 * i];
+                tp_assert_true(7.0f == strided[2 * i + 1]);
+            }
+            tp_assert_true(test_close(out, expect, n));
+
+            dct::plan_destroy(plan);
+        }
+    }
+
+    tp_assert_true(OS_NULL == dct::plan_create(0, DCT_NORMAL_NONE));
+}
+
+static void test_dct2_truncated(void)
+{
+    const os_size_t sizes[][2] = {{40, 13}, {64, 40}, {23, 23}, {1, 1}};
+    const dct_method_t methods[] = {DCT_METHOD_FFT, DCT_METHOD_DIRECT};
+    const os_size_t rows = 3;
+    float src[3 * 64];
+    float out[3 * 64];
+    float expect[3 * 64];
+    float scratch[512];
+
+    for (os_size_t i = 0; i < rows * 64; i++) {
+        src[i] = (float)((i * 7) % 19) / 19.0f - 0.5f;
+    }
+
+    for (os_size_t s = 0; s < 4; s++) {
+        os_size_t n = sizes[s][0];
+        os_size_t k = sizes[s][1];
+
+        for (os_size_t r = 0; r < rows; r++) {
+            for (os_size_t j = 0; j < k; j++) {
+                double sum = 0.0;
+                for (os_size_t i = 0; i < n; i++) {
+                    sum += src[r * n + i] *
+                           cos(M_PI * j * (2 * i + 1) / (2.0 * n));
+                }
+                expect[r * k + j] =
+                    (float)(2.0 * sum * sqrt(1.0 / ((0 == j ? 4.0 : 2.0) * n)));
+            }
+        }
+
+        for (os_size_t m = 0; m < 2; m++) {
+            dct_plan_t* plan =
+                dct::plan_create(n, k, DCT_NORMAL_ORTHO, methods[m]);
+            tp_assert_true(plan != OS_NULL);
+            tp_assert_integer_equal(dct::plan_outputs(plan), k);
+            tp_assert_integer_equal(dct::plan_method(plan), methods[m]);
+            tp_assert_true(dct::dct2_scratch_size(plan) <= sizeof(scratch));
+
+            /* Nothing past k is written */
+            for (os_size_t i = 0; i < rows * 64; i++) {
+                out[i] = 7.0f;
+            }
+            int ret = dct::dct2(plan, src, out, scratch);
+            tp_assert_integer_equal(ret, NUMDL_EOK);
+            tp_assert_true(test_close(out, expect, k));
+            tp_assert_true(7.0f == out[k]);
+
+            void* rows_scratch =
+                uai_mat_aligned_alloc(dct::dct2_rows_scratch_size(plan));
+            tp_assert_true(rows_scratch != OS_NULL);
+            ret = dct::dct2_rows(
+                plan, rows, src, n, 1, out, k, 1, rows_scratch);
+            tp_assert_integer_equal(ret, NUMDL_EOK);
+            tp_assert_true(test_close(out, expect, rows * k));
+            uai_mat_aligned_free(rows_scratch);
+
+            dct::plan_destroy(plan);
+        }
+
+        /* Matrix to matrix */
+        uai_mat_t* mat = uai_mat_create(rows, n);
+        uai_mat_t* coef = uai_mat_create(rows, k);
+        memcpy(mat->data, src, rows * n * sizeof(float));
+        int ret = dsp::dct2(mat, coef, DCT_NORMAL_ORTHO);
+        tp_assert_integer_equal(ret, NUMDL_EOK);
+        tp_assert_true(test_close(coef->data, expect, rows * k));
+        uai_mat_destroy(coef);
+        uai_mat_destroy(mat);
+    }
+
+    dct_plan_t* plan =
+        dct::plan_create(512, 13, DCT_NORMAL_NONE, DCT_METHOD_AUTO);
+    tp_assert_integer_equal(dct::plan_method(plan), DCT_METHOD_DIRECT);
+    dct::plan_destroy(plan);
+    plan = dct::plan_create(512, 512, DCT_NORMAL_NONE, DCT_METHOD_AUTO);
+    tp_assert_integer_equal(dct::plan_method(plan), DCT_METHOD_FFT);
+    dct::plan_destroy(plan);
+
+    tp_assert_true(OS_NULL == dct::plan_create(8, 9, DCT_NORMAL_NONE,
+                                               DCT_METHOD_AUTO));
+}
+
+static void test_dct2_rows_parallel(void)
+{
+    /* Not a multiple of the row group, large enough to be split */
+    const os_size_t rows = 1003;
+    const os_size_t n = 64;
+    float row[64];
+    float expect[64];
+    float scratch[512];
+
+    uai_mat_t* mat = uai_mat_create(rows, n);
+    uai_mat_t* ref = uai_mat_create(rows, n);
+    uai_mat_t* coef = uai_mat_create(rows, 13);
+    for (os_size_t i = 0; i < rows * n; i++) {
+        mat->data[i] = (float)((i * 13) % 29) / 29.0f - 0.5f;
+    }
+    memcpy(ref->data, mat->data, rows * n * sizeof(float));
+
+    dsp::set_num_threads(4);
+    tp_assert_integer_equal(dsp::dct2(mat, coef, DCT_NORMAL_ORTHO),
+                            NUMDL_EOK);
+    tp_assert_integer_equal(dsp::dct2(mat, DCT_NORMAL_ORTHO), NUMDL_EOK);
+    dsp::set_num_threads(1);
+
+    dct_plan_t* plan = dct::plan_create(n, DCT_NORMAL_ORTHO);
+    tp_assert_true(dct::dct2_scratch_size(plan) <= sizeof(scratch));
+
+    os_bool_t full_check = OS_TRUE;
+    os_bool_t coef_check = OS_TRUE;
+    for (os_size_t r = 0; r < rows; r++) {
+        memcpy(row, ref->data + r * n, n * sizeof(float));
+        dct::dct2(plan, row, expect, scratch);
+        if (!test_close(mat->data + r * n, expect, n)) {
+            full_check = OS_FALSE;
+        }
+        if (!test_close(coef->data + r * 13, expect, 13)) {
+            coef_check = OS_FALSE;
+        }
+    }
+    tp_assert_true(full_check);
+    tp_assert_true(coef_check);
+
+    /* 5 row groups on 4 threads, the last task gets no rows */
+    uai_mat_t* wide = uai_mat_create(5 * NUMDL_DCT_ROWS, 512);
+    uai_mat_t* wide_ref = uai_mat_create(5 * NUMDL_DCT_ROWS, 512);
+    for (os_size_t i = 0; i < 5 * NUMDL_DCT_ROWS * 512; i++) {
+        wide->data[i] = (float)((i * 11) % 23) / 23.0f - 0.5f;
+    }
+    memcpy(wide_ref->data,
+           wide->data,
+           5 * NUMDL_DCT_ROWS * 512 * sizeof(float));
+    tp_assert_integer_equal(dsp::dct2(wide_ref, DCT_NORMAL_ORTHO), NUMDL_EOK);
+    dsp::set_num_threads(4);
+    tp_assert_integer_equal(dsp::dct2(wide, DCT_NORMAL_ORTHO), NUMDL_EOK);
+    dsp::set_num_threads(1);
+    tp_assert_true(
+        test_close(wide->data, wide_ref->data, 5 * NUMDL_DCT_ROWS * 512));
+
+    uai_mat_destroy(wide_ref);
+    uai_mat_destroy(wide);
+    dct::plan_destroy(plan);
+    uai_mat_destroy(coef);
+    uai_mat_destroy(ref);
+    uai_mat_destroy(mat);
+}
+
+/* scipy.fft.dct of one row in double */
+static void test_dct_reference(dct_type_t type,
+                               dct_norm_t norm,
+                               const float* src,
+                               os_size_t n,
+                               float* out)
+{
+    bool ortho = (DCT_NORMAL_ORTHO == norm);
+
+    for (os_size_t k = 0; k < n; k++) {
+        double sum = 0.0;
+        for (os_size_t i = 0; i < n; i++) {
+            if (DCT_TYPE_III == type) {
+                double c = (0 == i) ? 1.0 : 2.0;
+                if (ortho) {
+                    c = (0 == i) ? sqrt(1.0 / n) : sqrt(2.0 / n);
+                }
+                sum += c * src[i] * cos(M_PI * i * (2 * k + 1) / (2.0 * n));
+            } else {
+                double a = M_PI * (2 * i + 1) * (2 * k + 1) / (4.0 * n);
+                sum += src[i] * cos(a);
+            }
+        }
+        if (DCT_TYPE_IV == type) {
+            sum *= ortho ? sqrt(2.0 / n) : 2.0;
+        }
+        out[k] = (float)sum;
+    }
+}
+
+static void test_dct_types(void)
+{
+    const os_size_t sizes[] = {8, 13, 16, 40};
+    const dct_type_t types[] = {DCT_TYPE_III, DCT_TYPE_IV};
+    const dct_method_t methods[] = {DCT_METHOD_FFT, DCT_METHOD_DIRECT};
+    float src[40];
+    float out[40];
+    float expect[40];
+
+    for (os_size_t i = 0; i < 40; i++) {
+        src[i] = (float)((i * 5) % 17) / 17.0f - 0.5f;
+    }
+
+    for (os_size_t s = 0; s < 4; s++) {
+        os_size_t n = sizes[s];
+        for (os_size_t t = 0; t < 2; t++) {
+            for (int norm = DCT_NORMAL_NONE; norm <= DCT_NORMAL_ORTHO;
+                 norm++) {
+                test_dct_reference(types[t], (dct_norm_t)norm, src, n, expect);
+
+                for (os_size_t m = 0; m < 2; m++) {
+                    dct_plan_t* plan = dct::plan_create(
+                        types[t], n, n, (dct_norm_t)norm, methods[m]);
+
+                    /* An odd DCT-IV has the basis only */
+                    if (DCT_TYPE_IV == types[t] && n % 2 != 0 &&
+                        DCT_METHOD_FFT == methods[m]) {
+                        tp_assert_true(OS_NULL == plan);
+                        continue;
+                    }
+                    tp_assert_true(plan != OS_NULL);
+                    tp_assert_integer_equal(dct::plan_type(plan), types[t]);
+
+                    void* scratch =
+                        uai_mat_aligned_alloc(dct::scratch_size(plan));
+                    int ret = dct::transform(plan, src, 1, out, 1, scratch);
+                    tp_assert_integer_equal(ret, NUMDL_EOK);
+                    tp_assert_true(test_close(out, expect, n));
+
+                    uai_mat_aligned_free(scratch);
+                    dct::plan_destroy(plan);
+                }
+            }
+        }
+    }
+}
+
+static void test_dct_axis_inverse(void)
+{
+    const dct_type_t types[] = {DCT_TYPE_II, DCT_TYPE_III, DCT_TYPE_IV};
+    const os_size_t rows = 16;
+    const os_size_t cols = 6;
+
+    uai_mat_t* mat = uai_mat_create(rows, cols);
+    uai_mat_t* trans = uai_mat_create(cols, rows);
+    uai_mat_t* out = uai_mat_create(rows, cols);
+    uai_mat_t* out_t = uai_mat_create(cols, rows);
+    uai_mat_t* back = uai_mat_create(rows, cols);
+    for (os_size_t i = 0; i < rows; i++) {
+        for (os_size_t j = 0; j < cols; j++) {
+            mat->data[i * cols + j] = (float)((i * 7 + j * 3) % 11) - 5.0f;
+            trans->data[j * rows + i] = mat->data[i * cols + j];
+        }
+    }
+
+    for (os_size_t t = 0; t < 3; t++) {
+        for (int norm = DCT_NORMAL_NONE; norm <= DCT_NORMAL_ORTHO; norm++) {
+            dct_norm_t nm = (dct_norm_t)norm;
+
+            /* Columns through the strides equal rows of the transpose */
+            tp_assert_integer_equal(dsp::dct(mat, out, types[t], nm, 0),
+                                    NUMDL_EOK);
+            tp_assert_integer_equal(
+                dsp::dct(trans, out_t, types[t], nm, -1), NUMDL_EOK);
+
+            os_bool_t axis_check = OS_TRUE;
+            for (os_size_t i = 0; i < rows; i++) {
+                for (os_size_t j = 0; j < cols; j++) {
+                    float diff =
+                        out->data[i * cols + j] - out_t->data[j * rows + i];
+                    if (diff < -REL_ERROR || diff > REL_ERROR) {
+                        axis_check = OS_FALSE;
+                    }
+                }
+            }
+            tp_assert_true(axis_check);
+
+            /* And back */
+            tp_assert_integer_equal(dsp::idct(out, back, types[t], nm, 0),
+                                    NUMDL_EOK);
+            tp_assert_true(test_close(back->data, mat->data, rows * cols));
+        }
+    }
+
+    /* Truncation is for the forward transform only */
+    uai_mat_t* half = uai_mat_create(rows / 2, cols);
+    tp_assert_integer_equal(
+        dsp::dct(mat, half, DCT_TYPE_IV, DCT_NORMAL_ORTHO, 0), NUMDL_EOK);
+    tp_assert_integer_equal(
+        dsp::idct(mat, half, DCT_TYPE_IV, DCT_NORMAL_ORTHO, 0), NUMDL_EINVAL);
+    tp_assert_integer_equal(
+        dsp::dct(mat, out, DCT_TYPE_II, DCT_NORMAL_ORTHO, 2), NUMDL_EINVAL);
+
+    uai_mat_destroy(half);
+    uai_mat_destroy(back);
+    uai_mat_destroy(out_t);
+    uai_mat_destroy(out);
+    uai_mat_destroy(trans);
+    uai_mat_destroy(mat);
+}
+
+static void test_dct_block(void)
+{
+    const os_size_t sizes[] = {4, 8, 16};
+
+    for (os_size_t z = 0; z < 3; z++) {
+        os_size_t size = sizes[z];
+        os_size_t rows = 2 * size;
+        os_size_t cols = 3 * size;
+
+        uai_mat_t* img = uai_mat_create(rows, cols);
+        uai_mat_t* coef = uai_mat_create(rows, cols);
+        uai_mat_t* blk = uai_mat_create(size, size);
+        uai_mat_t* tmp = uai_mat_create(size, size);
+        uai_mat_t* ref = uai_mat_create(size, size);
+        for (os_size_t i = 0; i < rows * cols; i++) {
+            img->data[i] = (float)((i * 7 + i / cols * 3) % 11) / 10.0f - 0.5f;
+        }
+
+        for (int norm = DCT_NORMAL_NONE; norm <= DCT_NORMAL_ORTHO; norm++) {
+            dct_norm_t nm = (dct_norm_t)norm;
+            /* Unscaled coefficients grow with the block, so does their error */
+            float tol = (DCT_NORMAL_ORTHO == nm) ? 1.0f : 4.0f * size;
+
+            tp_assert_integer_equal(
+                dct_block::forward_image(img, coef, size, nm), NUMDL_EOK);
+
+            /* Every block equals the 1D DCT-II along both axes */
+            os_bool_t block_check = OS_TRUE;
+            for (os_size_t br = 0; br < rows; br += size) {
+                for (os_size_t bc = 0; bc < cols; bc += size) {
+                    for (os_size_t i = 0; i < size; i++) {
+                        memcpy(blk->data + i * size,
+                               img->data + (br + i) * cols + bc,
+                               size * sizeof(float));
+                    }
+                    dsp::dct(blk, tmp, DCT_TYPE_II, nm, 1);
+                    dsp::dct(tmp, ref, DCT_TYPE_II, nm, 0);
+
+                    for (os_size_t i = 0; i < size; i++) {
+                        if (!test_close_scaled(
+                                coef->data + (br + i) * cols + bc,
+                                ref->data + i * size,
+                                size,
+                                tol)) {
+                            block_check = OS_FALSE;
+                        }
+                    }
+                }
+            }
+            tp_assert_true(block_check);
+
+            /* One block through the strided API */
+            tp_assert_integer_equal(
+                dct_block::forward(size,
+                                   img->data + size * cols + size,
+                                   cols,
+                                   tmp->data,
+                                   size,
+                                   nm),
+                NUMDL_EOK);
+            tp_assert_true(test_close_scaled(
+                tmp->data, coef->data + size * cols + size, size, tol));
+
+            /* And back, in place */
+            tp_assert_integer_equal(
+                dct_block::inverse_image(coef, coef, size, nm), NUMDL_EOK);
+            tp_assert_true(test_close(coef->data, img->data, rows * cols));
+        }
+
+        uai_mat_destroy(ref);
+        uai_mat_destroy(tmp);
+        uai_mat_destroy(blk);
+        uai_mat_destroy(coef);
+        uai_mat_destroy(img);
+    }
+
+    /* Rows of blocks split across threads give the same coefficients */
+    uai_mat_t* big = uai_mat_create(128, 128);
+    uai_mat_t* one = uai_mat_create(128, 128);
+    uai_mat_t* many = uai_mat_create(128, 128);
+    for (os_size_t i = 0; i < 128 * 128; i++) {
+        big->data[i] = (float)((i * 13) % 17) / 16.0f - 0.5f;
+    }
+    tp_assert_integer_equal(
+        dct_block::forward_image(big, one, 8, DCT_NORMAL_ORTHO), NUMDL_EOK);
+    dsp::set_num_threads(4);
+    tp_assert_integer_equal(
+        dct_block::forward_image(big, many, 8, DCT_NORMAL_ORTHO), NUMDL_EOK);
+    dsp::set_num_threads(1);
+    tp_assert_true(test_close(many->data, one->data, 128 * 128));
+    uai_mat_destroy(many);
+    uai_mat_destroy(one);
+    uai_mat_destroy(big);
+
+    /* Only 4, 8 and 16, and the blocks must tile the image */
+    uai_mat_t* img = uai_mat_create(12, 16);
+    tp_assert_integer_equal(
+        dct_block::forward_image(img, img, 6, DCT_NORMAL_ORTHO), NUMDL_EINVAL);
+    tp_assert_integer_equal(
+        dct_block::forward_image(img, img, 8, DCT_NORMAL_ORTHO), NUMDL_EINVAL);
+    tp_assert_integer_equal(
+        dct_block::inverse_image(img, img, 4, DCT_NORMAL_ORTHO), NUMDL_EOK);
+    uai_mat_destroy(img);
+}
+
+static void test_dct2_view_function(void)
+{
+    /* DCT along the columns of a 8x4 matrix equals DCT of its transpose */
+    uai_mat_t* mat = uai_mat_create(8, 4);
+    uai_mat_t* trans = uai_mat_create(4, 8);
+    for (os_size_t i = 0; i < 8; i++) {
+        for (os_size_t j = 0; j < 4; j++) {
+            mat->data[i * 4 + j] = (float)((i * 3 + j * 5) % 7) - 3.0f;
+            trans->data[j * 8 + i] = mat->data[i * 4 + j];
+        }
+    }
+
+    uai_mat_view_t view;
+    uai_mat_view_init(&view, mat);
+    uai_mat_view_transpose(&view, &view);
+
+    tp_assert_integer_equal(dsp::dct2(&view, DCT_NORMAL_ORTHO), NUMDL_EOK);
+    tp_assert_integer_equal(dsp::dct2(trans, DCT_NORMAL_ORTHO), NUMDL_EOK);
+
+    os_bool_t dct_check = OS_TRUE;
+    for (os_size_t i = 0; i < 8; i++) {
+        for (os_size_t j = 0; j < 4; j++) {
+            float diff = mat->data[i * 4 + j] - trans->data[j * 8 + i];
+            if (diff < -REL_ERROR || diff > REL_ERROR) {
+                dct_check = OS_FALSE;
+            }
+        }
+    }
+    tp_assert_true(dct_check);
+
+    uai_mat_destroy(mat);
+    uai_mat_destroy(trans);
+}
+
+static void test_ndarray_expression(void)
+{
+    nd::NdArray<float> a = {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}};
+    nd::NdArray<float> b = {{2.0f, 2.0f, 2.0f}, {0.5f, 0.5f, 0.5f}};
+    nd::NdArray<float> c(2, 3);
+    c.fill(1.0f);
+
+    /* One fused pass, no temporary arrays */
+    nd::NdArray<float> out = nd::log(a * b + c);
+
+    os_bool_t expr_check = OS_TRUE;
+    for (os_size_t i = 0; i < 2; i++) {
+        for (os_size_t j = 0; j < 3; j++) {
+            float expect = logf(a(i, j) * b(i, j) + 1.0f);
+            if (out(i, j) < expect - REL_ERROR ||
+                out(i, j) > expect + REL_ERROR) {
+                expr_check = OS_FALSE;
+            }
+        }
+    }
+    tp_assert_true(expr_check);
+
+    /* Strided operands fall back to the 2D loop */
+    nd::NdArray<float> t(3, 2);
+    t = a.transpose() * 2.0f - 1.0f;
+    tp_assert_integer_equal((int)t.rows(), 3);
+    tp_assert_true(t(2, 1) > 11.0f - REL_ERROR && t(2, 1) < 11.0f + REL_ERROR);
+
+    /* Writes go through borrowed views */
+    float data[6] = {0};
+    nd::NdArray<float> view(data, 3, 2, 1, 3);
+    view = a.transpose();
+    tp_assert_true(0 == memcmp(data, a.data(), sizeof(data)));
+
+    a += nd::square(b);
+    tp_assert_true(a(1, 2) > 6.25f - REL_ERROR && a(1, 2) < 6.25f + REL_ERROR);
+
+    /* Moving a view in copies it, the target keeps its own buffer */
+    nd::NdArray<float> x(3, 2);
+    x = a.transpose();
+    tp_assert_true(x.ownsData() && x.data() != a.data());
+    x(0, 0) = 100.0f;
+    tp_assert_true(a(0, 0) < 100.0f);
+
+    /* Self transpose, square and not */
+    nd::NdArray<float> sq = {{1.0f, 2.0f}, {3.0f, 4.0f}};
+    sq = sq.transpose();
+    tp_assert_true(1.0f == sq(0, 0) && 3.0f == sq(0, 1) && 2.0f == sq(1, 0) &&
+                   4.0f == sq(1, 1));
+    a = a.transpose();
+    tp_assert_integer_equal((int)a.rows(), 3);
+    tp_assert_true(a.ownsData() && 6.25f == a(2, 1));
+
+    /* Reading the destination through another stride goes via a temporary */
+    nd::NdArray<float> m = {{1.0f, 2.0f}, {3.0f, 4.0f}};
+    m = m + m.transpose();
+    tp_assert_true(2.0f == m(0, 0) && 5.0f == m(0, 1) && 5.0f == m(1, 0) &&
+                   8.0f == m(1, 1));
+    nd::NdArray<float> n = {{1.0f, 2.0f}, {3.0f, 4.0f}};
+    n += n.transpose();
+    tp_assert_true(5.0f == n(0, 1) && 5.0f == n(1, 0));
+}
+
 static void test_linspace_float(void)
 {
     float start_f = 0.0;
@@ -322,6 +2008,33 @@ static void test_rfft_function(void)
 static void test_case(void)
 {
     ATEST_UNIT_RUN(test_sum);
+    ATEST_UNIT_RUN(test_mat_dot_blocked);
+    ATEST_UNIT_RUN(test_mat_dot_threads);
+    ATEST_UNIT_RUN(test_mat_dot_epilogue);
+    ATEST_UNIT_RUN(test_mat_gemv);
+    ATEST_UNIT_RUN(test_mat_dot_trans);
+    ATEST_UNIT_RUN(test_mat_sparse);
+    ATEST_UNIT_RUN(test_qgemm);
+    ATEST_UNIT_RUN(test_fft_plan);
+    ATEST_UNIT_RUN(test_rfft_scratch);
+    ATEST_UNIT_RUN(test_rfft_batch);
+    ATEST_UNIT_RUN(test_rfft_rows);
+    ATEST_UNIT_RUN(test_rfft_modes);
+    ATEST_UNIT_RUN(test_irfft_ola);
+    ATEST_UNIT_RUN(test_fft_backend);
+    ATEST_UNIT_RUN(test_rfft_q31);
+    ATEST_UNIT_RUN(test_rfft_four_step);
+    ATEST_UNIT_RUN(test_nd_rfft);
+    ATEST_UNIT_RUN(test_mat_dot_view);
+    ATEST_UNIT_RUN(test_log_view_function);
+    ATEST_UNIT_RUN(test_dct2_plan);
+    ATEST_UNIT_RUN(test_dct2_truncated);
+    ATEST_UNIT_RUN(test_dct2_rows_parallel);
+    ATEST_UNIT_RUN(test_dct_types);
+    ATEST_UNIT_RUN(test_dct_axis_inverse);
+    ATEST_UNIT_RUN(test_dct_block);
+    ATEST_UNIT_RUN(test_dct2_view_function);
+    ATEST_UNIT_RUN(test_ndarray_expression);
 #if 0
     ATEST_UNIT_RUN(test_mat_dot);
     ATEST_UNIT_RUN(test_int16_to_float);